@@ -0,0 +1,171 @@
+#include "PowerFlowGraph.h"
+#include "../core/PinTables.h"
+#include <QtCore/QHash>
+
+namespace LadderDiagram {
+
+namespace {
+
+// 并查集（路径减半）
+int findRoot(QVector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+void unite(QVector<int>& parent, int a, int b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a != b) {
+        parent[qMax(a, b)] = qMin(a, b);
+    }
+}
+
+} // namespace
+
+int PowerFlowGraph::pinCount(ElementType type) {
+    return int(PinTables::pins(type).size());
+}
+
+bool PowerFlowGraph::isOutputPin(ElementType type, int pin) {
+    const auto pins = PinTables::pins(type);
+    if (pin < 0 || pin >= int(pins.size())) return false;
+    return pins[pin].type == ConnectionType::PowerOut || pins[pin].type == ConnectionType::Output;
+}
+
+void PowerFlowGraph::build(const QList<ElementData>& elements, const QList<ConnectionData>& connections) {
+    const int count = elements.size();
+    m_types.resize(count);
+    m_pinOffset.resize(count + 1);
+
+    QHash<QString, int> indexById;
+    indexById.reserve(count);
+
+    int slots = 0;
+    for (int i = 0; i < count; ++i) {
+        m_types[i] = elements[i].type;
+        m_pinOffset[i] = slots;
+        slots += pinCount(m_types[i]);
+        indexById.insert(elements[i].id, i);
+    }
+    m_pinOffset[count] = slots;
+
+    // 额外两个虚拟槽位：电源节点与汇点节点
+    const int sourceSlot = slots;
+    const int sinkSlot = slots + 1;
+    QVector<int> parent(slots + 2);
+    for (int i = 0; i < parent.size(); ++i) {
+        parent[i] = i;
+    }
+    QVector<bool> wired(slots, false);
+
+    auto slotOf = [&](const QString& id, int pin) {
+        auto it = indexById.constFind(id);
+        if (it == indexById.constEnd()) return -1;
+        int element = it.value();
+        if (pin < 0 || pin >= pinCount(m_types[element])) return -1;
+        return m_pinOffset[element] + pin;
+    };
+
+    for (const ConnectionData& conn : connections) {
+        int a = slotOf(conn.startElement, conn.startPin);
+        int b = slotOf(conn.endElement, conn.endPin);
+        if (a < 0 || b < 0) continue;
+        wired[a] = true;
+        wired[b] = true;
+        unite(parent, a, b);
+    }
+
+    // 电源轨的所有引脚各自合并
+    for (int i = 0; i < count; ++i) {
+        int railSlot = -1;
+        if (m_types[i] == ElementType::LeftPowerRail) railSlot = sourceSlot;
+        else if (m_types[i] == ElementType::RightPowerRail) railSlot = sinkSlot;
+        if (railSlot < 0) continue;
+
+        for (int s = m_pinOffset[i]; s < m_pinOffset[i + 1]; ++s) {
+            if (wired[s]) unite(parent, s, railSlot);
+        }
+    }
+
+    // 为已接线的引脚分配节点编号（按元件顺序，保证结果确定）
+    QVector<int> rootNet(slots + 2, NoNet);
+    m_pinNets.fill(NoNet, slots);
+    m_netCount = 0;
+    for (int s = 0; s < slots; ++s) {
+        if (!wired[s]) continue;
+        int root = findRoot(parent, s);
+        if (rootNet[root] == NoNet) {
+            rootNet[root] = m_netCount++;
+        }
+        m_pinNets[s] = rootNet[root];
+    }
+
+    m_sourceNet = rootNet[findRoot(parent, sourceSlot)];
+    m_sinkNet = rootNet[findRoot(parent, sinkSlot)];
+}
+
+int PowerFlowGraph::pinNet(int element, int pin) const {
+    if (element < 0 || element >= m_types.size()) return NoNet;
+    int slot = m_pinOffset[element] + pin;
+    if (pin < 0 || slot >= m_pinOffset[element + 1]) return NoNet;
+    return m_pinNets[slot];
+}
+
+QVector<int> PowerFlowGraph::schedule() const {
+    const int count = m_types.size();
+    QVector<int> writers(m_netCount, 0);
+    QVector<QVector<int>> readers(m_netCount);
+    QVector<int> waiting(count, 0);
+
+    for (int e = 0; e < count; ++e) {
+        const ElementType type = m_types[e];
+        if (type == ElementType::LeftPowerRail || type == ElementType::RightPowerRail) continue;
+        for (int pin = 0; pin < pinCount(type); ++pin) {
+            int net = pinNet(e, pin);
+            if (net == NoNet) continue;
+            if (isOutputPin(type, pin)) {
+                writers[net]++;
+            } else if (!readers[net].contains(e)) {
+                readers[net].append(e);
+            }
+        }
+    }
+    for (int net = 0; net < m_netCount; ++net) {
+        if (writers[net] == 0) continue;
+        for (int e : readers[net]) waiting[e]++;
+    }
+
+    QVector<int> order;
+    order.reserve(count);
+    QVector<bool> scheduled(count, false);
+    QVector<int> ready;
+    for (int e = count - 1; e >= 0; --e) {
+        if (waiting[e] == 0) ready.append(e);
+    }
+    while (!ready.isEmpty()) {
+        int e = ready.takeLast();
+        scheduled[e] = true;
+        order.append(e);
+
+        const ElementType type = m_types[e];
+        if (type == ElementType::LeftPowerRail || type == ElementType::RightPowerRail) continue;
+        for (int pin = 0; pin < pinCount(type); ++pin) {
+            int net = pinNet(e, pin);
+            if (net == NoNet || !isOutputPin(type, pin)) continue;
+            if (--writers[net] != 0) continue;
+            for (int reader : readers[net]) {
+                if (--waiting[reader] == 0) ready.append(reader);
+            }
+        }
+    }
+
+    for (int e = 0; e < count; ++e) {
+        if (!scheduled[e]) order.append(e);
+    }
+    return order;
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include "../core/ElementTypes.h"
+#include "../core/LadderModel.h"
+
+namespace LadderDiagram {
+
+// 能流图 - 把元件引脚按连接线合并为节点(net)
+//
+// 元件引脚通过连接线相连后属于同一个节点；左电源轨的全部引脚合并为
+// 电源节点（恒为TRUE），右电源轨的全部引脚合并为汇点节点。
+// 未接线的引脚不分配节点（pinNet 返回 NoNet）。
+class PowerFlowGraph {
+public:
+    static constexpr int NoNet = -1;
+
+    // 由网络元件与连接线构建（连接线两端按元件ID查找）
+    void build(const QList<ElementData>& elements, const QList<ConnectionData>& connections);
+
+    int elementCount() const { return m_types.size(); }
+    int netCount() const { return m_netCount; }
+
+    // 左电源轨节点（无左电源轨时为 NoNet）
+    int sourceNet() const { return m_sourceNet; }
+
+    // 右电源轨节点（无右电源轨时为 NoNet）
+    int sinkNet() const { return m_sinkNet; }
+
+    ElementType elementType(int element) const { return m_types[element]; }
+
+    // 元件引脚所在节点
+    int pinNet(int element, int pin) const;
+
+    // 元件执行顺序：元件在其全部输入节点的写入者之后执行；
+    // 环上的元件按编号追加在末尾
+    QVector<int> schedule() const;
+
+    // 元件引脚数（取自 PinTables 引脚表）
+    static int pinCount(ElementType type);
+
+    // 引脚是否为输出引脚（能流由元件流出）
+    static bool isOutputPin(ElementType type, int pin);
+
+private:
+    QVector<ElementType> m_types;
+    QVector<int> m_pinOffset;       // 元件 -> 第一个引脚槽位
+    QVector<int> m_pinNets;         // 引脚槽位 -> 节点
+    int m_netCount = 0;
+    int m_sourceNet = NoNet;
+    int m_sinkNet = NoNet;
+};
+
+} // namespace LadderDiagram
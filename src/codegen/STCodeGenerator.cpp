@@ -1,13 +1,241 @@
 #include "STCodeGenerator.h"
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QBuffer>
 #include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
 #include <QTextStream>
 #include <QDateTime>
+#include <QHash>
+#include <QPointF>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include "SymbolTable.h"
 
 namespace LadderDiagram {
 
+// 表达式优先级：用于决定组合时是否加括号
+enum Precedence {
+    PrecOr = 0,
+    PrecAnd = 1,
+    PrecPrimary = 2
+};
+
+// 带优先级的表达式文本，组合时据此加括号，不必再解析已生成的文本
+struct Expr {
+    QString text;
+    int prec = PrecPrimary;
+
+    bool isTrue() const { return text == QLatin1String("TRUE"); }
+    bool isFalse() const { return text == QLatin1String("FALSE"); }
+};
+
+namespace {
+
+Expr atom(const QString& text) {
+    return Expr{text, PrecPrimary};
+}
+
+QString wrap(const Expr& e, int prec) {
+    return e.prec < prec ? "(" + e.text + ")" : e.text;
+}
+
+Expr andExpr(const Expr& a, const Expr& b) {
+    if (a.isTrue()) return b;
+    if (b.isTrue()) return a;
+    if (a.isFalse() || b.isFalse()) return atom("FALSE");
+    return Expr{wrap(a, PrecAnd) + " AND " + wrap(b, PrecAnd), PrecAnd};
+}
+
+Expr orExpr(const Expr& a, const Expr& b) {
+    if (a.isFalse()) return b;
+    if (b.isFalse()) return a;
+    if (a.isTrue() || b.isTrue()) return atom("TRUE");
+    return Expr{a.text + " OR " + b.text, PrecOr};
+}
+
+Expr notExpr(const Expr& a) {
+    if (a.isTrue()) return atom("FALSE");
+    if (a.isFalse()) return atom("TRUE");
+    return atom("NOT " + wrap(a, PrecPrimary));
+}
+
+bool isIdentifier(const QString& text) {
+    if (text.isEmpty()) return false;
+    const QChar first = text.at(0);
+    if (!(first.isLetter() || first == '_')) return false;
+    QChar prev;
+    for (const QChar c : text) {
+        if (c.unicode() > 127 || !(c.isLetterOrNumber() || c == '_')) return false;
+        if (c == '_' && prev == '_') return false;
+        prev = c;
+    }
+    return true;
+}
+
+// 变量引用是否需要声明（直接地址和字面量不需要）
+bool needsDeclaration(const QString& operand) {
+    return isIdentifier(operand);
+}
+
+// 是否为实数字面量（含小数点或指数）
+bool isRealLiteral(const QString& operand) {
+    if (!operand.contains('.') && !operand.contains('E', Qt::CaseInsensitive)) return false;
+    bool ok = false;
+    operand.toDouble(&ok);
+    return ok;
+}
+
+// 运算操作数的类型：与实数常量一起运算时推断为 REAL，否则为 INT
+QString numericType(std::initializer_list<QString> operands) {
+    for (const QString& operand : operands) {
+        if (isRealLiteral(operand)) return "REAL";
+    }
+    return "INT";
+}
+
+QString timerTypeName(const ElementData& element) {
+    switch (element.type) {
+        case ElementType::TimerTOF: return "TOF";
+        case ElementType::TimerTP: return "TP";
+        default: break;
+    }
+    switch (element.parameter("timer_type").toInt()) {
+        case 1: return "TOF";
+        case 2: return "TP";
+        default: return "TON";
+    }
+}
+
+QString counterTypeName(const ElementData& element) {
+    switch (element.type) {
+        case ElementType::CounterCTD: return "CTD";
+        case ElementType::CounterCTUD: return "CTUD";
+        default: break;
+    }
+    switch (element.parameter("counter_type").toInt()) {
+        case 1: return "CTD";
+        case 2: return "CTUD";
+        default: return "CTU";
+    }
+}
+
+QString compareOperator(int op) {
+    switch (op) {
+        case 1: return "<>";
+        case 2: return ">";
+        case 3: return ">=";
+        case 4: return "<";
+        case 5: return "<=";
+        default: return "=";
+    }
+}
+
+QString mathOperator(int op) {
+    switch (op) {
+        case 1: return "-";
+        case 2: return "*";
+        case 3: return "/";
+        default: return "+";
+    }
+}
+
+} // namespace
+
+// 串并联归约用的节点图
+struct ReductionGraph {
+    struct Edge {
+        int from;
+        int to;
+        Expr label;
+        bool alive = true;
+    };
+
+    struct Net {
+        QVector<int> in;        // 存活入边
+        QVector<int> out;       // 存活出边
+        QVector<int> blocks;    // 输出到该节点的功能块/逻辑门元件
+        int readers = 0;        // 读取该节点能流的元件引脚数
+    };
+
+    QVector<Edge> edges;
+    QVector<Net> nets;
+    QHash<quint64, int> edgeIndex;     // (from, to) -> 存活边
+    QVector<int> actions;              // 产生语句的元件（线圈、功能块调用、跳转...）
+    int source = PowerFlowGraph::NoNet;
+    int sink = PowerFlowGraph::NoNet;
+
+    static quint64 key(int from, int to) {
+        return (quint64(quint32(from)) << 32) | quint32(to);
+    }
+
+    // 添加边；若已存在同端点的边则并联合并，返回 true
+    bool addEdge(int from, int to, const Expr& label) {
+        auto it = edgeIndex.constFind(key(from, to));
+        if (it != edgeIndex.constEnd()) {
+            Edge& existing = edges[it.value()];
+            existing.label = orExpr(existing.label, label);
+            return true;
+        }
+        int index = edges.size();
+        edges.append(Edge{from, to, label, true});
+        edgeIndex.insert(key(from, to), index);
+        nets[from].out.append(index);
+        nets[to].in.append(index);
+        return false;
+    }
+
+    void removeEdge(int index) {
+        Edge& e = edges[index];
+        e.alive = false;
+        nets[e.from].out.removeOne(index);
+        nets[e.to].in.removeOne(index);
+        auto it = edgeIndex.find(key(e.from, e.to));
+        if (it != edgeIndex.end() && it.value() == index) {
+            edgeIndex.erase(it);
+        }
+    }
+};
+
+// 网络编号占位符：缓存的编译结果与网络位置无关，临时变量名、边沿实例名
+// 和网络注释中的编号在拼接时才由 bindNetwork 替换为实际编号
+constexpr QChar NetworkIdMarker(0xE000);
+
+// 单个网络的编译上下文
+struct CompileContext {
+    QStringList preStatements;          // 边沿检测辅助实例调用，置于网络开头
+    QMap<QString, QString> symbols;     // 变量 -> 类型
+    QSet<QString> written;              // 被赋值的变量
+    QVector<QString> instances;         // 元件 -> 功能块实例名
+    int edgeCounter = 0;
+    int tempCounter = 0;
+
+    void declare(const QString& name, const QString& type) {
+        if (needsDeclaration(name) && !symbols.contains(name)) {
+            symbols.insert(name, type);
+        }
+    }
+
+    // 登记被赋值的变量
+    void assign(const QString& name, const QString& type) {
+        declare(name, type);
+        if (symbols.contains(name)) written.insert(name);
+    }
+
+    QString newTemp() {
+        QString name = QString("_N%1_T%2").arg(NetworkIdMarker).arg(++tempCounter);
+        symbols.insert(name, "BOOL");
+        return name;
+    }
+
+    QString newEdgeInstance(const QString& type) {
+        QString name = QString("_N%1_E%2").arg(NetworkIdMarker).arg(++edgeCounter);
+        symbols.insert(name, type);
+        return name;
+    }
+};
+
 STCodeGenerator::STCodeGenerator()
     : m_programName("MainProgram")
     , m_programDescription("Generated from Ladder Diagram")
@@ -26,100 +254,1031 @@ void STCodeGenerator::addNetwork(const LadderNetwork& network) {
     m_networks.append(network);
 }
 
+void STCodeGenerator::clearNetworks() {
+    m_networks.clear();
+}
+
+bool STCodeGenerator::loadFromJson(const QString& jsonData, QString* errorString) {
+    QByteArray bytes = jsonData.toUtf8();
+    QBuffer buffer(&bytes);
+    if (!buffer.open(QIODevice::ReadOnly)) {
+        if (errorString) *errorString = buffer.errorString();
+        return false;
+    }
+
+    LadderModel model;
+    if (!model.readJson(&buffer, errorString)) {
+        return false;
+    }
+    loadModel(model);
+    return true;
+}
+
+bool STCodeGenerator::loadFromJsonFile(const QString& filePath, QString* errorString) {
+    // 逐条解析，不把整个文件读成文本再建 DOM
+    LadderModel model;
+    if (!model.readJsonFile(filePath, errorString)) {
+        return false;
+    }
+    loadModel(model);
+    return true;
+}
+
+void STCodeGenerator::loadModel(const LadderModel& model) {
+    m_networks = splitNetworks(model.elements, model.connections);
+}
+
+QString STCodeGenerator::programNameForFile(const QString& filePath) {
+    QString programName = QFileInfo(filePath).completeBaseName();
+    programName.replace(QRegularExpression("[^A-Za-z0-9_]"), "_");
+    if (programName.isEmpty() || programName.at(0).isDigit()) {
+        return QString();
+    }
+    return programName;
+}
+
+QList<LadderNetwork> STCodeGenerator::splitNetworks(const QList<ElementData>& elements,
+                                                    const QList<ConnectionData>& connections) {
+    const int count = elements.size();
+
+    QHash<QString, int> indexById;
+    indexById.reserve(count);
+    QVector<bool> isRail(count);
+    for (int i = 0; i < count; ++i) {
+        indexById.insert(elements[i].id, i);
+        const ElementType type = elements[i].type;
+        isRail[i] = type == ElementType::LeftPowerRail || type == ElementType::RightPowerRail;
+    }
+
+    // 并查集：电源轨不参与合并，否则所有行都会连成一个网络
+    QVector<int> parent(count);
+    for (int i = 0; i < count; ++i) parent[i] = i;
+    auto find = [&parent](int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+
+    QVector<bool> touched(count, false);
+    QVector<QPair<int, int>> endpoints;
+    endpoints.reserve(connections.size());
+    for (const auto& conn : connections) {
+        int a = indexById.value(conn.startElement, -1);
+        int b = indexById.value(conn.endElement, -1);
+        endpoints.append(qMakePair(a, b));
+        if (a >= 0) touched[a] = true;
+        if (b >= 0) touched[b] = true;
+        if (a >= 0 && b >= 0 && !isRail[a] && !isRail[b]) {
+            int ra = find(a);
+            int rb = find(b);
+            if (ra != rb) parent[qMax(ra, rb)] = qMin(ra, rb);
+        }
+    }
+
+    struct Group {
+        QVector<int> members;
+        QVector<int> rails;
+        QVector<int> connections;
+        qreal top = 0;
+        qreal left = 0;
+    };
+    QVector<Group> groups;
+    QHash<int, int> groupOfRoot;
+
+    for (int i = 0; i < count; ++i) {
+        if (isRail[i]) continue;
+        // 未接线的孤立元件不构成网络（标签本身没有连接点）
+        if (!touched[i] && elements[i].type != ElementType::Label) continue;
+
+        int root = find(i);
+        auto it = groupOfRoot.constFind(root);
+        int g = 0;
+        if (it == groupOfRoot.constEnd()) {
+            g = groups.size();
+            groupOfRoot.insert(root, g);
+            groups.append(Group());
+        } else {
+            g = it.value();
+        }
+        groups[g].members.append(i);
+    }
+
+    for (int c = 0; c < endpoints.size(); ++c) {
+        int a = endpoints[c].first;
+        int b = endpoints[c].second;
+        int owner = (a >= 0 && !isRail[a]) ? a : ((b >= 0 && !isRail[b]) ? b : -1);
+        if (owner < 0) continue;
+        auto it = groupOfRoot.constFind(find(owner));
+        if (it == groupOfRoot.constEnd()) continue;
+        Group& group = groups[it.value()];
+        group.connections.append(c);
+        if (a >= 0 && isRail[a] && !group.rails.contains(a)) group.rails.append(a);
+        if (b >= 0 && isRail[b] && !group.rails.contains(b)) group.rails.append(b);
+    }
+
+    // 网络内按 (y, x) 排序，网络之间按最上方元件排序
+    QVector<QPointF> positions(count);
+    for (int i = 0; i < count; ++i) {
+        positions[i] = elements[i].position;
+    }
+    auto byPosition = [&positions](int a, int b) {
+        if (positions[a].y() != positions[b].y()) return positions[a].y() < positions[b].y();
+        if (positions[a].x() != positions[b].x()) return positions[a].x() < positions[b].x();
+        return a < b;
+    };
+    for (Group& group : groups) {
+        std::sort(group.members.begin(), group.members.end(), byPosition);
+        std::sort(group.rails.begin(), group.rails.end());
+        group.top = positions[group.members.first()].y();
+        group.left = positions[group.members.first()].x();
+    }
+    std::stable_sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) {
+        if (a.top != b.top) return a.top < b.top;
+        return a.left < b.left;
+    });
+
+    QList<LadderNetwork> networks;
+    networks.reserve(groups.size());
+    for (const Group& group : groups) {
+        LadderNetwork network;
+        network.id = networks.size() + 1;
+        network.elements.reserve(group.rails.size() + group.members.size());
+        for (int index : group.rails) network.elements.append(elements[index]);
+        for (int index : group.members) network.elements.append(elements[index]);
+        network.connections.reserve(group.connections.size());
+        for (int index : group.connections) network.connections.append(connections[index]);
+        networks.append(network);
+    }
+    return networks;
+}
+
+QString STCodeGenerator::generateHeader() const {
+    QString header;
+    header += "(*\n";
+    header += " * Program: " + m_programName + "\n";
+    header += " * Description: " + m_programDescription + "\n";
+    header += " * Generated from Ladder Diagram\n";
+    header += " * Date: " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") + "\n";
+    header += " *)\n\n";
+    return header;
+}
+
 QString STCodeGenerator::generateSTCode() const {
-    QString code;
-    
-    // 生成文件头注释
-    code += "(*\n";
-    code += " * Program: " + m_programName + "\n";
-    code += " * Description: " + m_programDescription + "\n";
-    code += " * Generated from Ladder Diagram\n";
-    code += " * Date: " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") + "\n";
-    code += " *)\n\n";
-    
-    // 生成变量声明
-    code += generateVariableDeclarations();
-    code += "\n";
-    
-    // 生成每个网络的代码
-    for (const LadderNetwork& network : m_networks) {
-        code += networkToST(network);
-        code += "\n";
-    }
-    
-    return code;
+    return generateBody(compileNetworks());
 }
 
 QString STCodeGenerator::generatePOU() const {
+    const QList<CompiledNetwork> compiled = compileNetworks();
+
+    const QString body = generateBody(compiled);
+
     QString pou;
-    
+    pou.reserve(body.size() + 4096);
+    pou += generateHeader();
+
     // POU头部
     pou += "PROGRAM " + m_programName + "\n";
     pou += "\n";
-    
+
     // 变量声明区
-    pou += "VAR\n";
-    pou += generateVariableDeclarations();
-    pou += "END_VAR\n";
+    pou += generateVariableDeclarations(compiled);
     pou += "\n";
-    
+
     // 代码区
-    pou += generateSTCode();
-    
+    pou += body;
+
     // POU尾部
-    pou += "\n";
     pou += "END_PROGRAM\n";
-    
+
     return pou;
 }
 
+QString STCodeGenerator::generatePreview() const {
+    const QList<CompiledNetwork> compiled = compileNetworks();
+    return generateVariableDeclarations(compiled) + "\n" + generateBody(compiled);
+}
+
 bool STCodeGenerator::saveToFile(const QString& filePath) const {
+    const QString pou = generatePOU();
+    if (hasErrors()) {
+        return false;
+    }
+
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         return false;
     }
-    
+
     QTextStream stream(&file);
     stream.setEncoding(QStringConverter::Utf8);
-    stream << generatePOU();
+    stream << pou;
     file.close();
-    
+
     return true;
 }
 
-QString STCodeGenerator::generateVariableDeclarations() const {
-    QString vars;
-    
-    // 简单起见，生成一些示例变量
-    vars += "    (* Input Variables *)\n";
-    vars += "    StartButton : BOOL;\n";
-    vars += "    StopButton : BOOL;\n";
-    vars += "\n";
-    vars += "    (* Output Variables *)\n";
-    vars += "    Motor : BOOL;\n";
-    vars += "\n";
-    vars += "    (* Internal Variables *)\n";
-    vars += "    TempVar : BOOL;\n";
-    
-    return vars;
-}
-
-QString STCodeGenerator::networkToST(const LadderNetwork& network) const {
+namespace {
+
+// 把与位置无关的编译结果绑定到网络编号
+void bindNetwork(CompiledNetwork& network, int id) {
+    network.id = id;
+    if (!network.code.contains(NetworkIdMarker)) return;
+
+    const QString number = QString::number(id);
+    network.code.replace(NetworkIdMarker, number);
+    network.jumpCondition.replace(NetworkIdMarker, number);
+
+    QMap<QString, QString> symbols;
+    for (auto it = network.symbols.constBegin(); it != network.symbols.constEnd(); ++it) {
+        QString name = it.key();
+        symbols.insert(name.replace(NetworkIdMarker, number), it.value());
+    }
+    network.symbols.swap(symbols);
+}
+
+} // namespace
+
+void STCodeGenerator::clearCache() {
+    m_cache.clear();
+    m_lastRecompiled = 0;
+}
+
+QList<CompiledNetwork> STCodeGenerator::compileNetworks() const {
+    const int count = m_networks.size();
+    QList<CompiledNetwork> compiled(count);
+    CompiledNetwork* results = compiled.data();
+
+    // 只有版本变化过的梯级需要重新编译；网络编号随位置变化，不计入缓存键，
+    // 插入或删除一个梯级不会使其下方的网络失效。没有梯级编号的网络每次都编译
+    QVector<int> dirty;
+    for (int i = 0; i < count; ++i) {
+        const LadderNetwork& network = m_networks[i];
+        auto it = network.rungId ? m_cache.constFind(CacheKey(network.rungId, network.revision))
+                                 : m_cache.constEnd();
+        if (it != m_cache.constEnd()) {
+            results[i] = it.value();
+        } else {
+            dirty.append(i);
+        }
+    }
+    const int dirtyCount = dirty.size();
+    m_lastRecompiled = dirtyCount;
+
+    // 各网络相互独立，结果按下标写入各自的槽位，与串行编译逐字节一致。
+    // 调用线程也参与领取任务；使用独立线程池，避免在全局线程池的任务中
+    // 调用时等待自身排队的任务
+    std::atomic<int> next{0};
+    auto worker = [this, results, &dirty, dirtyCount, &next] {
+        for (int k = next.fetch_add(1); k < dirtyCount; k = next.fetch_add(1)) {
+            const int i = dirty[k];
+            results[i] = analyzeNetworkLogicV2(m_networks[i]);
+        }
+    };
+
+    const int maxThreads = m_maxThreads > 0 ? m_maxThreads : QThread::idealThreadCount();
+    const int threads = qMin(maxThreads, dirtyCount / ParallelGrain);
+    if (threads <= 1) {
+        worker();
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads - 1);
+        for (int i = 0; i < threads - 1; ++i) {
+            pool.start(worker);
+        }
+        worker();
+        pool.waitForDone();
+    }
+
+    // 缓存只保留当前这组网络，已删除或已修改的旧结果随之淘汰
+    QHash<CacheKey, CompiledNetwork> cache;
+    cache.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const LadderNetwork& network = m_networks[i];
+        if (network.rungId) {
+            cache.insert(CacheKey(network.rungId, network.revision), results[i]);
+        }
+    }
+    m_cache.swap(cache);
+
+    // 缓存中保存未绑定的结果，返回前再填入各网络当前的编号
+    for (int i = 0; i < count; ++i) {
+        bindNetwork(results[i], m_networks[i].id);
+    }
+    return compiled;
+}
+
+QString STCodeGenerator::generateVariableDeclarations(const QList<CompiledNetwork>& compiled) const {
+    int estimate = 0;
+    for (const CompiledNetwork& network : compiled) {
+        estimate += network.symbols.size();
+    }
+
+    SymbolTable table;
+    table.reserve(estimate);
+    for (const CompiledNetwork& network : compiled) {
+        for (auto it = network.symbols.constBegin(); it != network.symbols.constEnd(); ++it) {
+            table.declare(it.key(), it.value());
+        }
+    }
+    for (const CompiledNetwork& network : compiled) {
+        for (auto it = network.addresses.constBegin(); it != network.addresses.constEnd(); ++it) {
+            table.setAddress(table.find(it.key()), it.value());
+        }
+        for (const QString& name : network.written) {
+            table.markWritten(table.find(name));
+        }
+    }
+    return table.declarations();
+}
+
+QString STCodeGenerator::generateBody(const QList<CompiledNetwork>& compiled) const {
+    m_errors.clear();
+
+    // 标签所在网络位置
+    QHash<QString, int> labelIndex;
+    for (int i = 0; i < compiled.size(); ++i) {
+        const QString& label = compiled[i].labelName;
+        if (!label.isEmpty() && !labelIndex.contains(label)) {
+            labelIndex.insert(label, i);
+        }
+    }
+
+    // ST没有GOTO：前向跳转翻译为 IF NOT (条件) THEN ... END_IF 包住被跳过的网络
+    struct OpenJump {
+        QString label;
+        int index;
+    };
+    QVector<OpenJump> open;
+
+    // 按输出大小预分配，拼接过程中不再反复扩容
+    qsizetype estimate = 0;
+    for (const CompiledNetwork& network : compiled) {
+        estimate += network.code.size() + network.code.count(u'\n') * 8 + 64;
+    }
+    QString body;
+    body.reserve(estimate);
+
+    for (int i = 0; i < compiled.size(); ++i) {
+        const CompiledNetwork& network = compiled[i];
+
+        if (!network.labelName.isEmpty()) {
+            while (!open.isEmpty() && open.last().label == network.labelName) {
+                open.removeLast();
+                body += indent(open.size()) + "END_IF;\n\n";
+            }
+        }
+
+        const int depth = open.size();
+        const QString prefix = indent(depth);
+        for (QStringView line : QStringView(network.code).tokenize(u'\n', Qt::SkipEmptyParts)) {
+            body += prefix;
+            body += line;
+            body += u'\n';
+        }
+        body += u'\n';
+
+        if (!network.jumpTarget.isEmpty()) {
+            int target = labelIndex.value(network.jumpTarget, -1);
+            if (target > i && (open.isEmpty() || target <= open.last().index)) {
+                body += indent(depth) + "IF NOT (" + network.jumpCondition + ") THEN\n";
+                open.append(OpenJump{network.jumpTarget, target});
+            } else {
+                body += indent(depth) + "(* JMP " + network.jumpTarget
+                        + ": backward or overlapping jumps cannot be expressed in ST *)\n\n";
+                QString reason;
+                if (target < 0) {
+                    reason = QString("不存在");
+                } else if (target <= i) {
+                    reason = QString("在跳转之前（向后跳转），ST中无法表达");
+                } else {
+                    reason = QString("超出外层跳转的范围（交叉跳转），ST中无法表达");
+                }
+                m_errors.append(QString("网络 %1：跳转目标 %2 %3").arg(network.id).arg(network.jumpTarget, reason));
+            }
+        }
+    }
+
+    while (!open.isEmpty()) {
+        open.removeLast();
+        body += indent(open.size()) + "END_IF;\n\n";
+    }
+
+    return body;
+}
+
+QString STCodeGenerator::operandName(const ElementData& element) {
+    const QString name = element.name.trimmed();
+    if (isIdentifier(name)) return name;
+
+    const QString address = element.address.trimmed();
+    if (!address.isEmpty()) return address;
+
+    // 名称不是合法标识符时做替换
+    QString sanitized;
+    for (const QChar c : name) {
+        bool valid = c.unicode() <= 127 && (c.isLetterOrNumber() || c == '_');
+        if (valid && !(c == '_' && sanitized.endsWith('_'))) {
+            sanitized += c;
+        } else if (!sanitized.endsWith('_')) {
+            sanitized += '_';
+        }
+    }
+    if (sanitized.isEmpty() || sanitized.at(0).isDigit()) {
+        sanitized.prepend("V_");
+    }
+    return sanitized;
+}
+
+QString STCodeGenerator::instanceName(const ElementData& element,
+                                      const QString& typeName) const {
+    QString name = operandName(element);
+    // 默认名称与功能块类型同名（如 R_TRIG、RS）时不能作为实例名
+    if (!isIdentifier(name) || name.compare(typeName, Qt::CaseInsensitive) == 0) {
+        name = typeName + "_" + element.id;
+    }
+    return name;
+}
+
+QString STCodeGenerator::generateBooleanExpression(const ElementData& element,
+                                                   CompileContext& context) const {
+    const QString operand = operandName(element);
+
+    switch (element.type) {
+        case ElementType::NormallyOpen:
+            context.declare(operand, "BOOL");
+            return operand;
+
+        case ElementType::NormallyClosed:
+            context.declare(operand, "BOOL");
+            return "NOT " + operand;
+
+        case ElementType::PositiveEdge:
+        case ElementType::NegativeEdge: {
+            context.declare(operand, "BOOL");
+            bool rising = element.type == ElementType::PositiveEdge;
+            QString instance = context.newEdgeInstance(rising ? "R_TRIG" : "F_TRIG");
+            context.preStatements.append(instance + "(CLK := " + operand + ");");
+            return instance + ".Q";
+        }
+
+        case ElementType::ComparisonContact:
+        case ElementType::Comparison: {
+            QString in1 = element.properties.value("in1").toString().trimmed();
+            QString in2 = element.properties.value("in2").toString().trimmed();
+            if (in1.isEmpty()) in1 = "0";
+            if (in2.isEmpty()) in2 = "0";
+            const QString numeric = numericType({in1, in2});
+            context.declare(in1, numeric);
+            context.declare(in2, numeric);
+            int op = element.parameter("compare_op").toInt();
+            return "(" + in1 + " " + compareOperator(op) + " " + in2 + ")";
+        }
+
+        default:
+            return "TRUE";
+    }
+}
+
+QString STCodeGenerator::generateTimerCode(const ElementData& element,
+                                           const QString& instance,
+                                           const Expr& in, const Expr& reset) const {
+    int preset = element.properties.value("preset", 100).toInt();
+    // 复位端有能流时清除定时器：IN := 输入 AND NOT 复位（复位为 FALSE 时即为输入本身）
+    const Expr input = andExpr(in, notExpr(reset));
+    return instance + "(IN := " + input.text + ", PT := T#" + QString::number(preset) + "ms);";
+}
+
+QString STCodeGenerator::generateCounterCode(const ElementData& element,
+                                             const QString& instance,
+                                             const Expr& up, const Expr& down,
+                                             const Expr& reset) const {
+    const QString type = counterTypeName(element);
+    const QString preset = QString::number(element.properties.value("preset", 10).toInt());
+
+    if (type == "CTD") {
+        return instance + "(CD := " + up.text + ", LD := " + reset.text + ", PV := " + preset + ");";
+    }
+    if (type == "CTUD") {
+        return instance + "(CU := " + up.text + ", CD := " + down.text + ", R := " + reset.text
+               + ", LD := FALSE, PV := " + preset + ");";
+    }
+    return instance + "(CU := " + up.text + ", R := " + reset.text + ", PV := " + preset + ");";
+}
+
+QString STCodeGenerator::generateFunctionBlockCode(const ElementData& element,
+                                                   const QString& instance,
+                                                   const QString& in1, const QString& in2) const {
+    switch (element.type) {
+        case ElementType::RTrig:
+        case ElementType::FTrig:
+            return instance + "(CLK := " + in1 + ");";
+        case ElementType::RS:
+            return instance + "(S := " + in1 + ", R1 := " + in2 + ");";
+        case ElementType::SR:
+            return instance + "(S1 := " + in1 + ", R := " + in2 + ");";
+        default:
+            return QString();
+    }
+}
+
+void STCodeGenerator::buildNodeGraph(const LadderNetwork& network, const PowerFlowGraph& flow,
+                                     ReductionGraph& graph, CompileContext& context) const {
+    graph.nets.resize(flow.netCount());
+    graph.source = flow.sourceNet();
+    graph.sink = flow.sinkNet();
+    context.instances.resize(flow.elementCount());
+
+    auto addReader = [&graph](int net) {
+        if (net != PowerFlowGraph::NoNet) graph.nets[net].readers++;
+    };
+
+    for (int e = 0; e < flow.elementCount(); ++e) {
+        const auto& element = network.elements[e];
+        const ElementType type = flow.elementType(e);
+        const int in = flow.pinNet(e, 0);
+
+        switch (type) {
+            case ElementType::LeftPowerRail:
+            case ElementType::RightPowerRail:
+                break;
+
+            // 触点：节点之间的一条带标签的边
+            case ElementType::NormallyOpen:
+            case ElementType::NormallyClosed:
+            case ElementType::PositiveEdge:
+            case ElementType::NegativeEdge:
+            case ElementType::ComparisonContact:
+            case ElementType::Comparison: {
+                const int out = flow.pinNet(e, 1);
+                if (in == PowerFlowGraph::NoNet || out == PowerFlowGraph::NoNet) break;
+                if (in == out || out == graph.sink) break;
+                Expr label = atom(generateBooleanExpression(element, context));
+                graph.addEdge(in, out, label);
+                break;
+            }
+
+            // 线圈：读取输入能流，并把能流原样传到输出
+            case ElementType::OutputCoil:
+            case ElementType::InvertedCoil:
+            case ElementType::SetCoil:
+            case ElementType::ResetCoil:
+            case ElementType::PositiveEdgeCoil:
+            case ElementType::NegativeEdgeCoil:
+            case ElementType::MathOperation: {
+                const int out = flow.pinNet(e, type == ElementType::MathOperation ? 2 : 1);
+                addReader(in);
+                graph.actions.append(e);
+                if (in != PowerFlowGraph::NoNet && out != PowerFlowGraph::NoNet
+                    && in != out && out != graph.sink) {
+                    graph.addEdge(in, out, atom("TRUE"));
+                }
+                break;
+            }
+
+            case ElementType::Timer:
+            case ElementType::TimerTOF:
+            case ElementType::TimerTP:
+            case ElementType::Counter:
+            case ElementType::CounterCTD:
+            case ElementType::CounterCTUD:
+            case ElementType::RTrig:
+            case ElementType::FTrig:
+            case ElementType::RS:
+            case ElementType::SR: {
+                QString typeName;
+                switch (type) {
+                    case ElementType::Timer:
+                    case ElementType::TimerTOF:
+                    case ElementType::TimerTP: typeName = timerTypeName(element); break;
+                    case ElementType::Counter:
+                    case ElementType::CounterCTD:
+                    case ElementType::CounterCTUD: typeName = counterTypeName(element); break;
+                    case ElementType::RTrig: typeName = "R_TRIG"; break;
+                    case ElementType::FTrig: typeName = "F_TRIG"; break;
+                    case ElementType::RS: typeName = "RS"; break;
+                    default: typeName = "SR"; break;
+                }
+                context.instances[e] = instanceName(element, typeName);
+                context.declare(context.instances[e], typeName);
+
+                const int pins = PowerFlowGraph::pinCount(type);
+                for (int pin = 0; pin < pins; ++pin) {
+                    int net = flow.pinNet(e, pin);
+                    if (PowerFlowGraph::isOutputPin(type, pin)) {
+                        if (net != PowerFlowGraph::NoNet && net != graph.sink) {
+                            graph.nets[net].blocks.append(e);
+                        }
+                    } else {
+                        addReader(net);
+                    }
+                }
+                graph.actions.append(e);
+                break;
+            }
+
+            // 逻辑门：输出节点由输入节点直接计算
+            case ElementType::LogicAND:
+            case ElementType::LogicOR:
+            case ElementType::LogicNOT: {
+                const int outPin = type == ElementType::LogicNOT ? 1 : 2;
+                const int out = flow.pinNet(e, outPin);
+                for (int pin = 0; pin < outPin; ++pin) {
+                    addReader(flow.pinNet(e, pin));
+                }
+                if (out != PowerFlowGraph::NoNet && out != graph.sink) {
+                    graph.nets[out].blocks.append(e);
+                }
+                break;
+            }
+
+            case ElementType::Jump:
+            case ElementType::Return:
+                addReader(in);
+                graph.actions.append(e);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void STCodeGenerator::reduceSeriesParallel(ReductionGraph& graph) const {
+    // 并联合并在 addEdge 中完成；这里反复做串联合并：
+    // 入度、出度均为1且没有被读取的中间节点可以消去，两条边的标签相与。
+    // 每次合并至少消去一条边，总工作量与边数成线性关系。
+    const int netCount = graph.nets.size();
+    QVector<int> work;
+    QVector<bool> queued(netCount, true);
+    work.reserve(netCount);
+    for (int n = netCount - 1; n >= 0; --n) work.append(n);
+
+    auto push = [&](int n) {
+        if (!queued[n]) {
+            queued[n] = true;
+            work.append(n);
+        }
+    };
+
+    while (!work.isEmpty()) {
+        const int v = work.takeLast();
+        queued[v] = false;
+
+        const ReductionGraph::Net& net = graph.nets[v];
+        if (v == graph.source || v == graph.sink) continue;
+        if (net.readers > 0 || !net.blocks.isEmpty()) continue;
+        if (net.in.size() != 1 || net.out.size() != 1) continue;
+
+        const ReductionGraph::Edge first = graph.edges[net.in.first()];
+        const ReductionGraph::Edge second = graph.edges[net.out.first()];
+        if (first.from == v || second.to == v || first.from == second.to) continue;
+
+        graph.removeEdge(graph.nets[v].in.first());
+        graph.removeEdge(graph.nets[v].out.first());
+        graph.addEdge(first.from, second.to, andExpr(first.label, second.label));
+
+        push(first.from);
+        push(second.to);
+    }
+}
+
+QList<int> STCodeGenerator::topologicalSort(const ReductionGraph& graph, int& acyclicCount) const {
+    const int netCount = graph.nets.size();
+    QVector<QVector<int>> successors(netCount);
+    QVector<int> inDegree(netCount, 0);
+
+    auto addDependency = [&](int from, int to) {
+        if (from == PowerFlowGraph::NoNet || from == to) return;
+        successors[from].append(to);
+        inDegree[to]++;
+    };
+
+    for (int n = 0; n < netCount; ++n) {
+        for (int edge : graph.nets[n].in) {
+            addDependency(graph.edges[edge].from, n);
+        }
+    }
+
+    QList<int> order;
+    order.reserve(netCount);
+    QVector<int> ready;
+    for (int n = netCount - 1; n >= 0; --n) {
+        if (inDegree[n] == 0) ready.append(n);
+    }
+    while (!ready.isEmpty()) {
+        int n = ready.takeLast();
+        order.append(n);
+        for (int next : successors[n]) {
+            if (--inDegree[next] == 0) ready.append(next);
+        }
+    }
+    acyclicCount = order.size();
+
+    // 环上的节点按编号追加
+    for (int n = 0; n < netCount; ++n) {
+        if (inDegree[n] > 0) order.append(n);
+    }
+    return order;
+}
+
+CompiledNetwork STCodeGenerator::analyzeNetworkLogicV2(const LadderNetwork& network) const {
+    CompiledNetwork result;
+
+    PowerFlowGraph flow;
+    flow.build(network.elements, network.connections);
+
+    CompileContext context;
+
+    ReductionGraph graph;
+    buildNodeGraph(network, flow, graph, context);
+    reduceSeriesParallel(graph);
+
+    // 功能块/逻辑门输出的依赖：以零标签的虚边参与排序
+    ReductionGraph ordering = graph;
+    for (int n = 0; n < ordering.nets.size(); ++n) {
+        for (int e : graph.nets[n].blocks) {
+            const ElementType type = flow.elementType(e);
+            const int pins = PowerFlowGraph::pinCount(type);
+            for (int pin = 0; pin < pins; ++pin) {
+                if (PowerFlowGraph::isOutputPin(type, pin)) continue;
+                int input = flow.pinNet(e, pin);
+                if (input == PowerFlowGraph::NoNet || input == n) continue;
+                ordering.edges.append(ReductionGraph::Edge{input, n, atom("FALSE"), true});
+                ordering.nets[n].in.append(ordering.edges.size() - 1);
+            }
+        }
+    }
+    int acyclicCount = 0;
+    const QList<int> order = topologicalSort(ordering, acyclicCount);
+
+    const int netCount = graph.nets.size();
+    QVector<Expr> power(netCount, atom("FALSE"));
+    QStringList statements;
+
+    auto powerOf = [&](int net) {
+        return net == PowerFlowGraph::NoNet ? atom("FALSE") : power[net];
+    };
+
+    // 每个动作（线圈/功能块调用）在其全部输入节点求值完成后输出
+    QVector<int> pending(flow.elementCount(), 0);
+    QVector<QVector<int>> actionsByNet(netCount);
+    QVector<bool> emitted(flow.elementCount(), false);
+
+    auto emitAction = [&](int e) {
+        if (emitted[e]) return;
+        emitted[e] = true;
+
+        const auto& element = network.elements[e];
+        const ElementType type = flow.elementType(e);
+        const int inNet = flow.pinNet(e, 0);
+        const Expr in = powerOf(inNet);
+        const QString operand = operandName(element);
+
+        switch (type) {
+            case ElementType::OutputCoil:
+            case ElementType::InvertedCoil:
+                context.assign(operand, "BOOL");
+                statements.append(operand + " := "
+                                  + (type == ElementType::InvertedCoil ? notExpr(in) : in).text + ";");
+                break;
+
+            case ElementType::SetCoil:
+            case ElementType::ResetCoil: {
+                context.assign(operand, "BOOL");
+                const QString value = type == ElementType::SetCoil ? "TRUE" : "FALSE";
+                if (in.isTrue()) {
+                    statements.append(operand + " := " + value + ";");
+                } else if (!in.isFalse()) {
+                    statements.append("IF " + in.text + " THEN");
+                    statements.append(indent(1) + operand + " := " + value + ";");
+                    statements.append("END_IF;");
+                }
+                break;
+            }
+
+            case ElementType::PositiveEdgeCoil:
+            case ElementType::NegativeEdgeCoil: {
+                context.assign(operand, "BOOL");
+                bool rising = type == ElementType::PositiveEdgeCoil;
+                QString instance = context.newEdgeInstance(rising ? "R_TRIG" : "F_TRIG");
+                statements.append(instance + "(CLK := " + in.text + ");");
+                statements.append(operand + " := " + instance + ".Q;");
+                break;
+            }
+
+            case ElementType::MathOperation: {
+                QString in1 = element.properties.value("in1").toString().trimmed();
+                QString in2 = element.properties.value("in2").toString().trimmed();
+                QString out = element.properties.value("out").toString().trimmed();
+                if (in1.isEmpty()) in1 = "0";
+                if (in2.isEmpty()) in2 = "0";
+                if (out.isEmpty()) out = operand;
+                const QString numeric = numericType({in1, in2, out});
+                context.declare(in1, numeric);
+                context.declare(in2, numeric);
+                context.assign(out, numeric);
+                int op = element.parameter("math_op").toInt();
+                QString assignment = out + " := " + in1 + " " + mathOperator(op) + " " + in2 + ";";
+                if (in.isTrue()) {
+                    statements.append(assignment);
+                } else if (!in.isFalse()) {
+                    statements.append("IF " + in.text + " THEN");
+                    statements.append(indent(1) + assignment);
+                    statements.append("END_IF;");
+                }
+                break;
+            }
+
+            case ElementType::Timer:
+            case ElementType::TimerTOF:
+            case ElementType::TimerTP:
+                statements.append(generateTimerCode(element, context.instances[e], in,
+                                                    powerOf(flow.pinNet(e, 2))));
+                break;
+
+            case ElementType::Counter:
+            case ElementType::CounterCTD:
+            case ElementType::CounterCTUD:
+                statements.append(generateCounterCode(element, context.instances[e], in,
+                                                      powerOf(flow.pinNet(e, 1)),
+                                                      powerOf(flow.pinNet(e, 2))));
+                break;
+
+            case ElementType::RTrig:
+            case ElementType::FTrig:
+            case ElementType::RS:
+            case ElementType::SR:
+                statements.append(generateFunctionBlockCode(element, context.instances[e], in.text,
+                                                            powerOf(flow.pinNet(e, 1)).text));
+                break;
+
+            case ElementType::Jump:
+                if (result.jumpTarget.isEmpty()) {
+                    QString target = element.parameter("target_label").toString();
+                    if (target.isEmpty()) target = element.properties.value("target_label").toString();
+                    result.jumpTarget = target;
+                    result.jumpCondition = in.text;
+                }
+                break;
+
+            case ElementType::Return:
+                if (in.isTrue()) {
+                    statements.append("RETURN;");
+                } else if (!in.isFalse()) {
+                    statements.append("IF " + in.text + " THEN");
+                    statements.append(indent(1) + "RETURN;");
+                    statements.append("END_IF;");
+                }
+                break;
+
+            default:
+                break;
+        }
+    };
+
+    // 登记动作的输入节点
+    for (int e : graph.actions) {
+        const ElementType type = flow.elementType(e);
+        const int pins = PowerFlowGraph::pinCount(type);
+        bool isBlock = !(type == ElementType::OutputCoil || type == ElementType::InvertedCoil
+                         || type == ElementType::SetCoil || type == ElementType::ResetCoil
+                         || type == ElementType::PositiveEdgeCoil || type == ElementType::NegativeEdgeCoil
+                         || type == ElementType::MathOperation || type == ElementType::Jump
+                         || type == ElementType::Return);
+
+        // 线圈等元件未接入能流时不产生语句
+        if (!isBlock && flow.pinNet(e, 0) == PowerFlowGraph::NoNet) {
+            emitted[e] = true;
+            continue;
+        }
+
+        for (int pin = 0; pin < pins; ++pin) {
+            if (PowerFlowGraph::isOutputPin(type, pin)) continue;
+            if (!isBlock && pin > 0) continue;
+            int net = flow.pinNet(e, pin);
+            if (net == PowerFlowGraph::NoNet) continue;
+            if (!actionsByNet[net].contains(e)) {
+                actionsByNet[net].append(e);
+                pending[e]++;
+            }
+        }
+    }
+    for (int e : graph.actions) {
+        if (!emitted[e] && pending[e] == 0) emitAction(e);
+    }
+
+    auto useCount = [&graph](int net) {
+        return graph.nets[net].out.size() + graph.nets[net].readers;
+    };
+
+    // 环上的节点预先分配临时变量，读取的是上一扫描周期的值
+    for (int i = acyclicCount; i < order.size(); ++i) {
+        power[order[i]] = atom(context.newTemp());
+    }
+
+    for (int i = 0; i < order.size(); ++i) {
+        const int n = order[i];
+        const bool cyclic = i >= acyclicCount;
+
+        Expr value = atom(n == graph.source ? "TRUE" : "FALSE");
+        for (int edge : graph.nets[n].in) {
+            const ReductionGraph::Edge& e = graph.edges[edge];
+            value = orExpr(value, andExpr(power[e.from], e.label));
+        }
+        for (int e : graph.nets[n].blocks) {
+            const ElementType type = flow.elementType(e);
+            switch (type) {
+                case ElementType::LogicAND:
+                    value = orExpr(value, andExpr(powerOf(flow.pinNet(e, 0)), powerOf(flow.pinNet(e, 1))));
+                    break;
+                case ElementType::LogicOR:
+                    value = orExpr(value, orExpr(powerOf(flow.pinNet(e, 0)), powerOf(flow.pinNet(e, 1))));
+                    break;
+                case ElementType::LogicNOT:
+                    value = orExpr(value, notExpr(powerOf(flow.pinNet(e, 0))));
+                    break;
+                case ElementType::RS:
+                case ElementType::SR:
+                    value = orExpr(value, atom(context.instances[e] + ".Q1"));
+                    break;
+                case ElementType::Counter:
+                case ElementType::CounterCTD:
+                case ElementType::CounterCTUD: {
+                    bool upDown = counterTypeName(network.elements[e]) == "CTUD";
+                    value = orExpr(value, atom(context.instances[e] + (upDown ? ".QU" : ".Q")));
+                    break;
+                }
+                default:
+                    value = orExpr(value, atom(context.instances[e] + ".Q"));
+                    break;
+            }
+        }
+
+        if (cyclic) {
+            statements.append(power[n].text + " := " + value.text + ";");
+        } else if (value.prec != PrecPrimary && useCount(n) > 1) {
+            // 被多处使用的复合表达式存入临时变量，避免表达式重复展开
+            QString temp = context.newTemp();
+            statements.append(temp + " := " + value.text + ";");
+            power[n] = atom(temp);
+        } else {
+            power[n] = value;
+        }
+
+        for (int e : actionsByNet[n]) {
+            if (--pending[e] == 0) emitAction(e);
+        }
+    }
+
+    // 环导致未输出的动作
+    for (int e : graph.actions) {
+        emitAction(e);
+    }
+
+    // 标签网络
+    for (int e = 0; e < flow.elementCount(); ++e) {
+        if (flow.elementType(e) == ElementType::Label) {
+            result.labelName = network.elements[e].name;
+            break;
+        }
+    }
+
     QString code;
-    
-    // 网络注释
-    code += "(* Network " + QString::number(network.id);
+    code += QString("(* Network ") + NetworkIdMarker;
     if (!network.title.isEmpty()) {
         code += " - " + network.title;
     }
     code += " *)\n";
-    
-    // 简化的逻辑生成
-    code += "(* Simplified logic for network " + QString::number(network.id) + " *)\n";
-    code += "TempVar := StartButton AND NOT StopButton;\n";
-    code += "Motor := TempVar;\n";
-    
-    return code;
+    if (!result.labelName.isEmpty()) {
+        code += "(* LABEL " + result.labelName + ": *)\n";
+    }
+    for (const QString& line : context.preStatements) {
+        code += line + "\n";
+    }
+    for (const QString& line : statements) {
+        code += line + "\n";
+    }
+
+    result.code = code;
+    result.symbols = context.symbols;
+    result.written = context.written;
+
+    // 有名称又有地址的元件：地址决定变量所在的声明区段
+    for (const auto& element : network.elements) {
+        const QString address = element.address.trimmed();
+        if (address.isEmpty()) continue;
+        const QString operand = operandName(element);
+        if (result.symbols.contains(operand) && !result.addresses.contains(operand)) {
+            result.addresses.insert(operand, address);
+        }
+    }
+    return result;
+}
+
+QString STCodeGenerator::indent(int level) const {
+    return QString(level * 4, ' ');
 }
 
 } // namespace LadderDiagram
@@ -1,159 +1,162 @@
 #pragma once
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QList>
 #include <QtCore/QMap>
 #include <QtCore/QVariant>
 #include <QtCore/QSet>
+#include <QtCore/QHash>
 #include <QtCore/QVector>
 #include <memory>
+#include "PowerFlowGraph.h"
+#include "../core/LadderModel.h"
 
 namespace LadderDiagram {
 
-// 梯形图节点类型
-enum class LadderNodeType {
-    Input,      // 输入触点
-    Output,     // 输出线圈
-    Junction,   // 连接节点（并联分支点）
-    PowerRail   // 电源轨
-};
-
-// 梯形图逻辑节点
-struct LadderNode {
-    int id;                              // 节点ID
-    LadderNodeType type;                 // 节点类型
-    QString elementType;                 // 元件类型（NormallyOpen, OutputCoil等）
-    QString name;                        // 变量名
-    QString address;                     // 地址
-    QVariant properties;                 // 额外属性
-    
-    // 连接关系
-    QList<int> inputs;                   // 输入节点ID列表
-    QList<int> outputs;                  // 输出节点ID列表
-    
-    // 逻辑分析用
-    bool visited = false;
-    int depth = 0;                       // 拓扑深度
-    bool isParallelBranch = false;       // 是否为并联支路
-    int parallelGroupId = -1;            // 并联组ID
-};
-
 // 梯形图网络（一个完整的逻辑行）
 struct LadderNetwork {
-    int id;                              // 网络编号
+    int id;                              // 网络编号（按纵向顺序，从1开始）
+    int rungId = 0;                      // 场景中的稳定梯级编号（0 表示未知，不缓存）
+    quint64 revision = 0;                // 梯级内容版本，内容每次变化都取新值
     QString title;                       // 网络标题/注释
-    QList<QMap<QString, QVariant>> elements;      // 该网络中的所有元件
-    QList<QMap<QString, QVariant>> connections;   // 连接关系
-    
-    // 逻辑分析后的节点图
-    QMap<int, LadderNode> nodes;
-    int leftRailId = -1;
-    int rightRailId = -1;
+    QList<ElementData> elements;         // 该网络中的所有元件
+    QList<ConnectionData> connections;   // 连接关系
 };
 
-// 并联支路组
-struct ParallelBranch {
-    int groupId;                         // 组ID
-    int startNodeId;                     // 起始节点（分叉点）
-    int endNodeId;                       // 结束节点（汇合点）
-    QList<QList<int>> branches;          // 各支路的节点ID列表
-    QString stExpression;                // 生成的ST表达式
+// 单个网络的编译结果
+struct CompiledNetwork {
+    int id = 0;
+    QString code;                        // 网络ST代码（含注释）
+    QMap<QString, QString> symbols;      // 引用到的变量 -> 数据类型
+    QMap<QString, QString> addresses;    // 变量 -> PLC地址（元件同时有名称和地址时）
+    QSet<QString> written;               // 被线圈或运算结果赋值的变量
+    QString labelName;                   // 标签网络的标签名
+    QString jumpTarget;                  // 跳转目标标签
+    QString jumpCondition;               // 跳转条件表达式
 };
 
+// 串并联归约用的节点图、编译上下文与带优先级的表达式（定义见 STCodeGenerator.cpp）
+struct ReductionGraph;
+struct CompileContext;
+struct Expr;
+
 // ST代码生成器 - 将梯形图转换为IEC 61131-3标准ST语言
 class STCodeGenerator {
 public:
     STCodeGenerator();
-    
+
     // 设置程序信息
     void setProgramName(const QString& name);
     void setProgramDescription(const QString& desc);
-    
+
     // 添加网络
     void addNetwork(const LadderNetwork& network);
-    
-    // 从JSON数据加载梯形图
-    void loadFromJson(const QString& jsonData);
-    void loadFromJsonFile(const QString& filePath);
-    
-    // 生成ST代码
+    void clearNetworks();
+    int networkCount() const { return m_networks.size(); }
+
+    // 从JSON数据加载梯形图（按连线把场景拆分为网络）；失败时 errorString 给出原因
+    bool loadFromJson(const QString& jsonData, QString* errorString = nullptr);
+    bool loadFromJsonFile(const QString& filePath, QString* errorString = nullptr);
+
+    // 由逻辑模型加载（不构造任何图元）
+    void loadModel(const LadderModel& model);
+
+    // 把元件与连接线拆分为相互独立的网络，按纵向位置排序
+    static QList<LadderNetwork> splitNetworks(const QList<ElementData>& elements,
+                                              const QList<ConnectionData>& connections);
+
+    // 生成ST代码（各网络的语句）
     QString generateSTCode() const;
-    
+
     // 生成完整的POU（程序组织单元）
     QString generatePOU() const;
-    
-    // 保存到文件
+
+    // 预览文本：变量声明 + 网络语句（不含带时间戳的文件头）
+    QString generatePreview() const;
+
+    // 保存到文件；生成时有错误则不写文件并返回 false
     bool saveToFile(const QString& filePath) const;
-    
+
+    // 最近一次生成中发现的错误（如无法用ST表达的跳转），生成结果不可用
+    QStringList errors() const { return m_errors; }
+    bool hasErrors() const { return !m_errors.isEmpty(); }
+
+    // 增量编译：梯级编号与版本都与上次相同的网络直接复用缓存的编译结果，
+    // 不再比较内容，调用方须在梯级内容变化时给出新的 revision。
+    // 缓存跨多次 generate 调用保留；同一实例不能在多个线程中同时使用
+    void clearCache();
+    int lastRecompiledCount() const { return m_lastRecompiled; }
+
+    // 编译网络时最多使用的线程数（含调用线程，0 表示按CPU核数）。
+    // 调用方已经在并行处理多个工程时应设为 1，避免线程数成倍增长
+    void setMaxThreadCount(int threads) { m_maxThreads = qMax(0, threads); }
+    int maxThreadCount() const { return m_maxThreads; }
+
+    // 元件对应的操作数名（合法标识符的名称优先，其次为地址）
+    static QString operandName(const ElementData& element);
+
+    // 由工程文件名得到程序名（非法字符替换为下划线，不合法时返回空）
+    static QString programNameForFile(const QString& filePath);
+
 private:
     QString m_programName;
     QString m_programDescription;
     QList<LadderNetwork> m_networks;
-    
+
+    // 编译缓存：(梯级编号, 版本) -> 未绑定编号的编译结果
+    using CacheKey = QPair<int, quint64>;
+    mutable QHash<CacheKey, CompiledNetwork> m_cache;
+    mutable int m_lastRecompiled = 0;
+    int m_maxThreads = 0;
+    mutable QStringList m_errors;
+
     // ===== 逻辑分析核心算法 =====
-    
-    // 构建节点图
-    void buildNodeGraph(LadderNetwork& network) const;
-    
-    // 拓扑排序
-    QList<int> topologicalSort(const QMap<int, LadderNode>& nodes) const;
-    
-    // 识别并联支路
-    QList<ParallelBranch> identifyParallelBranches(LadderNetwork& network) const;
-    
-    // 查找所有路径
-    void findAllPaths(int startId, int endId, 
-                     const QMap<int, LadderNode>& nodes,
-                     QList<int>& currentPath,
-                     QList<QList<int>>& allPaths,
-                     QSet<int>& visited) const;
-    
-    // 分析节点逻辑（处理串联和并联）
-    QString analyzeNodeLogic(int nodeId, 
-                            const LadderNetwork& network,
-                            const QList<ParallelBranch>& parallelBranches,
-                            QSet<int>& processedNodes) const;
-    
-    // 生成并联支路的ST表达式
-    QString generateParallelExpression(const ParallelBranch& branch,
-                                      const LadderNetwork& network) const;
-    
-    // 生成串联路径的ST表达式
-    QString generateSeriesExpression(const QList<int>& nodeIds,
-                                    const LadderNetwork& network) const;
-    
+
+    // 构建节点图：触点为节点间的边，线圈/功能块读取节点能流
+    void buildNodeGraph(const LadderNetwork& network, const PowerFlowGraph& flow,
+                        ReductionGraph& graph, CompileContext& context) const;
+
+    // 串并联归约（线性时间，不做路径枚举）
+    void reduceSeriesParallel(ReductionGraph& graph) const;
+
+    // 拓扑排序（Kahn），返回无环部分的节点数，环上节点排在最后
+    QList<int> topologicalSort(const ReductionGraph& graph, int& acyclicCount) const;
+
+    // 分析网络逻辑：构建能流图，串并联归约后按拓扑序生成语句
+    CompiledNetwork analyzeNetworkLogicV2(const LadderNetwork& network) const;
+
+    // 编译全部网络（网络较多时在线程池上并行，结果顺序与串行一致）
+    QList<CompiledNetwork> compileNetworks() const;
+
+    // 每个工作线程至少分到的网络数，网络过少时不值得开线程
+    static constexpr int ParallelGrain = 32;
+
     // ===== 代码生成 =====
-    
-    // 变量声明生成
-    QString generateVariableDeclarations() const;
-    
-    // 单个网络转换为ST代码
-    QString networkToST(const LadderNetwork& network) const;
-    
-    // 分析网络逻辑结构（新版本）
-    QString analyzeNetworkLogicV2(LadderNetwork& network) const;
-    
-    // 生成布尔表达式
-    QString generateBooleanExpression(const QMap<QString, QVariant>& element) const;
-    
-    // 元件类型到ST操作符的映射
-    QString getElementOperator(const QString& elementType) const;
-    
-    // 生成定时器ST代码
-    QString generateTimerCode(const QMap<QString, QVariant>& element) const;
-    
-    // 生成计数器ST代码
-    QString generateCounterCode(const QMap<QString, QVariant>& element) const;
-    
-    // 生成功能块ST代码
-    QString generateFunctionBlockCode(const QMap<QString, QVariant>& element) const;
-    
-    // 生成逻辑运算ST代码
-    QString generateLogicCode(const QMap<QString, QVariant>& element) const;
-    
-    // 格式化代码
-    QString formatCode(const QString& code) const;
-    
+
+    // 文件头注释
+    QString generateHeader() const;
+
+    // 变量声明生成（VAR_INPUT / VAR_OUTPUT / VAR，经符号表去重并按地址排序）
+    QString generateVariableDeclarations(const QList<CompiledNetwork>& compiled) const;
+
+    // 网络代码拼接（处理跳转/标签）
+    QString generateBody(const QList<CompiledNetwork>& compiled) const;
+
+    // 元件对应的实例名
+    QString instanceName(const ElementData& element, const QString& typeName) const;
+
+    // 触点类元件的布尔表达式
+    QString generateBooleanExpression(const ElementData& element, CompileContext& context) const;
+
+    // 定时器/计数器/功能块调用语句
+    QString generateTimerCode(const ElementData& element, const QString& instance,
+                              const Expr& in, const Expr& reset) const;
+    QString generateCounterCode(const ElementData& element, const QString& instance,
+                                const Expr& up, const Expr& down, const Expr& reset) const;
+    QString generateFunctionBlockCode(const ElementData& element, const QString& instance,
+                                      const QString& in1, const QString& in2) const;
+
     // 缩进处理
     QString indent(int level) const;
 };
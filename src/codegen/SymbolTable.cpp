@@ -0,0 +1,193 @@
+#include "SymbolTable.h"
+#include <algorithm>
+
+namespace LadderDiagram {
+
+namespace {
+
+// 自然顺序比较：数字段按数值比较（X2 < X10），其余按字符比较
+bool naturalLess(QStringView a, QStringView b) {
+    qsizetype i = 0;
+    qsizetype j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i].isDigit() && b[j].isDigit()) {
+            qsizetype ei = i;
+            qsizetype ej = j;
+            while (ei < a.size() && a[ei].isDigit()) ++ei;
+            while (ej < b.size() && b[ej].isDigit()) ++ej;
+            // 去掉前导零后先比位数，再逐位比较
+            qsizetype si = i;
+            qsizetype sj = j;
+            while (si + 1 < ei && a[si] == u'0') ++si;
+            while (sj + 1 < ej && b[sj] == u'0') ++sj;
+            if (ei - si != ej - sj) return ei - si < ej - sj;
+            const int cmp = a.sliced(si, ei - si).compare(b.sliced(sj, ej - sj));
+            if (cmp != 0) return cmp < 0;
+            i = ei;
+            j = ej;
+            continue;
+        }
+        const QChar ca = a[i].toUpper();
+        const QChar cb = b[j].toUpper();
+        if (ca != cb) return ca < cb;
+        ++i;
+        ++j;
+    }
+    return a.size() - i < b.size() - j;
+}
+
+} // namespace
+
+void SymbolTable::clear() {
+    m_index.clear();
+    m_names.clear();
+    m_symbols.clear();
+}
+
+void SymbolTable::reserve(int count) {
+    m_index.reserve(count);
+    m_names.reserve(count);
+    m_symbols.reserve(count);
+}
+
+int SymbolTable::declare(const QString& name, const QString& type) {
+    auto it = m_index.constFind(name);
+    if (it != m_index.constEnd()) {
+        Symbol& existing = m_symbols[it.value()];
+        if (existing.type == QLatin1String("INT") && type == QLatin1String("REAL")) {
+            existing.type = type;
+        }
+        return it.value();
+    }
+
+    const int index = m_symbols.size();
+    Symbol symbol;
+    symbol.name = m_names.size();
+    symbol.type = type;
+    m_names.append(name);
+    m_symbols.append(symbol);
+    m_index.insert(name, index);
+    return index;
+}
+
+void SymbolTable::setAddress(int symbol, const QString& address) {
+    if (symbol < 0 || address.isEmpty()) return;
+    Symbol& entry = m_symbols[symbol];
+    if (!entry.address.isEmpty()) return;
+    entry.address = address;
+    updateSection(entry);
+}
+
+void SymbolTable::markWritten(int symbol) {
+    if (symbol < 0) return;
+    Symbol& entry = m_symbols[symbol];
+    entry.written = true;
+    updateSection(entry);
+}
+
+void SymbolTable::updateSection(Symbol& entry) {
+    // 功能块实例不能放在输入/输出区；输入区的变量对程序只读
+    if (isFunctionBlockType(entry.type)) {
+        entry.section = Section::Local;
+        return;
+    }
+    entry.section = sectionForAddress(entry.address);
+    if (entry.section == Section::Input && entry.written) {
+        entry.section = Section::Local;
+    }
+}
+
+SymbolTable::Section SymbolTable::sectionForAddress(QStringView address) {
+    QStringView text = address.trimmed();
+    if (text.startsWith(u'%')) text = text.sliced(1);
+    if (text.isEmpty()) return Section::Local;
+
+    const QChar first = text.front().toUpper();
+    if (first == u'X' || first == u'I') return Section::Input;
+    if (first == u'Y' || first == u'Q') return Section::Output;
+    return Section::Local;
+}
+
+bool SymbolTable::isFunctionBlockType(const QString& type) {
+    return type != QLatin1String("BOOL") && type != QLatin1String("INT") && type != QLatin1String("REAL");
+}
+
+QString SymbolTable::declarations() const {
+    // 按区段分组后排序：有地址的按地址，没有地址的按名称
+    QVector<int> inputs;
+    QVector<int> outputs;
+    QVector<int> variables;
+    QVector<int> instances;
+    for (int i = 0; i < m_symbols.size(); ++i) {
+        const Symbol& symbol = m_symbols[i];
+        if (isFunctionBlockType(symbol.type)) {
+            instances.append(i);
+        } else if (symbol.section == Section::Input) {
+            inputs.append(i);
+        } else if (symbol.section == Section::Output) {
+            outputs.append(i);
+        } else {
+            variables.append(i);
+        }
+    }
+
+    auto byAddress = [this](int a, int b) {
+        const Symbol& sa = m_symbols[a];
+        const Symbol& sb = m_symbols[b];
+        if (sa.address.isEmpty() != sb.address.isEmpty()) return !sa.address.isEmpty();
+        if (!sa.address.isEmpty() && sa.address != sb.address) return naturalLess(sa.address, sb.address);
+        return m_names[sa.name] < m_names[sb.name];
+    };
+    auto byName = [this](int a, int b) {
+        return m_names[m_symbols[a].name] < m_names[m_symbols[b].name];
+    };
+    std::sort(inputs.begin(), inputs.end(), byAddress);
+    std::sort(outputs.begin(), outputs.end(), byAddress);
+    std::sort(variables.begin(), variables.end(), byAddress);
+    std::sort(instances.begin(), instances.end(), byName);
+
+    QString text;
+    text.reserve(m_symbols.size() * 40 + 128);
+    auto appendLines = [this, &text](const QVector<int>& list) {
+        for (int index : list) {
+            const Symbol& symbol = m_symbols[index];
+            text += QLatin1String("    ");
+            text += m_names[symbol.name];
+            text += QLatin1String(" : ");
+            text += symbol.type;
+            text += u';';
+            if (!symbol.address.isEmpty() && symbol.address != m_names[symbol.name]) {
+                text += QLatin1String(" (* ");
+                text += symbol.address;
+                text += QLatin1String(" *)");
+            }
+            text += u'\n';
+        }
+    };
+
+    if (!inputs.isEmpty()) {
+        text += QLatin1String("VAR_INPUT\n");
+        appendLines(inputs);
+        text += QLatin1String("END_VAR\n\n");
+    }
+    if (!outputs.isEmpty()) {
+        text += QLatin1String("VAR_OUTPUT\n");
+        appendLines(outputs);
+        text += QLatin1String("END_VAR\n\n");
+    }
+
+    text += QLatin1String("VAR\n");
+    if (!variables.isEmpty()) {
+        text += QLatin1String("    (* Variables *)\n");
+        appendLines(variables);
+    }
+    if (!instances.isEmpty()) {
+        if (!variables.isEmpty()) text += u'\n';
+        text += QLatin1String("    (* Function Block Instances *)\n");
+        appendLines(instances);
+    }
+    text += QLatin1String("END_VAR\n");
+    return text;
+}
+
+} // namespace LadderDiagram
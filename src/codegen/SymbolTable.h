@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+namespace LadderDiagram {
+
+// 变量符号表
+//
+// 名称经哈希池驻留：每个名称只存一份，以编号引用，重复声明只做一次查找。
+// 声明区段由地址决定（X/I/%I 为输入，Y/Q/%Q 为输出，其余为内部变量），
+// 但程序中被赋值的变量不能声明为输入，即使地址是输入地址也放在 VAR 中。
+// 输出时各区段内按地址自然排序（X2 在 X10 之前），没有地址的按名称排在后面。
+class SymbolTable {
+public:
+    enum class Section {
+        Local,      // VAR
+        Input,      // VAR_INPUT
+        Output      // VAR_OUTPUT
+    };
+
+    struct Symbol {
+        int name = -1;              // 名称池编号
+        QString type;
+        QString address;
+        Section section = Section::Local;
+        bool written = false;       // 被线圈或运算结果赋值
+    };
+
+    void clear();
+    void reserve(int count);
+
+    // 登记符号，返回编号；重名时保留最先登记的类型，
+    // 但 INT 与 REAL 混用时提升为 REAL
+    int declare(const QString& name, const QString& type);
+    int find(QStringView name) const { return m_index.value(name.toString(), -1); }
+
+    // 补充 PLC 地址（只取第一个非空地址），同时决定声明区段
+    void setAddress(int symbol, const QString& address);
+
+    // 标记符号在程序中被赋值（与 setAddress 的调用顺序无关）
+    void markWritten(int symbol);
+
+    int count() const { return m_symbols.size(); }
+    const Symbol& symbol(int index) const { return m_symbols[index]; }
+    const QString& name(int index) const { return m_names[m_symbols[index].name]; }
+
+    // 生成 VAR_INPUT / VAR_OUTPUT / VAR 声明
+    QString declarations() const;
+
+    static Section sectionForAddress(QStringView address);
+    static bool isFunctionBlockType(const QString& type);
+
+private:
+    static void updateSection(Symbol& entry);
+
+    QHash<QString, int> m_index;        // 名称 -> 符号编号
+    QVector<QString> m_names;
+    QVector<Symbol> m_symbols;
+};
+
+} // namespace LadderDiagram
@@ -0,0 +1,76 @@
+#include "BackgroundSaver.h"
+#include <QtCore/QBuffer>
+#include <QtCore/QSaveFile>
+#include "SceneSnapshot.h"
+
+namespace LadderDiagram {
+
+BackgroundSaver::BackgroundSaver(QObject* parent)
+    : QObject(parent)
+{
+    // 单线程保证同一文件的多次保存按顺序落盘
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+}
+
+BackgroundSaver::~BackgroundSaver() {
+    waitForDone();
+}
+
+void BackgroundSaver::waitForDone() {
+    m_pool.waitForDone();
+}
+
+void BackgroundSaver::save(const LadderModel& model, const QString& path, Format format, bool compressed) {
+    m_pending.ref();
+    m_pool.start([this, model, path, format, compressed] {
+        QString error;
+        const bool ok = write(model, path, format, compressed, &error);
+        m_pending.deref();
+        emit finished(path, ok, error);
+    });
+}
+
+bool BackgroundSaver::write(LadderModel model, const QString& path, Format format,
+                            bool compressed, QString* errorString) {
+    model.sortForSave();
+    const SceneSnapshot snapshot = model.toSnapshot();
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    bool written = false;
+    if (format == Json && !compressed) {
+        // JSON 直接流式写入临时文件
+        written = snapshot.writeJson(&file);
+    } else {
+        QByteArray data;
+        if (format == Binary) {
+            data = snapshot.toBinary();
+        } else {
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::WriteOnly);
+            snapshot.writeJson(&buffer);
+        }
+        if (compressed) {
+            data = qCompress(data);
+        }
+        written = file.write(data) == data.size();
+    }
+
+    if (!written) {
+        *errorString = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QThreadPool>
+#include "LadderModel.h"
+
+namespace LadderDiagram {
+
+// 后台保存 - 在工作线程上序列化快照并写盘
+//
+// 界面线程只交来值类型记录（LadderScene::snapshot()），按保存顺序排序、
+// 转换为 .ldjson 记录与编码都在工作线程上完成。
+//
+// 保存任务按提交顺序在单个工作线程上依次执行；文件先写入同目录下的
+// 临时文件，全部写完后再原子地替换目标文件（QSaveFile），中途失败或
+// 程序退出不会留下写了一半的工程文件。
+class BackgroundSaver : public QObject {
+    Q_OBJECT
+
+public:
+    enum Format {
+        Json,       // .ldjson
+        Binary      // .ldbin
+    };
+
+    explicit BackgroundSaver(QObject* parent = nullptr);
+    ~BackgroundSaver();
+
+    // 提交保存任务（compressed 为 true 时以 qCompress 压缩后写入）
+    void save(const LadderModel& model, const QString& path, Format format, bool compressed = false);
+
+    // 是否还有未完成的任务
+    bool isBusy() const { return m_pending.loadAcquire() > 0; }
+
+    // 等待所有任务完成
+    void waitForDone();
+
+signals:
+    // 任务完成（在工作线程发出，接收方在界面线程时自动排队）
+    void finished(const QString& path, bool ok, const QString& errorString);
+
+private:
+    static bool write(LadderModel model, const QString& path, Format format,
+                      bool compressed, QString* errorString);
+
+    QThreadPool m_pool;
+    QAtomicInt m_pending;
+};
+
+} // namespace LadderDiagram
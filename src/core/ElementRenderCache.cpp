@@ -0,0 +1,28 @@
+#include "ElementRenderCache.h"
+#include <QtMath>
+
+namespace LadderDiagram {
+
+ElementRenderCache& ElementRenderCache::instance() {
+    static ElementRenderCache cache;
+    return cache;
+}
+
+int ElementRenderCache::zoomBucket(qreal levelOfDetail) {
+    return qRound(std::log2(levelOfDetail) * 2);
+}
+
+qreal ElementRenderCache::bucketScale(int bucket) {
+    return std::exp2(bucket / 2.0);
+}
+
+const QPixmap* ElementRenderCache::find(const Key& key) const {
+    auto it = m_glyphs.constFind(key);
+    return it == m_glyphs.constEnd() ? nullptr : &it.value();
+}
+
+void ElementRenderCache::insert(const Key& key, const QPixmap& pixmap) {
+    m_glyphs.insert(key, pixmap);
+}
+
+} // namespace LadderDiagram
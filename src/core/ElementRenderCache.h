@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QHash>
+#include <QPixmap>
+#include <QRgb>
+#include "ElementTypes.h"
+
+namespace LadderDiagram {
+
+// 元件静态图形缓存
+//
+// 同类型元件的主体图形（线条、圆弧、固定文字）完全相同，按
+// (类型, 变体, 边框颜色, 缩放档位, 设备像素比) 只绘制一次到位图，
+// 所有元件共享；名称标签、选中框、通电高亮和连接点状态仍逐个绘制。
+// 缩放按半个八度分档，档位之间的差异由平滑缩放补齐。
+class ElementRenderCache {
+public:
+    struct Key {
+        ElementType type;
+        int variant;
+        QRgb color;
+        int zoomBucket;
+        int pixelRatio;     // 设备像素比 x100
+
+        bool operator==(const Key& other) const {
+            return type == other.type && variant == other.variant && color == other.color
+                   && zoomBucket == other.zoomBucket && pixelRatio == other.pixelRatio;
+        }
+    };
+
+    // 可缓存的缩放范围（细节层次），超出时直接矢量绘制
+    static constexpr qreal MinLevelOfDetail = 0.125;
+    static constexpr qreal MaxLevelOfDetail = 4.0;
+
+    static ElementRenderCache& instance();
+
+    // 缩放档位与档位对应的位图缩放比例
+    static int zoomBucket(qreal levelOfDetail);
+    static qreal bucketScale(int bucket);
+
+    const QPixmap* find(const Key& key) const;
+    void insert(const Key& key, const QPixmap& pixmap);
+
+    // 主题或元件外观变化后清空
+    void clear() { m_glyphs.clear(); }
+
+private:
+    ElementRenderCache() = default;
+
+    QHash<Key, QPixmap> m_glyphs;
+};
+
+inline size_t qHash(const ElementRenderCache::Key& key, size_t seed = 0) {
+    return qHashMulti(seed, int(key.type), key.variant, key.color, key.zoomBucket, key.pixelRatio);
+}
+
+} // namespace LadderDiagram
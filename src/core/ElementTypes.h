@@ -0,0 +1,70 @@
+#pragma once
+
+// 元件类型定义（不依赖 QtGui/QtWidgets，供代码生成与仿真使用）
+
+namespace LadderDiagram {
+
+// 元件类型枚举 - 符合 IEC 61131-3:2013 / GB/T 15969.3 标准
+enum class ElementType {
+    Unknown,
+    
+    // 电源轨线 (Power Rails)
+    LeftPowerRail,      // 左电源轨 - 能流起点
+    RightPowerRail,     // 右电源轨 - 能流终点
+    
+    // 触点 (Contacts)
+    NormallyOpen,       // 常开触点 (NO) --| |--
+    NormallyClosed,     // 常闭触点 (NC) --|/|--
+    PositiveEdge,       // 正边沿检测触点 (P) --|P|--
+    NegativeEdge,       // 负边沿检测触点 (N) --|N|--
+    ComparisonContact,  // 比较触点
+    
+    // 线圈 (Coils)
+    OutputCoil,         // 一般线圈 --( )--
+    InvertedCoil,       // 取反线圈 --(/)--
+    SetCoil,            // 置位线圈 --(S)--
+    ResetCoil,          // 复位线圈 --(R)--
+    PositiveEdgeCoil,   // 正边沿线圈 --(P)--
+    NegativeEdgeCoil,   // 负边沿线圈 --(N)--
+    
+    // 定时器 (Timers)
+    Timer,              // TON - 通电延时
+    TimerTOF,           // TOF - 断电延时
+    TimerTP,            // TP - 脉冲定时器
+    
+    // 计数器 (Counters)
+    Counter,            // CTU - 加计数器
+    CounterCTD,         // CTD - 减计数器
+    CounterCTUD,        // CTUD - 加减计数器
+    
+    // 功能块 (Function Blocks)
+    RTrig,              // 上升沿检测功能块
+    FTrig,              // 下降沿检测功能块
+    RS,                 // 置位优先触发器
+    SR,                 // 复位优先触发器
+    
+    // 运算功能
+    Comparison,         // 比较指令
+    MathOperation,      // 数学运算
+    LogicAND,           // 逻辑与
+    LogicOR,            // 逻辑或
+    LogicNOT,           // 逻辑非
+    
+    // 程序控制
+    Jump,               // 跳转
+    Return,             // 返回
+    Label,              // 网络标签
+    
+    // 连接线
+    ConnectionLine      // 连接线
+};
+
+// 连接点类型
+enum class ConnectionType {
+    Input,      // 输入
+    Output,     // 输出
+    PowerIn,    // 电源输入
+    PowerOut    // 电源输出
+};
+
+} // namespace LadderDiagram
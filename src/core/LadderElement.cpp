@@ -1,121 +1,237 @@
 #include "LadderElement.h"
+#include "ElementRenderCache.h"
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
 #include <QStyleOptionGraphicsItem>
+#include <QtMath>
 
 namespace LadderDiagram {
 
 LadderElement::LadderElement(ElementType type, QGraphicsItem* parent)
     : QGraphicsItem(parent)
-    , m_type(type)
     , m_size(100, 60)
-    , m_fillColor(QColor("#2D2D2D"))
-    , m_borderColor(QColor("#007ACC"))
-    , m_textColor(QColor("#E0E0E0"))
 {
+    m_record.type = type;
     setFlag(QGraphicsItem::ItemIsMovable);
     setFlag(QGraphicsItem::ItemIsSelectable);
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges);
     setAcceptHoverEvents(true);
 }
 
 LadderElement::~LadderElement() = default;
 
 void LadderElement::setName(const QString& name) {
-    m_name = name;
+    m_record.name = name;
     update();
+    notifyContentChanged();
 }
 
 void LadderElement::setAddress(const QString& address) {
-    m_address = address;
+    m_record.address = address;
     update();
+    notifyContentChanged();
 }
 
 void LadderElement::setComment(const QString& comment) {
-    m_comment = comment;
+    m_record.comment = comment;
     update();
+    notifyContentChanged();
 }
 
 QVariant LadderElement::getProperty(const QString& key) const {
-    return m_properties.value(key);
+    return m_record.properties.value(key);
 }
 
 void LadderElement::setProperty(const QString& key, const QVariant& value) {
-    m_properties[key] = value;
+    m_record.properties[key] = value;
+    notifyContentChanged();
+}
+
+void LadderElement::notifyContentChanged() {
+    if (m_listener) {
+        m_listener->elementContentChanged(this);
+    }
+}
+
+void LadderElement::setEnergized(bool energized) {
+    if (m_energized == energized) return;
+    m_energized = energized;
+    update();
+}
+
+ElementData LadderElement::elementData() const {
+    ElementData record = m_record;
+    record.position = pos();
+    return record;
 }
 
 QMap<QString, QVariant> LadderElement::toMap() const {
-    QMap<QString, QVariant> map;
-    map["type"] = static_cast<int>(m_type);
-    map["name"] = m_name;
-    map["address"] = m_address;
-    map["comment"] = m_comment;
-    map["x"] = pos().x();
-    map["y"] = pos().y();
-    map["properties"] = m_properties;
-    return map;
+    return elementData().toMap();
 }
 
 void LadderElement::fromMap(const QMap<QString, QVariant>& map) {
-    m_name = map["name"].toString();
-    m_address = map["address"].toString();
-    m_comment = map["comment"].toString();
-    setPos(map["x"].toReal(), map["y"].toReal());
-    m_properties = map["properties"].toMap();
+    const ElementData record = ElementData::fromMap(map);
+    m_record.name = record.name;
+    m_record.address = record.address;
+    m_record.comment = record.comment;
+    m_record.properties = record.properties;
+    // 子类型参数按键合并：记录中缺少的键保留构造时的默认值
+    for (auto it = record.parameters.constBegin(); it != record.parameters.constEnd(); ++it) {
+        m_record.parameters.insert(it.key(), it.value());
+    }
+    setPos(record.position);
 }
 
-QRectF LadderElement::boundingRect() const {
+QRectF LadderElement::bodyRect() const {
     return QRectF(-m_size.width() / 2 - 5, -m_size.height() / 2 - 5,
                   m_size.width() + 10, m_size.height() + 10);
 }
 
+QRectF LadderElement::outlineRect() const {
+    return QRectF(-m_size.width() / 2, -m_size.height() / 2, m_size.width(), m_size.height());
+}
+
+QRectF LadderElement::boundingRect() const {
+    // 主体 + 上方注释文字 + 下方标签，视图按此区域做局部重绘
+    return QRectF(-m_size.width() / 2 - LabelOverhang, -m_size.height() / 2 - 18,
+                  m_size.width() + 2 * LabelOverhang, m_size.height() + 18 + 24);
+}
+
+QPainterPath LadderElement::shape() const {
+    // 点选与框选只按元件主体
+    QPainterPath path;
+    path.addRect(bodyRect());
+    return path;
+}
+
 void LadderElement::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
                           QWidget* widget) {
-    painter->setRenderHint(QPainter::Antialiasing);
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const DetailLevel detail = detailLevelFor(lod);
+    const QRectF body = outlineRect();
+    
+    // 总览：只画实心矩形
+    if (detail == DetailLevel::Outline) {
+        QColor color = borderColor();
+        if (isSelected()) color = Qt::blue;
+        else if (m_energized) color = QColor(0, 200, 0);
+        painter->fillRect(body, color);
+        return;
+    }
+    
+    painter->setRenderHint(QPainter::Antialiasing, detail == DetailLevel::Full);
     
     // 绘制选中效果
     if (isSelected()) {
         painter->setPen(QPen(Qt::blue, 2, Qt::DashLine));
-        painter->drawRect(boundingRect());
+        painter->drawRect(bodyRect());
+    }
+    
+    // 绘制仿真通电高亮
+    if (m_energized) {
+        painter->fillRect(body, QColor(0, 200, 0, 60));
+    }
+    
+    // 绘制元件主体：静态图形取自共享缓存，动态部分叠加在上面
+    if (!drawCachedElement(painter, lod)) {
+        drawElement(painter);
     }
     
-    // 绘制元件主体
-    drawElement(painter);
+    // 缩小后文字与连接点已无法辨认，不再绘制
+    if (detail != DetailLevel::Full) return;
+    
+    drawDynamic(painter);
     
     // 绘制连接点
     drawConnectionPoints(painter);
     
     // 绘制标签
-    if (!m_name.isEmpty() || !m_address.isEmpty()) {
+    if (!m_record.name.isEmpty() || !m_record.address.isEmpty()) {
         drawLabel(painter);
     }
 }
 
+bool LadderElement::drawCachedElement(QPainter* painter, qreal levelOfDetail) {
+    // 放得很大时位图过大，直接矢量绘制更清晰
+    if (levelOfDetail < ElementRenderCache::MinLevelOfDetail
+        || levelOfDetail > ElementRenderCache::MaxLevelOfDetail) {
+        return false;
+    }
+    
+    const qreal pixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const ElementRenderCache::Key key{m_record.type, glyphVariant(), borderColor().rgba(),
+                                      ElementRenderCache::zoomBucket(levelOfDetail),
+                                      qRound(pixelRatio * 100)};
+    const QRectF rect = bodyRect();
+    
+    ElementRenderCache& cache = ElementRenderCache::instance();
+    const QPixmap* glyph = cache.find(key);
+    if (!glyph) {
+        const qreal scale = ElementRenderCache::bucketScale(key.zoomBucket) * pixelRatio;
+        QPixmap pixmap(qCeil(rect.width() * scale), qCeil(rect.height() * scale));
+        pixmap.fill(Qt::transparent);
+        
+        QPainter glyphPainter(&pixmap);
+        glyphPainter.setRenderHint(QPainter::Antialiasing);
+        glyphPainter.setFont(painter->font());
+        glyphPainter.scale(scale, scale);
+        glyphPainter.translate(-rect.topLeft());
+        drawElement(&glyphPainter);
+        glyphPainter.end();
+        
+        cache.insert(key, pixmap);
+        glyph = cache.find(key);
+    }
+    
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->drawPixmap(rect, *glyph, QRectF(glyph->rect()));
+    painter->restore();
+    return true;
+}
+
 void LadderElement::drawConnectionPoints(QPainter* painter) {
-    auto points = connectionPoints();
-    for (const auto& point : points) {
-        painter->setBrush(point.isConnected ? Qt::green : Qt::white);
-        painter->setPen(QPen(Qt::black, 1));
-        painter->drawEllipse(point.position, 4, 4);
+    const auto points = connectionPoints();
+    painter->setPen(QPen(Qt::black, 1));
+    for (int i = 0; i < int(points.size()); ++i) {
+        painter->setBrush(isPinConnected(i) ? Qt::green : Qt::white);
+        painter->drawEllipse(points[i].position, 4, 4);
     }
 }
 
+void LadderElement::attachPin(int pin) {
+    if (pin < 0 || pin >= int(connectionPoints().size())) return;
+    if (m_pinConnections[pin]++ == 0) update();
+}
+
+void LadderElement::detachPin(int pin) {
+    if (pin < 0 || pin >= int(connectionPoints().size()) || m_pinConnections[pin] == 0) return;
+    if (--m_pinConnections[pin] == 0) update();
+}
+
+bool LadderElement::isPinConnected(int pin) const {
+    return pin >= 0 && pin < PinTables::MaxPins && m_pinConnections[pin] > 0;
+}
+
 void LadderElement::drawLabel(QPainter* painter) {
-    painter->setPen(m_textColor);
+    painter->setPen(textColor());
     QFont font = painter->font();
     font.setPointSize(8);
     painter->setFont(font);
     
     QString label;
-    if (!m_name.isEmpty() && !m_address.isEmpty()) {
-        label = QString("%1 (%2)").arg(m_name, m_address);
-    } else if (!m_name.isEmpty()) {
-        label = m_name;
+    if (!m_record.name.isEmpty() && !m_record.address.isEmpty()) {
+        label = QString("%1 (%2)").arg(m_record.name, m_record.address);
+    } else if (!m_record.name.isEmpty()) {
+        label = m_record.name;
     } else {
-        label = m_address;
+        label = m_record.address;
     }
     
-    QRectF textRect(-m_size.width() / 2, m_size.height() / 2 + 2, 
-                    m_size.width(), 20);
+    // 过长的标签截断，保证不超出 boundingRect()
+    QRectF textRect(-m_size.width() / 2 - LabelOverhang, m_size.height() / 2 + 2, 
+                    m_size.width() + 2 * LabelOverhang, 20);
+    label = painter->fontMetrics().elidedText(label, Qt::ElideRight, int(textRect.width()));
     painter->drawText(textRect, Qt::AlignCenter, label);
 }
 
@@ -134,6 +250,14 @@ bool LadderElement::canConnect(const ConnectionPoint& point, const ConnectionPoi
     return isInputOutput || isPower;
 }
 
+QVariant LadderElement::itemChange(GraphicsItemChange change, const QVariant& value) {
+    // 位置变化时通知场景，只更新与本元件相连的连接线
+    if (change == QGraphicsItem::ItemPositionHasChanged && m_listener) {
+        m_listener->elementGeometryChanged(this);
+    }
+    return QGraphicsItem::itemChange(change, value);
+}
+
 void LadderElement::mousePressEvent(QGraphicsSceneMouseEvent* event) {
     QGraphicsItem::mousePressEvent(event);
     update();
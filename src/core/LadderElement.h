@@ -5,81 +5,37 @@
 #include <QMap>
 #include <QVariant>
 #include <memory>
+#include "ElementTypes.h"
+#include "PinTables.h"
+#include "LadderModel.h"
 
 namespace LadderDiagram {
 
-// 元件类型枚举 - 符合 IEC 61131-3:2013 / GB/T 15969.3 标准
-enum class ElementType {
-    Unknown,
-    
-    // 电源轨线 (Power Rails)
-    LeftPowerRail,      // 左电源轨 - 能流起点
-    RightPowerRail,     // 右电源轨 - 能流终点
-    
-    // 触点 (Contacts)
-    NormallyOpen,       // 常开触点 (NO) --| |--
-    NormallyClosed,     // 常闭触点 (NC) --|/|--
-    PositiveEdge,       // 正边沿检测触点 (P) --|P|--
-    NegativeEdge,       // 负边沿检测触点 (N) --|N|--
-    ComparisonContact,  // 比较触点
-    
-    // 线圈 (Coils)
-    OutputCoil,         // 一般线圈 --( )--
-    InvertedCoil,       // 取反线圈 --(/)--
-    SetCoil,            // 置位线圈 --(S)--
-    ResetCoil,          // 复位线圈 --(R)--
-    PositiveEdgeCoil,   // 正边沿线圈 --(P)--
-    NegativeEdgeCoil,   // 负边沿线圈 --(N)--
-    
-    // 定时器 (Timers)
-    Timer,              // TON - 通电延时
-    TimerTOF,           // TOF - 断电延时
-    TimerTP,            // TP - 脉冲定时器
-    
-    // 计数器 (Counters)
-    Counter,            // CTU - 加计数器
-    CounterCTD,         // CTD - 减计数器
-    CounterCTUD,        // CTUD - 加减计数器
-    
-    // 功能块 (Function Blocks)
-    RTrig,              // 上升沿检测功能块
-    FTrig,              // 下降沿检测功能块
-    RS,                 // 置位优先触发器
-    SR,                 // 复位优先触发器
-    
-    // 运算功能
-    Comparison,         // 比较指令
-    MathOperation,      // 数学运算
-    LogicAND,           // 逻辑与
-    LogicOR,            // 逻辑或
-    LogicNOT,           // 逻辑非
-    
-    // 程序控制
-    Jump,               // 跳转
-    Return,             // 返回
-    Label,              // 网络标签
-    
-    // 连接线
-    ConnectionLine      // 连接线
-};
+class LadderElement;
 
-// 连接点类型
-enum class ConnectionType {
-    Input,      // 输入
-    Output,     // 输出
-    PowerIn,    // 电源输入
-    PowerOut    // 电源输出
+// 绘制细节层次（按 QStyleOptionGraphicsItem::levelOfDetailFromTransform 划分）
+enum class DetailLevel {
+    Full,       // 完整绘制：抗锯齿、文字、连接点
+    Reduced,    // 只画元件主体与单像素连接线，不画文字和连接点
+    Outline     // 总览：元件画成实心矩形
 };
 
-// 连接点结构
-struct ConnectionPoint {
-    QPointF position;
-    ConnectionType type;
-    QString name;
-    bool isConnected = false;
-    
-    ConnectionPoint(const QPointF& pos, ConnectionType t, const QString& n)
-        : position(pos), type(t), name(n) {}
+inline DetailLevel detailLevelFor(qreal levelOfDetail) {
+    if (levelOfDetail >= 0.5) return DetailLevel::Full;
+    if (levelOfDetail >= 0.2) return DetailLevel::Reduced;
+    return DetailLevel::Outline;
+}
+
+// 元件变化监听接口（由场景实现，用于增量维护连接线等索引）
+class ElementChangeListener {
+public:
+    virtual ~ElementChangeListener() = default;
+    
+    // 元件位置发生变化
+    virtual void elementGeometryChanged(LadderElement* element) = 0;
+    
+    // 名称、地址、注释或属性发生变化
+    virtual void elementContentChanged(LadderElement* element) = 0;
 };
 
 // 梯形图元件基类
@@ -89,34 +45,48 @@ public:
     virtual ~LadderElement();
     
     // 获取元件类型
-    ElementType elementType() const { return m_type; }
+    ElementType elementType() const { return m_record.type; }
     
     // 获取/设置元件名称
-    QString name() const { return m_name; }
+    QString name() const { return m_record.name; }
     void setName(const QString& name);
     
     // 获取/设置地址
-    QString address() const { return m_address; }
+    QString address() const { return m_record.address; }
     void setAddress(const QString& address);
     
     // 获取/设置注释
-    QString comment() const { return m_comment; }
+    QString comment() const { return m_record.comment; }
     void setComment(const QString& comment);
     
-    // 获取连接点
-    virtual QList<ConnectionPoint> connectionPoints() const = 0;
+    // 获取连接点（指向按类型的常量引脚表，不分配内存）
+    QSpan<const ConnectionPoint> connectionPoints() const { return PinTables::pins(m_record.type); }
+    
+    // 引脚连线计数（由所属场景在添加/移除连接线时维护）
+    void attachPin(int pin);
+    void detachPin(int pin);
+    bool isPinConnected(int pin) const;
     
     // 属性管理
     QVariant getProperty(const QString& key) const;
     void setProperty(const QString& key, const QVariant& value);
-    QMap<QString, QVariant> properties() const { return m_properties; }
+    QMap<QString, QVariant> properties() const { return m_record.properties; }
+    
+    // 逻辑数据：m_record 加上图元当前位置，字段均为隐式共享，复制开销很小；
+    // 不叫 data()，以免遮蔽 QGraphicsItem::data(int)
+    ElementData elementData() const;
     
-    // 序列化
-    virtual QMap<QString, QVariant> toMap() const;
+    // 序列化（即 elementData().toMap()；子类只在读取时恢复自身状态）
+    QMap<QString, QVariant> toMap() const;
     virtual void fromMap(const QMap<QString, QVariant>& map);
     
-    // 获取边界矩形
+    // 获取边界矩形（含标签文字）与元件主体矩形
     QRectF boundingRect() const override;
+    QPainterPath shape() const override;
+    QRectF bodyRect() const;
+    
+    // 元件外框（不含选中边距），连接点位于其边缘上；布线时作为障碍
+    QRectF outlineRect() const;
     
     // 绘制元件
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, 
@@ -128,30 +98,63 @@ public:
     // 是否可以被连接
     virtual bool canConnect(const ConnectionPoint& point, const ConnectionPoint& other) const;
     
+    // 仿真通电状态（用于显示能流）
+    void setEnergized(bool energized);
+    bool isEnergized() const { return m_energized; }
+    
+    // 设置变化监听者（由所属场景设置）
+    void setChangeListener(ElementChangeListener* listener) { m_listener = listener; }
+    ElementChangeListener* changeListener() const { return m_listener; }
+    
 protected:
-    // 绘制元件主体（子类实现）
+    // 绘制元件主体的静态图形（子类实现）；结果按类型与 glyphVariant()
+    // 缓存共享，因此不能依赖名称等逐个元件不同的内容
     virtual void drawElement(QPainter* painter) = 0;
     
+    // 静态图形的变体编号（例如定时器/计数器类型、运算符）
+    virtual int glyphVariant() const { return 0; }
+    
+    // 绘制逐个元件不同的内容（叠加在静态图形之上，不缓存）
+    virtual void drawDynamic(QPainter* painter) { Q_UNUSED(painter) }
+    
+    // 以缓存位图绘制静态图形，不适合缓存时返回 false
+    bool drawCachedElement(QPainter* painter, qreal levelOfDetail);
+    
     // 绘制连接点
     void drawConnectionPoints(QPainter* painter);
     
+    // 通知监听者逻辑内容已变化
+    void notifyContentChanged();
+    
+    // 设置子类型参数（element_subtype、timer_type 等），随 elementData() 交给代码生成与仿真
+    void setParameter(const QString& key, const QVariant& value) { m_record.parameters.insert(key, value); }
+    
     // 绘制标签
     void drawLabel(QPainter* painter);
     
-    ElementType m_type;
-    QString m_name;
-    QString m_address;
-    QString m_comment;
-    QMap<QString, QVariant> m_properties;
+    // 逻辑数据（类型、名称、地址、注释、属性、子类型参数）；图元只是它的视图，
+    // 位置以图元自身的 pos() 为准
+    ElementData m_record;
+    
+    // 标签文字可超出元件两侧的宽度
+    static constexpr qreal LabelOverhang = 20;
     
     QSizeF m_size;
-    QColor m_fillColor;
-    QColor m_borderColor;
-    QColor m_textColor;
     
-    // 选中状态
-    bool m_isSelected = false;
+    // 元件配色（所有元件共用，不逐个存储）
+    static QColor borderColor() { return QColor(0x00, 0x7A, 0xCC); }
+    static QColor textColor() { return QColor(0xE0, 0xE0, 0xE0); }
+    
+    // 仿真通电状态
+    bool m_energized = false;
+    
+    // 每个引脚上的连接线数量
+    quint16 m_pinConnections[PinTables::MaxPins] = {};
+    
+    // 变化监听者
+    ElementChangeListener* m_listener = nullptr;
     
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
     void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
     void hoverEnterEvent(QGraphicsSceneHoverEvent* event) override;
@@ -0,0 +1,215 @@
+#include "LadderModel.h"
+#include "LdJsonStream.h"
+#include "SceneSnapshot.h"
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <algorithm>
+
+namespace LadderDiagram {
+
+namespace {
+
+// 元件记录中由 ElementData 字段承载的键，其余键归入 parameters
+bool isCommonElementKey(const QString& key) {
+    static const QStringList keys = {"type", "id", "name", "address", "comment",
+                                     "x", "y", "properties"};
+    return keys.contains(key);
+}
+
+// 元件ID的保存顺序："E<n>" 按编号（E2 在 E10 之前），其它ID按字符串排在后面
+struct IdOrder {
+    bool numbered = false;
+    int number = 0;
+    QString id;
+
+    explicit IdOrder(const QString& elementId) : id(elementId) {
+        if (id.startsWith('E')) {
+            number = id.mid(1).toInt(&numbered);
+        }
+    }
+
+    bool operator<(const IdOrder& other) const {
+        if (numbered != other.numbered) return numbered;
+        if (numbered && number != other.number) return number < other.number;
+        return id < other.id;
+    }
+};
+
+class ModelJsonLoader : public LdJsonHandler {
+public:
+    explicit ModelJsonLoader(LadderModel& model) : m_model(model) {}
+
+    void element(const QMap<QString, QVariant>& record) override {
+        m_model.elements.append(ElementData::fromMap(record));
+    }
+
+    void connection(const QMap<QString, QVariant>& record) override {
+        m_model.connections.append(ConnectionData::fromMap(record));
+    }
+
+private:
+    LadderModel& m_model;
+};
+
+} // namespace
+
+QMap<QString, QVariant> ElementData::toMap() const {
+    QMap<QString, QVariant> map = parameters;
+    map["type"] = static_cast<int>(type);
+    if (!id.isEmpty()) map["id"] = id;
+    map["name"] = name;
+    map["address"] = address;
+    map["comment"] = comment;
+    map["x"] = position.x();
+    map["y"] = position.y();
+    map["properties"] = properties;
+    return map;
+}
+
+ElementData ElementData::fromMap(const QMap<QString, QVariant>& map) {
+    ElementData data;
+    data.type = static_cast<ElementType>(map.value("type").toInt());
+    data.id = map.value("id").toString();
+    data.name = map.value("name").toString();
+    data.address = map.value("address").toString();
+    data.comment = map.value("comment").toString();
+    data.position = QPointF(map.value("x").toReal(), map.value("y").toReal());
+    data.properties = map.value("properties").toMap();
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        if (!isCommonElementKey(it.key())) {
+            data.parameters.insert(it.key(), it.value());
+        }
+    }
+    return data;
+}
+
+QVariant ElementData::parameter(const QString& key, const QVariant& defaultValue) const {
+    auto it = parameters.constFind(key);
+    if (it != parameters.constEnd()) return it.value();
+    return properties.value(key, defaultValue);
+}
+
+QMap<QString, QVariant> ConnectionData::toMap() const {
+    QMap<QString, QVariant> map;
+    map["type"] = "connection_line";
+    map["start_x"] = startPoint.x();
+    map["start_y"] = startPoint.y();
+    map["end_x"] = endPoint.x();
+    map["end_y"] = endPoint.y();
+    if (!startElement.isEmpty()) {
+        map["start_element"] = startElement;
+        map["start_connection_index"] = startPin;
+    }
+    if (!endElement.isEmpty()) {
+        map["end_element"] = endElement;
+        map["end_connection_index"] = endPin;
+    }
+    return map;
+}
+
+ConnectionData ConnectionData::fromMap(const QMap<QString, QVariant>& map) {
+    ConnectionData data;
+    data.startElement = map.value("start_element").toString();
+    data.startPin = map.value("start_connection_index", -1).toInt();
+    data.endElement = map.value("end_element").toString();
+    data.endPin = map.value("end_connection_index", -1).toInt();
+    data.startPoint = QPointF(map.value("start_x").toReal(), map.value("start_y").toReal());
+    data.endPoint = QPointF(map.value("end_x").toReal(), map.value("end_y").toReal());
+    return data;
+}
+
+void LadderModel::clear() {
+    elements.clear();
+    connections.clear();
+}
+
+bool LadderModel::readJson(QIODevice* device, QString* errorString) {
+    clear();
+    ModelJsonLoader loader(*this);
+    LdJsonReader reader;
+    if (!reader.read(device, loader)) {
+        if (errorString) *errorString = reader.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool LadderModel::readJsonFile(const QString& filePath, QString* errorString) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return readJson(&file, errorString);
+}
+
+LadderModel LadderModel::fromSnapshot(const SceneSnapshot& snapshot) {
+    LadderModel model;
+    model.elements.reserve(snapshot.elements.size());
+    for (const auto& record : snapshot.elements) {
+        model.elements.append(ElementData::fromMap(record));
+    }
+    model.connections.reserve(snapshot.connections.size());
+    for (const auto& record : snapshot.connections) {
+        model.connections.append(ConnectionData::fromMap(record));
+    }
+    return model;
+}
+
+void LadderModel::sortForSave() {
+    QVector<QPair<IdOrder, int>> elementKeys;
+    elementKeys.reserve(elements.size());
+    for (int i = 0; i < elements.size(); ++i) {
+        elementKeys.append(qMakePair(IdOrder(elements[i].id), i));
+    }
+    std::sort(elementKeys.begin(), elementKeys.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    struct Key {
+        IdOrder start;
+        int startPin;
+        IdOrder end;
+        int endPin;
+        int index;
+    };
+    QVector<Key> connectionKeys;
+    connectionKeys.reserve(connections.size());
+    for (int i = 0; i < connections.size(); ++i) {
+        const ConnectionData& conn = connections[i];
+        connectionKeys.append(Key{IdOrder(conn.startElement), conn.startPin,
+                                  IdOrder(conn.endElement), conn.endPin, i});
+    }
+    std::stable_sort(connectionKeys.begin(), connectionKeys.end(), [](const Key& a, const Key& b) {
+        if (a.start < b.start || b.start < a.start) return a.start < b.start;
+        if (a.startPin != b.startPin) return a.startPin < b.startPin;
+        if (a.end < b.end || b.end < a.end) return a.end < b.end;
+        return a.endPin < b.endPin;
+    });
+
+    QList<ElementData> sortedElements;
+    sortedElements.reserve(elements.size());
+    for (const auto& key : elementKeys) sortedElements.append(elements[key.second]);
+    QList<ConnectionData> sortedConnections;
+    sortedConnections.reserve(connections.size());
+    for (const Key& key : connectionKeys) sortedConnections.append(connections[key.index]);
+
+    elements.swap(sortedElements);
+    connections.swap(sortedConnections);
+}
+
+SceneSnapshot LadderModel::toSnapshot() const {
+    SceneSnapshot snapshot;
+    snapshot.elements.reserve(elements.size());
+    for (const ElementData& element : elements) {
+        snapshot.elements.append(element.toMap());
+    }
+    snapshot.connections.reserve(connections.size());
+    for (const ConnectionData& connection : connections) {
+        snapshot.connections.append(connection.toMap());
+    }
+    return snapshot;
+}
+
+} // namespace LadderDiagram
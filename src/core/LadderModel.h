@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include "PinTables.h"
+
+class QIODevice;
+
+namespace LadderDiagram {
+
+struct SceneSnapshot;
+
+// 梯形图逻辑模型（只依赖 QtCore）
+//
+// 元件与连接线以值类型记录保存，不含任何图形状态；代码生成、仿真与
+// 命令行工具直接使用，不必构造 QGraphicsItem。界面中的元件图元只是
+// 持有一条 ElementData 的视图。
+
+// 元件记录
+struct ElementData {
+    ElementType type = ElementType::Unknown;
+    QString id;
+    QString name;
+    QString address;
+    QString comment;
+    QPointF position;
+    QMap<QString, QVariant> properties;     // 用户属性
+    QMap<QString, QVariant> parameters;     // 子类型参数（element_subtype、timer_type 等）
+
+    QSpan<const ConnectionPoint> pins() const { return PinTables::pins(type); }
+
+    // 子类型参数；早期文件把它们写在 properties 中，找不到时再查 properties
+    QVariant parameter(const QString& key, const QVariant& defaultValue = QVariant()) const;
+
+    // 与 .ldjson 元件记录互相转换
+    QMap<QString, QVariant> toMap() const;
+    static ElementData fromMap(const QMap<QString, QVariant>& map);
+};
+
+// 连接线记录（两端元件以ID引用）
+struct ConnectionData {
+    QString startElement;
+    int startPin = -1;
+    QString endElement;
+    int endPin = -1;
+    QPointF startPoint;
+    QPointF endPoint;
+
+    QMap<QString, QVariant> toMap() const;
+    static ConnectionData fromMap(const QMap<QString, QVariant>& map);
+};
+
+// 整个工程
+class LadderModel {
+public:
+    QList<ElementData> elements;
+    QList<ConnectionData> connections;
+
+    void clear();
+
+    // 流式读取 .ldjson
+    bool readJson(QIODevice* device, QString* errorString = nullptr);
+    bool readJsonFile(const QString& filePath, QString* errorString = nullptr);
+
+    // 按保存顺序排列：元件按ID编号（E2 在 E10 之前），连接线按两端元件ID与引脚。
+    // 场景注册表删除时与末尾交换，顺序不稳定，写文件前由此得到确定的顺序
+    void sortForSave();
+
+    // 与记录列表形式的快照互相转换
+    static LadderModel fromSnapshot(const SceneSnapshot& snapshot);
+    SceneSnapshot toSnapshot() const;
+};
+
+} // namespace LadderDiagram
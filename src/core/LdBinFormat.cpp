@@ -0,0 +1,292 @@
+#include "LdBinFormat.h"
+#include <cstring>
+#include <limits>
+
+namespace LadderDiagram {
+
+namespace {
+
+// toMap() 中由 ElementRecord 定长字段保存的键
+bool isRecordField(const QString& key) {
+    return key == QLatin1String("type") || key == QLatin1String("name")
+           || key == QLatin1String("address") || key == QLatin1String("comment")
+           || key == QLatin1String("x") || key == QLatin1String("y")
+           || key == QLatin1String("id") || key == QLatin1String("properties");
+}
+
+quint64 align8(quint64 value) {
+    return (value + 7) & ~quint64(7);
+}
+
+} // namespace
+
+// ===== LdBinWriter =====
+
+LdBin::StringRef LdBinWriter::addString(const QString& text) {
+    auto it = m_stringIndex.constFind(text);
+    if (it != m_stringIndex.constEnd()) return it.value();
+
+    const QByteArray utf8 = text.toUtf8();
+    LdBin::StringRef ref;
+    ref.offset = static_cast<quint32>(m_strings.size());
+    ref.length = static_cast<quint32>(utf8.size());
+    m_strings.append(utf8);
+    m_stringIndex.insert(text, ref);
+    return ref;
+}
+
+void LdBinWriter::addProperty(const QString& key, const QVariant& value,
+                              LdBin::PropertyRecord::Scope scope) {
+    LdBin::PropertyRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.key = addString(key);
+    record.scope = scope;
+
+    switch (value.typeId()) {
+        case QMetaType::Bool:
+            record.kind = LdBin::PropertyRecord::Bool;
+            record.intValue = value.toBool() ? 1 : 0;
+            break;
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+            record.kind = LdBin::PropertyRecord::Int;
+            record.intValue = value.toLongLong();
+            break;
+        case QMetaType::Double:
+        case QMetaType::Float:
+            record.kind = LdBin::PropertyRecord::Double;
+            record.doubleValue = value.toDouble();
+            break;
+        default:
+            record.kind = LdBin::PropertyRecord::String;
+            record.stringValue = addString(value.toString());
+            break;
+    }
+    m_properties.append(record);
+}
+
+int LdBinWriter::addElement(const QString& id, const QMap<QString, QVariant>& map) {
+    LdBin::ElementRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.type = static_cast<quint16>(map.value("type").toInt());
+    record.x = map.value("x").toDouble();
+    record.y = map.value("y").toDouble();
+    record.id = addString(id);
+    record.name = addString(map.value("name").toString());
+    record.address = addString(map.value("address").toString());
+    record.comment = addString(map.value("comment").toString());
+    record.firstProperty = static_cast<quint32>(m_properties.size());
+
+    const QMap<QString, QVariant> properties = map.value("properties").toMap();
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        addProperty(it.key(), it.value(), LdBin::PropertyRecord::Element);
+    }
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        if (!isRecordField(it.key())) {
+            addProperty(it.key(), it.value(), LdBin::PropertyRecord::Map);
+        }
+    }
+    record.propertyCount = static_cast<quint32>(m_properties.size()) - record.firstProperty;
+
+    m_elements.append(record);
+    return m_elements.size() - 1;
+}
+
+void LdBinWriter::addConnection(quint32 startElement, int startPin, quint32 endElement, int endPin,
+                                const QPointF& start, const QPointF& end) {
+    LdBin::ConnectionRecord record;
+    record.startElement = startElement;
+    record.endElement = endElement;
+    record.startPin = startPin;
+    record.endPin = endPin;
+    record.startX = start.x();
+    record.startY = start.y();
+    record.endX = end.x();
+    record.endY = end.y();
+    m_connections.append(record);
+}
+
+QByteArray LdBinWriter::finish() const {
+    LdBin::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LdBin::Magic, sizeof(header.magic));
+    header.version = LdBin::Version;
+    header.headerSize = sizeof(LdBin::FileHeader);
+    header.elementCount = static_cast<quint32>(m_elements.size());
+    header.propertyCount = static_cast<quint32>(m_properties.size());
+    header.connectionCount = static_cast<quint32>(m_connections.size());
+
+    header.elementsOffset = sizeof(LdBin::FileHeader);
+    header.propertiesOffset = align8(header.elementsOffset + quint64(m_elements.size()) * sizeof(LdBin::ElementRecord));
+    header.connectionsOffset = align8(header.propertiesOffset + quint64(m_properties.size()) * sizeof(LdBin::PropertyRecord));
+    header.stringsOffset = align8(header.connectionsOffset + quint64(m_connections.size()) * sizeof(LdBin::ConnectionRecord));
+    header.stringsSize = static_cast<quint64>(m_strings.size());
+
+    QByteArray data(qsizetype(header.stringsOffset + header.stringsSize), '\0');
+    char* out = data.data();
+    std::memcpy(out, &header, sizeof(header));
+    if (!m_elements.isEmpty()) {
+        std::memcpy(out + header.elementsOffset, m_elements.constData(),
+                    m_elements.size() * sizeof(LdBin::ElementRecord));
+    }
+    if (!m_properties.isEmpty()) {
+        std::memcpy(out + header.propertiesOffset, m_properties.constData(),
+                    m_properties.size() * sizeof(LdBin::PropertyRecord));
+    }
+    if (!m_connections.isEmpty()) {
+        std::memcpy(out + header.connectionsOffset, m_connections.constData(),
+                    m_connections.size() * sizeof(LdBin::ConnectionRecord));
+    }
+    if (!m_strings.isEmpty()) {
+        std::memcpy(out + header.stringsOffset, m_strings.constData(), m_strings.size());
+    }
+    return data;
+}
+
+// ===== LdBinReader =====
+
+LdBinReader::~LdBinReader() {
+    close();
+}
+
+void LdBinReader::close() {
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_header = nullptr;
+    m_elementRecords = nullptr;
+    m_propertyRecords = nullptr;
+    m_connectionRecords = nullptr;
+    m_strings = nullptr;
+}
+
+bool LdBinReader::fail(const QString& message) {
+    m_error = message;
+    m_header = nullptr;
+    return false;
+}
+
+bool LdBinReader::open(const QString& filePath) {
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(m_file.errorString());
+    }
+    m_mapped = m_file.map(0, m_file.size());
+    if (!m_mapped) {
+        return fail(m_file.errorString());
+    }
+    return openData(m_mapped, m_file.size());
+}
+
+bool LdBinReader::openData(const uchar* data, qint64 size) {
+    m_error.clear();
+    if (size < qint64(sizeof(LdBin::FileHeader))) {
+        return fail(QString("文件过短"));
+    }
+
+    const auto* header = reinterpret_cast<const LdBin::FileHeader*>(data);
+    if (std::memcmp(header->magic, LdBin::Magic, sizeof(header->magic)) != 0) {
+        return fail(QString("不是 .ldbin 文件"));
+    }
+    if (header->version != LdBin::Version || header->headerSize != sizeof(LdBin::FileHeader)) {
+        return fail(QString("不支持的 .ldbin 版本 %1").arg(header->version));
+    }
+
+    // 各段必须落在文件内且8字节对齐
+    auto sectionValid = [size](quint64 offset, quint64 count, quint64 recordSize) {
+        if (offset % 8 != 0 || offset > quint64(size)) return false;
+        return count <= (quint64(size) - offset) / recordSize;
+    };
+    if (!sectionValid(header->elementsOffset, header->elementCount, sizeof(LdBin::ElementRecord))
+        || !sectionValid(header->propertiesOffset, header->propertyCount, sizeof(LdBin::PropertyRecord))
+        || !sectionValid(header->connectionsOffset, header->connectionCount, sizeof(LdBin::ConnectionRecord))
+        || !sectionValid(header->stringsOffset, header->stringsSize, 1)) {
+        return fail(QString("文件结构损坏"));
+    }
+
+    m_header = header;
+    m_elementRecords = reinterpret_cast<const LdBin::ElementRecord*>(data + header->elementsOffset);
+    m_propertyRecords = reinterpret_cast<const LdBin::PropertyRecord*>(data + header->propertiesOffset);
+    m_connectionRecords = reinterpret_cast<const LdBin::ConnectionRecord*>(data + header->connectionsOffset);
+    m_strings = reinterpret_cast<const char*>(data + header->stringsOffset);
+
+    for (quint32 i = 0; i < header->elementCount; ++i) {
+        const LdBin::ElementRecord& record = m_elementRecords[i];
+        if (!validString(record.id) || !validString(record.name)
+            || !validString(record.address) || !validString(record.comment)
+            || record.firstProperty > header->propertyCount
+            || record.propertyCount > header->propertyCount - record.firstProperty) {
+            return fail(QString("元件记录 %1 损坏").arg(i));
+        }
+    }
+    for (quint32 i = 0; i < header->propertyCount; ++i) {
+        const LdBin::PropertyRecord& record = m_propertyRecords[i];
+        if (!validString(record.key)
+            || (record.kind == LdBin::PropertyRecord::String && !validString(record.stringValue))) {
+            return fail(QString("属性记录 %1 损坏").arg(i));
+        }
+    }
+    for (quint32 i = 0; i < header->connectionCount; ++i) {
+        const LdBin::ConnectionRecord& record = m_connectionRecords[i];
+        if ((record.startElement != LdBin::NoElement && record.startElement >= header->elementCount)
+            || (record.endElement != LdBin::NoElement && record.endElement >= header->elementCount)) {
+            return fail(QString("连接记录 %1 损坏").arg(i));
+        }
+    }
+    return true;
+}
+
+bool LdBinReader::validString(const LdBin::StringRef& ref) const {
+    return ref.offset <= m_header->stringsSize && ref.length <= m_header->stringsSize - ref.offset;
+}
+
+QMap<QString, QVariant> LdBinReader::elementMap(quint32 index) const {
+    const LdBin::ElementRecord& record = m_elementRecords[index];
+
+    QMap<QString, QVariant> map;
+    map.insert("type", int(record.type));
+    map.insert("id", text(record.id));
+    map.insert("name", text(record.name));
+    map.insert("address", text(record.address));
+    map.insert("comment", text(record.comment));
+    map.insert("x", record.x);
+    map.insert("y", record.y);
+
+    QMap<QString, QVariant> properties;
+    for (quint32 i = 0; i < record.propertyCount; ++i) {
+        const LdBin::PropertyRecord& property = m_propertyRecords[record.firstProperty + i];
+        QVariant value;
+        switch (property.kind) {
+            case LdBin::PropertyRecord::Bool: value = property.intValue != 0; break;
+            case LdBin::PropertyRecord::Double: value = property.doubleValue; break;
+            case LdBin::PropertyRecord::String: value = text(property.stringValue); break;
+            default:
+                if (property.intValue >= std::numeric_limits<int>::min()
+                    && property.intValue <= std::numeric_limits<int>::max()) {
+                    value = int(property.intValue);
+                } else {
+                    value = qlonglong(property.intValue);
+                }
+                break;
+        }
+        if (property.scope == LdBin::PropertyRecord::Element) {
+            properties.insert(text(property.key), value);
+        } else {
+            map.insert(text(property.key), value);
+        }
+    }
+    map.insert("properties", properties);
+    return map;
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QPointF>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+
+namespace LadderDiagram {
+
+// .ldbin 二进制工程格式
+//
+// 文件布局（小端，各段按8字节对齐）：
+//   FileHeader | ElementRecord[] | PropertyRecord[] | ConnectionRecord[] | 字符串表
+// 元件与连接线均为定长记录；名称、地址、注释、属性键与字符串属性值
+// 存放在字符串表中（UTF-8，相同字符串只存一份），记录中以 (偏移, 长度) 引用。
+// 连接线以元件表下标引用两端元件。读取时直接映射文件，字符串按需取视图。
+namespace LdBin {
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, ".ldbin records are mapped directly and require a little-endian host");
+
+constexpr char Magic[8] = {'L', 'D', 'B', 'I', 'N', '\r', '\n', '\x1a'};
+constexpr quint16 Version = 1;
+constexpr quint32 NoElement = 0xFFFFFFFFu;
+
+// 字符串表引用
+struct StringRef {
+    quint32 offset;
+    quint32 length;
+};
+
+struct FileHeader {
+    char magic[8];
+    quint16 version;
+    quint16 headerSize;
+    quint32 elementCount;
+    quint32 propertyCount;
+    quint32 connectionCount;
+    quint64 elementsOffset;
+    quint64 propertiesOffset;
+    quint64 connectionsOffset;
+    quint64 stringsOffset;
+    quint64 stringsSize;
+};
+
+struct ElementRecord {
+    quint16 type;               // ElementType
+    quint16 reserved;
+    quint32 firstProperty;      // 属性表下标
+    quint32 propertyCount;
+    quint32 reserved2;
+    double x;
+    double y;
+    StringRef id;
+    StringRef name;
+    StringRef address;
+    StringRef comment;
+};
+
+// 属性：Element 作用域对应元件 properties，Map 作用域对应 toMap() 的其它字段
+struct PropertyRecord {
+    enum Kind : quint8 { Int, Double, Bool, String };
+    enum Scope : quint8 { Element, Map };
+
+    StringRef key;
+    quint8 kind;
+    quint8 scope;
+    quint16 reserved;
+    quint32 reserved2;
+    union {
+        qint64 intValue;
+        double doubleValue;
+        StringRef stringValue;
+    };
+};
+
+struct ConnectionRecord {
+    quint32 startElement;       // 元件表下标，NoElement 表示未连接
+    quint32 endElement;
+    qint32 startPin;
+    qint32 endPin;
+    double startX;
+    double startY;
+    double endX;
+    double endY;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+static_assert(sizeof(ElementRecord) == 64, "ElementRecord layout");
+static_assert(sizeof(PropertyRecord) == 24, "PropertyRecord layout");
+static_assert(sizeof(ConnectionRecord) == 48, "ConnectionRecord layout");
+
+} // namespace LdBin
+
+// .ldbin 写入器
+class LdBinWriter {
+public:
+    // 添加元件（map 为元件 toMap() 的结果），返回元件表下标
+    int addElement(const QString& id, const QMap<QString, QVariant>& map);
+
+    // 添加连接线（元件以 addElement 返回的下标引用）
+    void addConnection(quint32 startElement, int startPin, quint32 endElement, int endPin,
+                       const QPointF& start, const QPointF& end);
+
+    // 生成文件内容
+    QByteArray finish() const;
+
+private:
+    LdBin::StringRef addString(const QString& text);
+    void addProperty(const QString& key, const QVariant& value, LdBin::PropertyRecord::Scope scope);
+
+    QVector<LdBin::ElementRecord> m_elements;
+    QVector<LdBin::PropertyRecord> m_properties;
+    QVector<LdBin::ConnectionRecord> m_connections;
+    QByteArray m_strings;
+    QHash<QString, LdBin::StringRef> m_stringIndex;
+};
+
+// .ldbin 读取器（文件以只读方式映射到内存）
+class LdBinReader {
+public:
+    LdBinReader() = default;
+    ~LdBinReader();
+
+    LdBinReader(const LdBinReader&) = delete;
+    LdBinReader& operator=(const LdBinReader&) = delete;
+
+    // 映射并校验文件
+    bool open(const QString& filePath);
+
+    // 校验内存中的数据（data 在读取期间必须保持有效）
+    bool openData(const uchar* data, qint64 size);
+
+    void close();
+    QString errorString() const { return m_error; }
+
+    quint32 elementCount() const { return m_header ? m_header->elementCount : 0; }
+    quint32 connectionCount() const { return m_header ? m_header->connectionCount : 0; }
+
+    const LdBin::ElementRecord& element(quint32 index) const { return m_elementRecords[index]; }
+    const LdBin::ConnectionRecord& connection(quint32 index) const { return m_connectionRecords[index]; }
+
+    // 字符串视图（直接指向映射内存）
+    QByteArrayView string(const LdBin::StringRef& ref) const {
+        return QByteArrayView(m_strings + ref.offset, ref.length);
+    }
+    QString text(const LdBin::StringRef& ref) const { return QString::fromUtf8(string(ref)); }
+
+    // 还原为元件 fromMap() 所需的字段
+    QMap<QString, QVariant> elementMap(quint32 index) const;
+
+private:
+    bool fail(const QString& message);
+    bool validString(const LdBin::StringRef& ref) const;
+
+    QFile m_file;
+    uchar* m_mapped = nullptr;
+    const LdBin::FileHeader* m_header = nullptr;
+    const LdBin::ElementRecord* m_elementRecords = nullptr;
+    const LdBin::PropertyRecord* m_propertyRecords = nullptr;
+    const LdBin::ConnectionRecord* m_connectionRecords = nullptr;
+    const char* m_strings = nullptr;
+    QString m_error;
+};
+
+} // namespace LadderDiagram
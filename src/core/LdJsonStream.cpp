@@ -0,0 +1,438 @@
+#include "LdJsonStream.h"
+#include <QtCore/QIODevice>
+#include <QtCore/QLocale>
+#include <QtCore/QtNumeric>
+#include <limits>
+
+namespace LadderDiagram {
+
+namespace {
+
+constexpr qint64 ChunkSize = 64 * 1024;
+constexpr int MaxDepth = 64;
+
+int hexValue(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+// ===== LdJsonReader =====
+
+bool LdJsonReader::fail(const QString& message) {
+    if (m_error.isEmpty()) {
+        m_error = QString("%1（偏移 %2）").arg(message).arg(m_consumed + m_pos);
+    }
+    return false;
+}
+
+bool LdJsonReader::fill() {
+    if (m_eof) return false;
+    m_consumed += m_buffer.size();
+    m_buffer = m_device->read(ChunkSize);
+    m_pos = 0;
+    if (m_buffer.isEmpty()) {
+        m_eof = true;
+        return false;
+    }
+    return true;
+}
+
+int LdJsonReader::peek() {
+    if (m_pos >= m_buffer.size() && !fill()) return -1;
+    return static_cast<uchar>(m_buffer.at(m_pos));
+}
+
+int LdJsonReader::get() {
+    int c = peek();
+    if (c >= 0) ++m_pos;
+    return c;
+}
+
+void LdJsonReader::skipWhitespace() {
+    for (;;) {
+        int c = peek();
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return;
+        ++m_pos;
+    }
+}
+
+bool LdJsonReader::expect(char c) {
+    skipWhitespace();
+    if (get() != c) return fail(QString("应为 '%1'").arg(QLatin1Char(c)));
+    return true;
+}
+
+bool LdJsonReader::parseString(QString& text) {
+    if (!expect('"')) return false;
+
+    QByteArray raw;
+    for (;;) {
+        // 快速路径：整段拷贝缓冲区中不含转义的部分
+        const qsizetype start = m_pos;
+        while (m_pos < m_buffer.size()) {
+            const char c = m_buffer.at(m_pos);
+            if (c == '"' || c == '\\' || static_cast<uchar>(c) < 0x20) break;
+            ++m_pos;
+        }
+        raw.append(m_buffer.constData() + start, m_pos - start);
+
+        int c = get();
+        if (c < 0) return fail(QString("字符串未结束"));
+        if (c == '"') break;
+        if (c < 0x20) return fail(QString("字符串中含有控制字符"));
+
+        // 转义
+        c = get();
+        switch (c) {
+            case '"': raw.append('"'); break;
+            case '\\': raw.append('\\'); break;
+            case '/': raw.append('/'); break;
+            case 'b': raw.append('\b'); break;
+            case 'f': raw.append('\f'); break;
+            case 'n': raw.append('\n'); break;
+            case 'r': raw.append('\r'); break;
+            case 't': raw.append('\t'); break;
+            case 'u': {
+                auto readUnit = [this](char16_t& unit) {
+                    int value = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        int digit = hexValue(get());
+                        if (digit < 0) return false;
+                        value = value * 16 + digit;
+                    }
+                    unit = static_cast<char16_t>(value);
+                    return true;
+                };
+                char16_t units[2];
+                int count = 1;
+                if (!readUnit(units[0])) return fail(QString("无效的 \\u 转义"));
+                if (QChar::isHighSurrogate(units[0]) && peek() == '\\') {
+                    ++m_pos;
+                    if (get() != 'u' || !readUnit(units[1])) return fail(QString("无效的 \\u 转义"));
+                    count = 2;
+                }
+                raw.append(QString(reinterpret_cast<const QChar*>(units), count).toUtf8());
+                break;
+            }
+            default:
+                return fail(QString("无效的转义字符"));
+        }
+    }
+
+    text = QString::fromUtf8(raw);
+    return true;
+}
+
+bool LdJsonReader::parseNumber(QVariant& value) {
+    QByteArray digits;
+    bool integral = true;
+    for (;;) {
+        int c = peek();
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+') {
+            digits.append(char(c));
+        } else if (c == '.' || c == 'e' || c == 'E') {
+            digits.append(char(c));
+            integral = false;
+        } else {
+            break;
+        }
+        ++m_pos;
+    }
+    if (digits.isEmpty()) return fail(QString("无效的值"));
+
+    bool ok = false;
+    if (integral) {
+        const qlonglong number = digits.toLongLong(&ok);
+        if (ok) {
+            if (number >= std::numeric_limits<int>::min() && number <= std::numeric_limits<int>::max()) {
+                value = int(number);
+            } else {
+                value = number;
+            }
+            return true;
+        }
+    }
+    const double number = digits.toDouble(&ok);
+    if (!ok) return fail(QString("无效的数字"));
+    value = number;
+    return true;
+}
+
+bool LdJsonReader::parseLiteral(const char* literal, const QVariant& value, QVariant& out) {
+    for (const char* p = literal; *p; ++p) {
+        if (get() != *p) return fail(QString("无效的值"));
+    }
+    out = value;
+    return true;
+}
+
+bool LdJsonReader::parseObject(QMap<QString, QVariant>& map, int depth) {
+    if (!expect('{')) return false;
+    skipWhitespace();
+    if (peek() == '}') {
+        ++m_pos;
+        return true;
+    }
+
+    for (;;) {
+        QString key;
+        if (!parseString(key) || !expect(':')) return false;
+        QVariant value;
+        if (!parseValue(value, depth + 1)) return false;
+        map.insert(key, value);
+
+        skipWhitespace();
+        int c = get();
+        if (c == '}') return true;
+        if (c != ',') return fail(QString("应为 ',' 或 '}'"));
+    }
+}
+
+bool LdJsonReader::parseArray(QVariantList& list, int depth) {
+    if (!expect('[')) return false;
+    skipWhitespace();
+    if (peek() == ']') {
+        ++m_pos;
+        return true;
+    }
+
+    for (;;) {
+        QVariant value;
+        if (!parseValue(value, depth + 1)) return false;
+        list.append(value);
+
+        skipWhitespace();
+        int c = get();
+        if (c == ']') return true;
+        if (c != ',') return fail(QString("应为 ',' 或 ']'"));
+    }
+}
+
+bool LdJsonReader::parseValue(QVariant& value, int depth) {
+    if (depth > MaxDepth) return fail(QString("嵌套层次过深"));
+
+    skipWhitespace();
+    switch (peek()) {
+        case '{': {
+            QMap<QString, QVariant> map;
+            if (!parseObject(map, depth)) return false;
+            value = map;
+            return true;
+        }
+        case '[': {
+            QVariantList list;
+            if (!parseArray(list, depth)) return false;
+            value = list;
+            return true;
+        }
+        case '"': {
+            QString text;
+            if (!parseString(text)) return false;
+            value = text;
+            return true;
+        }
+        case 't': return parseLiteral("true", true, value);
+        case 'f': return parseLiteral("false", false, value);
+        case 'n': return parseLiteral("null", QVariant(), value);
+        case -1: return fail(QString("意外的文件结尾"));
+        default: return parseNumber(value);
+    }
+}
+
+bool LdJsonReader::parseRecords(bool elements, LdJsonHandler& handler) {
+    if (!expect('[')) return false;
+    skipWhitespace();
+    if (peek() == ']') {
+        ++m_pos;
+        return true;
+    }
+
+    for (;;) {
+        QMap<QString, QVariant> record;
+        if (!parseObject(record, 1)) return false;
+        if (elements) handler.element(record);
+        else handler.connection(record);
+
+        skipWhitespace();
+        int c = get();
+        if (c == ']') return true;
+        if (c != ',') return fail(QString("应为 ',' 或 ']'"));
+    }
+}
+
+bool LdJsonReader::read(QIODevice* device, LdJsonHandler& handler) {
+    m_device = device;
+    m_buffer.clear();
+    m_pos = 0;
+    m_consumed = 0;
+    m_eof = false;
+    m_error.clear();
+
+    if (!expect('{')) return false;
+    skipWhitespace();
+    if (peek() == '}') {
+        ++m_pos;
+        return true;
+    }
+
+    for (;;) {
+        QString key;
+        if (!parseString(key) || !expect(':')) return false;
+
+        skipWhitespace();
+        const bool isElements = key == QLatin1String("elements");
+        if ((isElements || key == QLatin1String("connections")) && peek() == '[') {
+            if (!parseRecords(isElements, handler)) return false;
+        } else {
+            // 未知字段跳过
+            QVariant ignored;
+            if (!parseValue(ignored, 1)) return false;
+        }
+
+        skipWhitespace();
+        int c = get();
+        if (c == '}') return true;
+        if (c != ',') return fail(QString("应为 ',' 或 '}'"));
+    }
+}
+
+// ===== LdJsonWriter =====
+
+LdJsonWriter::LdJsonWriter(QIODevice* device)
+    : m_device(device)
+{
+    m_buffer.reserve(ChunkSize + 4096);
+}
+
+void LdJsonWriter::beginSection(const char* name) {
+    m_buffer.append(m_sections == 0 ? "{\n" : ",\n");
+    m_buffer.append("    \"");
+    m_buffer.append(name);
+    m_buffer.append("\": [");
+    m_recordsInSection = 0;
+    ++m_sections;
+}
+
+void LdJsonWriter::endSection() {
+    if (m_recordsInSection > 0) m_buffer.append("\n    ");
+    m_buffer.append(']');
+}
+
+void LdJsonWriter::writeRecord(const QMap<QString, QVariant>& record) {
+    m_buffer.append(m_recordsInSection > 0 ? ",\n        " : "\n        ");
+    writeValue(record);
+    ++m_recordsInSection;
+    flushIfNeeded();
+}
+
+bool LdJsonWriter::finish() {
+    if (m_sections == 0) m_buffer.append('{');
+    m_buffer.append("\n}\n");
+    if (!m_failed && m_device->write(m_buffer) != m_buffer.size()) {
+        m_failed = true;
+    }
+    m_buffer.clear();
+    return !m_failed;
+}
+
+void LdJsonWriter::flushIfNeeded() {
+    if (m_buffer.size() < ChunkSize) return;
+    if (!m_failed && m_device->write(m_buffer) != m_buffer.size()) {
+        m_failed = true;
+    }
+    m_buffer.clear();
+}
+
+void LdJsonWriter::writeString(const QString& text) {
+    static const char hex[] = "0123456789abcdef";
+    const QByteArray utf8 = text.toUtf8();
+
+    m_buffer.append('"');
+    for (const char c : utf8) {
+        switch (c) {
+            case '"': m_buffer.append("\\\""); break;
+            case '\\': m_buffer.append("\\\\"); break;
+            case '\n': m_buffer.append("\\n"); break;
+            case '\r': m_buffer.append("\\r"); break;
+            case '\t': m_buffer.append("\\t"); break;
+            case '\b': m_buffer.append("\\b"); break;
+            case '\f': m_buffer.append("\\f"); break;
+            default:
+                if (static_cast<uchar>(c) < 0x20) {
+                    m_buffer.append("\\u00");
+                    m_buffer.append(hex[(c >> 4) & 0xF]);
+                    m_buffer.append(hex[c & 0xF]);
+                } else {
+                    m_buffer.append(c);
+                }
+                break;
+        }
+    }
+    m_buffer.append('"');
+}
+
+void LdJsonWriter::writeValue(const QVariant& value) {
+    switch (value.typeId()) {
+        case QMetaType::UnknownType:
+        case QMetaType::Nullptr:
+            m_buffer.append("null");
+            break;
+        case QMetaType::Bool:
+            m_buffer.append(value.toBool() ? "true" : "false");
+            break;
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+            m_buffer.append(QByteArray::number(value.toLongLong()));
+            break;
+        case QMetaType::ULongLong:
+            m_buffer.append(QByteArray::number(value.toULongLong()));
+            break;
+        case QMetaType::Double:
+        case QMetaType::Float: {
+            const double number = value.toDouble();
+            if (qIsFinite(number)) {
+                m_buffer.append(QByteArray::number(number, 'g', QLocale::FloatingPointShortest));
+            } else {
+                m_buffer.append("null");
+            }
+            break;
+        }
+        case QMetaType::QVariantMap: {
+            const QVariantMap map = value.toMap();
+            m_buffer.append('{');
+            bool first = true;
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                if (!first) m_buffer.append(", ");
+                first = false;
+                writeString(it.key());
+                m_buffer.append(": ");
+                writeValue(it.value());
+            }
+            m_buffer.append('}');
+            break;
+        }
+        case QMetaType::QVariantList:
+        case QMetaType::QStringList: {
+            const QVariantList list = value.toList();
+            m_buffer.append('[');
+            for (int i = 0; i < list.size(); ++i) {
+                if (i > 0) m_buffer.append(", ");
+                writeValue(list.at(i));
+            }
+            m_buffer.append(']');
+            break;
+        }
+        default:
+            writeString(value.toString());
+            break;
+    }
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QVariant>
+
+class QIODevice;
+
+namespace LadderDiagram {
+
+// .ldjson 流式读写
+//
+// 文件结构为 {"elements": [记录...], "connections": [记录...]}。
+// 读取时按块从设备读入，每解析完一条记录立即回调，内存占用只与单条记录
+// 大小有关；写入时逐条记录直接写到设备。
+
+// 记录回调（由场景实现）
+class LdJsonHandler {
+public:
+    virtual ~LdJsonHandler() = default;
+
+    virtual void element(const QMap<QString, QVariant>& record) = 0;
+    virtual void connection(const QMap<QString, QVariant>& record) = 0;
+};
+
+// 流式读取器
+class LdJsonReader {
+public:
+    bool read(QIODevice* device, LdJsonHandler& handler);
+    QString errorString() const { return m_error; }
+
+private:
+    bool fill();
+    int peek();
+    int get();
+    void skipWhitespace();
+    bool expect(char c);
+    bool fail(const QString& message);
+
+    bool parseValue(QVariant& value, int depth);
+    bool parseString(QString& text);
+    bool parseNumber(QVariant& value);
+    bool parseLiteral(const char* literal, const QVariant& value, QVariant& out);
+    bool parseObject(QMap<QString, QVariant>& map, int depth);
+    bool parseArray(QVariantList& list, int depth);
+    bool parseRecords(bool elements, LdJsonHandler& handler);
+
+    QIODevice* m_device = nullptr;
+    QByteArray m_buffer;
+    qsizetype m_pos = 0;
+    qint64 m_consumed = 0;      // 已丢弃的字节数（用于错误位置）
+    bool m_eof = false;
+    QString m_error;
+};
+
+// 流式写入器
+class LdJsonWriter {
+public:
+    explicit LdJsonWriter(QIODevice* device);
+
+    // 开始/结束一个顶层数组（"elements" 或 "connections"）
+    void beginSection(const char* name);
+    void endSection();
+
+    // 写一条记录
+    void writeRecord(const QMap<QString, QVariant>& record);
+
+    // 结束文档并刷新缓冲；写入失败时返回 false
+    bool finish();
+
+private:
+    void writeValue(const QVariant& value);
+    void writeString(const QString& text);
+    void flushIfNeeded();
+
+    QIODevice* m_device;
+    QByteArray m_buffer;
+    int m_sections = 0;
+    int m_recordsInSection = 0;
+    bool m_failed = false;
+};
+
+} // namespace LadderDiagram
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <QtCore/QPointF>
+#include <QtCore/QSpan>
+#include "ElementTypes.h"
+
+namespace LadderDiagram {
+
+// 连接点（引脚）描述：元件局部坐标、类型与名称
+struct ConnectionPoint {
+    QPointF position;
+    ConnectionType type;
+    const char* name;
+};
+
+// 各类元件的引脚布局表（编译期常量）
+//
+// 元件尺寸在构造时固定，引脚位置可以直接写成常量；引脚的顺序即连接线
+// 保存的 connection_index，也是代码生成中 PowerFlowGraph 的引脚编号。
+// 引脚是否已连线由元件自己记录（LadderElement::isPinConnected）。
+namespace PinTables {
+
+// 触点、线圈（50x35）
+inline constexpr ConnectionPoint InOut[] = {
+    {QPointF(-25, 0), ConnectionType::PowerIn, "IN"},
+    {QPointF(25, 0), ConnectionType::PowerOut, "OUT"},
+};
+
+// 左电源轨（20x200）
+inline constexpr ConnectionPoint LeftRail[] = {
+    {QPointF(10, -80), ConnectionType::PowerOut, "OUT_0"},
+    {QPointF(10, -60), ConnectionType::PowerOut, "OUT_1"},
+    {QPointF(10, -40), ConnectionType::PowerOut, "OUT_2"},
+    {QPointF(10, -20), ConnectionType::PowerOut, "OUT_3"},
+    {QPointF(10, 0), ConnectionType::PowerOut, "OUT_4"},
+    {QPointF(10, 20), ConnectionType::PowerOut, "OUT_5"},
+    {QPointF(10, 40), ConnectionType::PowerOut, "OUT_6"},
+    {QPointF(10, 60), ConnectionType::PowerOut, "OUT_7"},
+    {QPointF(10, 80), ConnectionType::PowerOut, "OUT_8"},
+};
+
+// 右电源轨（20x200）
+inline constexpr ConnectionPoint RightRail[] = {
+    {QPointF(-10, -80), ConnectionType::PowerIn, "IN_0"},
+    {QPointF(-10, -60), ConnectionType::PowerIn, "IN_1"},
+    {QPointF(-10, -40), ConnectionType::PowerIn, "IN_2"},
+    {QPointF(-10, -20), ConnectionType::PowerIn, "IN_3"},
+    {QPointF(-10, 0), ConnectionType::PowerIn, "IN_4"},
+    {QPointF(-10, 20), ConnectionType::PowerIn, "IN_5"},
+    {QPointF(-10, 40), ConnectionType::PowerIn, "IN_6"},
+    {QPointF(-10, 60), ConnectionType::PowerIn, "IN_7"},
+    {QPointF(-10, 80), ConnectionType::PowerIn, "IN_8"},
+};
+
+// 定时器（60x40）
+inline constexpr ConnectionPoint Timer[] = {
+    {QPointF(-30, -10), ConnectionType::PowerIn, "IN"},
+    {QPointF(30, -10), ConnectionType::PowerOut, "OUT"},
+    {QPointF(-30, 10), ConnectionType::Input, "RESET"},
+};
+
+// 计数器（60x40）
+inline constexpr ConnectionPoint Counter[] = {
+    {QPointF(-30, -10), ConnectionType::PowerIn, "CU"},
+    {QPointF(-30, 10), ConnectionType::Input, "CD"},
+    {QPointF(0, 20), ConnectionType::Input, "RESET"},
+    {QPointF(30, 0), ConnectionType::PowerOut, "OUT"},
+};
+
+// 边沿检测功能块（70x50）
+inline constexpr ConnectionPoint Trigger[] = {
+    {QPointF(-35, -10), ConnectionType::PowerIn, "CLK"},
+    {QPointF(35, -10), ConnectionType::PowerOut, "Q"},
+};
+
+// RS / SR 触发器（70x60）
+inline constexpr ConnectionPoint Bistable[] = {
+    {QPointF(-35, -15), ConnectionType::PowerIn, "S"},
+    {QPointF(-35, 15), ConnectionType::Input, "R"},
+    {QPointF(35, 0), ConnectionType::PowerOut, "Q"},
+};
+
+// 比较指令（70x50）
+inline constexpr ConnectionPoint Comparison[] = {
+    {QPointF(-35, -10), ConnectionType::PowerIn, "IN"},
+    {QPointF(35, -10), ConnectionType::PowerOut, "OUT"},
+};
+
+// 数学运算（70x60）
+inline constexpr ConnectionPoint MathOperation[] = {
+    {QPointF(-35, -15), ConnectionType::PowerIn, "IN1"},
+    {QPointF(-35, 15), ConnectionType::Input, "IN2"},
+    {QPointF(35, 0), ConnectionType::PowerOut, "OUT"},
+};
+
+// 逻辑与/或（60x50）
+inline constexpr ConnectionPoint LogicGate[] = {
+    {QPointF(-30, -10), ConnectionType::PowerIn, "IN1"},
+    {QPointF(-30, 10), ConnectionType::Input, "IN2"},
+    {QPointF(30, 0), ConnectionType::PowerOut, "OUT"},
+};
+
+// 逻辑非（50x40）
+inline constexpr ConnectionPoint LogicNOT[] = {
+    {QPointF(-25, 0), ConnectionType::PowerIn, "IN"},
+    {QPointF(25, 0), ConnectionType::PowerOut, "OUT"},
+};
+
+// 跳转、返回（60x40）
+inline constexpr ConnectionPoint ControlIn[] = {
+    {QPointF(-30, 0), ConnectionType::PowerIn, "IN"},
+};
+
+// 单个元件的最大引脚数
+inline constexpr int MaxPins = 9;
+
+// 按元件类型取引脚表（标签等无引脚的元件返回空表）
+constexpr QSpan<const ConnectionPoint> pins(ElementType type) {
+    switch (type) {
+        case ElementType::LeftPowerRail: return LeftRail;
+        case ElementType::RightPowerRail: return RightRail;
+        case ElementType::NormallyOpen:
+        case ElementType::NormallyClosed:
+        case ElementType::PositiveEdge:
+        case ElementType::NegativeEdge:
+        case ElementType::OutputCoil:
+        case ElementType::InvertedCoil:
+        case ElementType::SetCoil:
+        case ElementType::ResetCoil:
+        case ElementType::PositiveEdgeCoil:
+        case ElementType::NegativeEdgeCoil:
+            return InOut;
+        case ElementType::Timer:
+        case ElementType::TimerTOF:
+        case ElementType::TimerTP:
+            return Timer;
+        case ElementType::Counter:
+        case ElementType::CounterCTD:
+        case ElementType::CounterCTUD:
+            return Counter;
+        case ElementType::RTrig:
+        case ElementType::FTrig:
+            return Trigger;
+        case ElementType::RS:
+        case ElementType::SR:
+            return Bistable;
+        case ElementType::Comparison: return Comparison;
+        case ElementType::MathOperation: return MathOperation;
+        case ElementType::LogicAND:
+        case ElementType::LogicOR:
+            return LogicGate;
+        case ElementType::LogicNOT: return LogicNOT;
+        case ElementType::Jump:
+        case ElementType::Return:
+            return ControlIn;
+        default:
+            return {};
+    }
+}
+
+} // namespace PinTables
+
+} // namespace LadderDiagram
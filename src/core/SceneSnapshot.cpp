@@ -0,0 +1,53 @@
+#include "SceneSnapshot.h"
+#include "LdBinFormat.h"
+#include "LdJsonStream.h"
+#include <QtCore/QHash>
+
+namespace LadderDiagram {
+
+bool SceneSnapshot::writeJson(QIODevice* device) const {
+    LdJsonWriter writer(device);
+
+    writer.beginSection("elements");
+    for (const auto& record : elements) {
+        writer.writeRecord(record);
+    }
+    writer.endSection();
+
+    writer.beginSection("connections");
+    for (const auto& record : connections) {
+        writer.writeRecord(record);
+    }
+    writer.endSection();
+
+    return writer.finish();
+}
+
+QByteArray SceneSnapshot::toBinary() const {
+    LdBinWriter writer;
+
+    // 元件ID -> 元件表下标
+    QHash<QString, quint32> indexOf;
+    indexOf.reserve(elements.size());
+    for (const auto& record : elements) {
+        const QString id = record.value("id").toString();
+        indexOf.insert(id, writer.addElement(id, record));
+    }
+
+    auto elementIndex = [&indexOf](const QVariant& id) {
+        return id.isValid() ? indexOf.value(id.toString(), LdBin::NoElement) : LdBin::NoElement;
+    };
+
+    for (const auto& record : connections) {
+        writer.addConnection(elementIndex(record.value("start_element")),
+                             record.value("start_connection_index").toInt(),
+                             elementIndex(record.value("end_element")),
+                             record.value("end_connection_index").toInt(),
+                             QPointF(record.value("start_x").toReal(), record.value("start_y").toReal()),
+                             QPointF(record.value("end_x").toReal(), record.value("end_y").toReal()));
+    }
+
+    return writer.finish();
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+class QIODevice;
+
+namespace LadderDiagram {
+
+// 场景模型快照
+//
+// 即 .ldjson 形式的记录列表：元件记录为 ElementData::toMap()（含 "id"），
+// 连接线记录中的端点元件以ID表示。保存时由 LadderModel::toSnapshot() 在
+// 工作线程上生成；剪贴板使用 LadderScene::selectionSnapshot()。
+struct SceneSnapshot {
+    QList<QMap<QString, QVariant>> elements;
+    QList<QMap<QString, QVariant>> connections;
+
+    // 写为 .ldjson（逐条记录流式写入）
+    bool writeJson(QIODevice* device) const;
+
+    // 生成 .ldbin 文件内容
+    QByteArray toBinary() const;
+};
+
+} // namespace LadderDiagram
@@ -1,6 +1,7 @@
 #include "ConnectionLine.h"
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
+#include <QStyleOptionGraphicsItem>
 
 namespace LadderDiagram {
 
@@ -8,16 +9,65 @@ ConnectionLine::ConnectionLine(QGraphicsItem* parent)
     : QGraphicsItem(parent) {
     setFlag(QGraphicsItem::ItemIsSelectable);
     setZValue(-1);  // 确保线在元件下方
+    rebuildGeometry();
 }
 
 void ConnectionLine::setStartPoint(const QPointF& point) {
-    m_startPoint = point;
-    update();
+    setEndpoints(point, m_endPoint);
 }
 
 void ConnectionLine::setEndPoint(const QPointF& point) {
-    m_endPoint = point;
-    update();
+    setEndpoints(m_startPoint, point);
+}
+
+void ConnectionLine::setEndpoints(const QPointF& start, const QPointF& end) {
+    if (start == m_startPoint && end == m_endPoint) return;
+    
+    // 边界将改变：先通知场景更新索引并重绘旧区域
+    prepareGeometryChange();
+    m_startPoint = start;
+    m_endPoint = end;
+    m_route.clear();
+    m_corridor = QRectF();
+    rebuildGeometry();
+}
+
+void ConnectionLine::setRoute(const QPolygonF& route, const QRectF& corridor) {
+    m_corridor = corridor;
+    if (route == m_route) return;
+    
+    prepareGeometryChange();
+    m_route = route;
+    rebuildGeometry();
+}
+
+void ConnectionLine::rebuildGeometry() {
+    m_path = QPainterPath();
+    
+    if (m_route.size() >= 2) {
+        m_path.addPolygon(m_route);
+    } else {
+        m_path.moveTo(m_startPoint);
+        
+        // 计算中点，创建直角连接线
+        qreal midX = (m_startPoint.x() + m_endPoint.x()) / 2;
+        
+        if (qAbs(m_startPoint.x() - m_endPoint.x()) < 10) {
+            // 直接垂直连接
+            m_path.lineTo(m_endPoint);
+        } else {
+            // 使用直角连接
+            m_path.lineTo(midX, m_startPoint.y());
+            m_path.lineTo(midX, m_endPoint.y());
+            m_path.lineTo(m_endPoint);
+        }
+    }
+    
+    m_bounds = m_path.boundingRect().adjusted(-5, -5, 5, 5);
+    
+    // 命中测试用的描边形状在首次需要时再生成
+    m_shape = QPainterPath();
+    m_shapeValid = false;
 }
 
 void ConnectionLine::setStartElement(LadderElement* element, int connectionIndex) {
@@ -33,32 +83,30 @@ void ConnectionLine::setEndElement(LadderElement* element, int connectionIndex)
 }
 
 void ConnectionLine::updateConnection() {
+    QPointF start = m_startPoint;
+    QPointF end = m_endPoint;
+    
     if (m_startElement) {
-        auto points = m_startElement->connectionPoints();
-        if (m_startConnectionIndex >= 0 && m_startConnectionIndex < points.size()) {
+        const auto points = m_startElement->connectionPoints();
+        if (m_startConnectionIndex >= 0 && m_startConnectionIndex < int(points.size())) {
             QPointF localPos = points[m_startConnectionIndex].position;
-            m_startPoint = m_startElement->mapToScene(localPos);
+            start = m_startElement->mapToScene(localPos);
         }
     }
     
     if (m_endElement) {
-        auto points = m_endElement->connectionPoints();
-        if (m_endConnectionIndex >= 0 && m_endConnectionIndex < points.size()) {
+        const auto points = m_endElement->connectionPoints();
+        if (m_endConnectionIndex >= 0 && m_endConnectionIndex < int(points.size())) {
             QPointF localPos = points[m_endConnectionIndex].position;
-            m_endPoint = m_endElement->mapToScene(localPos);
+            end = m_endElement->mapToScene(localPos);
         }
     }
     
-    update();
+    setEndpoints(start, end);
 }
 
 QRectF ConnectionLine::boundingRect() const {
-    qreal minX = qMin(m_startPoint.x(), m_endPoint.x());
-    qreal minY = qMin(m_startPoint.y(), m_endPoint.y());
-    qreal maxX = qMax(m_startPoint.x(), m_endPoint.x());
-    qreal maxY = qMax(m_startPoint.y(), m_endPoint.y());
-    
-    return QRectF(minX - 5, minY - 5, maxX - minX + 10, maxY - minY + 10);
+    return m_bounds;
 }
 
 void ConnectionLine::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
@@ -66,13 +114,22 @@ void ConnectionLine::paint(QPainter* painter, const QStyleOptionGraphicsItem* op
     Q_UNUSED(option)
     Q_UNUSED(widget)
     
+    // 缩小后画成不抗锯齿的单像素线
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if (detailLevelFor(lod) != DetailLevel::Full) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(QPen(isSelected() ? QColor(Qt::blue) : m_color, 0));
+        painter->drawPath(m_path);
+        return;
+    }
+    
     painter->setRenderHint(QPainter::Antialiasing);
     
     // 绘制选中效果
     if (isSelected()) {
         QPen pen(Qt::blue, m_width + 2, Qt::DashLine);
         painter->setPen(pen);
-        painter->drawPath(createPath());
+        painter->drawPath(m_path);
     }
     
     // 绘制连接线
@@ -80,33 +137,17 @@ void ConnectionLine::paint(QPainter* painter, const QStyleOptionGraphicsItem* op
     pen.setCapStyle(Qt::RoundCap);
     pen.setJoinStyle(Qt::RoundJoin);
     painter->setPen(pen);
-    painter->drawPath(createPath());
+    painter->drawPath(m_path);
 }
 
 QPainterPath ConnectionLine::shape() const {
-    QPainterPathStroker stroker;
-    stroker.setWidth(8);
-    return stroker.createStroke(createPath());
-}
-
-QPainterPath ConnectionLine::createPath() const {
-    QPainterPath path;
-    path.moveTo(m_startPoint);
-    
-    // 计算中点，创建直角连接线
-    qreal midX = (m_startPoint.x() + m_endPoint.x()) / 2;
-    
-    if (qAbs(m_startPoint.x() - m_endPoint.x()) < 10) {
-        // 直接垂直连接
-        path.lineTo(m_endPoint);
-    } else {
-        // 使用直角连接
-        path.lineTo(midX, m_startPoint.y());
-        path.lineTo(midX, m_endPoint.y());
-        path.lineTo(m_endPoint);
+    if (!m_shapeValid) {
+        QPainterPathStroker stroker;
+        stroker.setWidth(8);
+        m_shape = stroker.createStroke(m_path);
+        m_shapeValid = true;
     }
-    
-    return path;
+    return m_shape;
 }
 
 QMap<QString, QVariant> ConnectionLine::toMap() const {
@@ -118,13 +159,9 @@ QMap<QString, QVariant> ConnectionLine::toMap() const {
     map["end_y"] = m_endPoint.y();
     
     if (m_startElement) {
-        // 这里需要存储元素的标识符，实际实现中应该使用唯一ID
-        map["start_element"] = m_startElement->name();
         map["start_connection_index"] = m_startConnectionIndex;
     }
-    
     if (m_endElement) {
-        map["end_element"] = m_endElement->name();
         map["end_connection_index"] = m_endConnectionIndex;
     }
     
@@ -132,8 +169,8 @@ QMap<QString, QVariant> ConnectionLine::toMap() const {
 }
 
 void ConnectionLine::fromMap(const QMap<QString, QVariant>& map) {
-    m_startPoint = QPointF(map["start_x"].toReal(), map["start_y"].toReal());
-    m_endPoint = QPointF(map["end_x"].toReal(), map["end_y"].toReal());
+    setEndpoints(QPointF(map["start_x"].toReal(), map["start_y"].toReal()),
+                 QPointF(map["end_x"].toReal(), map["end_y"].toReal()));
     // 元素连接需要在加载后重新建立
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../core/LadderElement.h"
+#include <QPainterPath>
+#include <QPolygonF>
 
 namespace LadderDiagram {
 
@@ -23,16 +25,23 @@ public:
     int startConnectionIndex() const { return m_startConnectionIndex; }
     int endConnectionIndex() const { return m_endConnectionIndex; }
     
-    // 更新连接位置
+    // 更新连接位置（端点变化后原布线路径失效，退回直角折线）
     void updateConnection();
     
+    // 自动布线结果：从起点到终点的正交折线及其布线走廊；
+    // 空路径表示使用默认的中点直角折线
+    void setRoute(const QPolygonF& route, const QRectF& corridor);
+    QPolygonF route() const { return m_route; }
+    QRectF corridor() const { return m_corridor; }
+    bool isRouted() const { return !m_corridor.isNull(); }
+    
     QRectF boundingRect() const override;
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, 
                QWidget* widget = nullptr) override;
     
     QPainterPath shape() const override;
     
-    // 序列化
+    // 序列化（端点坐标与引脚序号；端点元件ID由场景补充，见 LadderScene::connectionRecord）
     QMap<QString, QVariant> toMap() const;
     void fromMap(const QMap<QString, QVariant>& map);
     
@@ -52,7 +61,18 @@ private:
     int m_width = 2;
     bool m_isSelected = false;
     
-    QPainterPath createPath() const;
+    // 布线缓存：走廊内的障碍变化或端点移动前一直有效
+    QPolygonF m_route;
+    QRectF m_corridor;
+    
+    // 缓存的几何：路径与边界在端点变化时重建，描边形状按需生成
+    QPainterPath m_path;
+    QRectF m_bounds;
+    mutable QPainterPath m_shape;
+    mutable bool m_shapeValid = false;
+    
+    void setEndpoints(const QPointF& start, const QPointF& end);
+    void rebuildGeometry();
 };
 
 } // namespace LadderDiagram
@@ -7,18 +7,12 @@ namespace LadderDiagram {
 NormallyOpenContact::NormallyOpenContact(QGraphicsItem* parent)
     : LadderElement(ElementType::NormallyOpen, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "X0";
-}
-
-QList<ConnectionPoint> NormallyOpenContact::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "X0";
+    setParameter("element_subtype", "normally_open");
 }
 
 void NormallyOpenContact::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -15, 0);
@@ -34,12 +28,6 @@ void NormallyOpenContact::drawElement(QPainter* painter) {
     // painter->drawLine(-15, 15, 15, -15);
 }
 
-QMap<QString, QVariant> NormallyOpenContact::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "normally_open";
-    return map;
-}
-
 void NormallyOpenContact::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -54,18 +42,12 @@ LadderElement* NormallyOpenContact::clone() const {
 NormallyClosedContact::NormallyClosedContact(QGraphicsItem* parent)
     : LadderElement(ElementType::NormallyClosed, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "X0";
-}
-
-QList<ConnectionPoint> NormallyClosedContact::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "X0";
+    setParameter("element_subtype", "normally_closed");
 }
 
 void NormallyClosedContact::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -15, 0);
@@ -81,12 +63,6 @@ void NormallyClosedContact::drawElement(QPainter* painter) {
     painter->drawLine(-10, 10, 10, -3);
 }
 
-QMap<QString, QVariant> NormallyClosedContact::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "normally_closed";
-    return map;
-}
-
 void NormallyClosedContact::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -101,18 +77,12 @@ LadderElement* NormallyClosedContact::clone() const {
 OutputCoil::OutputCoil(QGraphicsItem* parent)
     : LadderElement(ElementType::OutputCoil, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "Y0";
-}
-
-QList<ConnectionPoint> OutputCoil::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "Y0";
+    setParameter("element_subtype", "output_coil");
 }
 
 void OutputCoil::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -20, 0);
@@ -124,12 +94,6 @@ void OutputCoil::drawElement(QPainter* painter) {
     painter->drawEllipse(-20, -15, 40, 30);
 }
 
-QMap<QString, QVariant> OutputCoil::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "output_coil";
-    return map;
-}
-
 void OutputCoil::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -144,18 +108,12 @@ LadderElement* OutputCoil::clone() const {
 SetCoil::SetCoil(QGraphicsItem* parent)
     : LadderElement(ElementType::SetCoil, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "Y0";
-}
-
-QList<ConnectionPoint> SetCoil::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "Y0";
+    setParameter("element_subtype", "set_coil");
 }
 
 void SetCoil::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -20, 0);
@@ -167,7 +125,7 @@ void SetCoil::drawElement(QPainter* painter) {
     painter->drawEllipse(-20, -15, 40, 30);
     
     // 绘制S字符
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     QFont font = painter->font();
     font.setBold(true);
     font.setPointSize(14);
@@ -175,12 +133,6 @@ void SetCoil::drawElement(QPainter* painter) {
     painter->drawText(-6, 6, "S");
 }
 
-QMap<QString, QVariant> SetCoil::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "set_coil";
-    return map;
-}
-
 void SetCoil::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -195,18 +147,12 @@ LadderElement* SetCoil::clone() const {
 ResetCoil::ResetCoil(QGraphicsItem* parent)
     : LadderElement(ElementType::ResetCoil, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "Y0";
-}
-
-QList<ConnectionPoint> ResetCoil::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "Y0";
+    setParameter("element_subtype", "reset_coil");
 }
 
 void ResetCoil::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -20, 0);
@@ -218,7 +164,7 @@ void ResetCoil::drawElement(QPainter* painter) {
     painter->drawEllipse(-20, -15, 40, 30);
     
     // 绘制R字符
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     QFont font = painter->font();
     font.setBold(true);
     font.setPointSize(14);
@@ -226,12 +172,6 @@ void ResetCoil::drawElement(QPainter* painter) {
     painter->drawText(-6, 6, "R");
 }
 
-QMap<QString, QVariant> ResetCoil::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "reset_coil";
-    return map;
-}
-
 void ResetCoil::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -246,18 +186,12 @@ LadderElement* ResetCoil::clone() const {
 PositiveEdgeContact::PositiveEdgeContact(QGraphicsItem* parent)
     : LadderElement(ElementType::PositiveEdge, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "X0";
-}
-
-QList<ConnectionPoint> PositiveEdgeContact::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "X0";
+    setParameter("element_subtype", "positive_edge");
 }
 
 void PositiveEdgeContact::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -15, 0);
@@ -281,12 +215,6 @@ void PositiveEdgeContact::drawElement(QPainter* painter) {
     painter->drawLine(0, -23, 5, -18);
 }
 
-QMap<QString, QVariant> PositiveEdgeContact::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "positive_edge";
-    return map;
-}
-
 void PositiveEdgeContact::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -301,18 +229,12 @@ LadderElement* PositiveEdgeContact::clone() const {
 NegativeEdgeContact::NegativeEdgeContact(QGraphicsItem* parent)
     : LadderElement(ElementType::NegativeEdge, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "X0";
-}
-
-QList<ConnectionPoint> NegativeEdgeContact::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "X0";
+    setParameter("element_subtype", "negative_edge");
 }
 
 void NegativeEdgeContact::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -15, 0);
@@ -336,12 +258,6 @@ void NegativeEdgeContact::drawElement(QPainter* painter) {
     painter->drawLine(0, -13, 5, -18);
 }
 
-QMap<QString, QVariant> NegativeEdgeContact::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "negative_edge";
-    return map;
-}
-
 void NegativeEdgeContact::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -356,18 +272,12 @@ LadderElement* NegativeEdgeContact::clone() const {
 InvertedCoil::InvertedCoil(QGraphicsItem* parent)
     : LadderElement(ElementType::InvertedCoil, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "Y0";
-}
-
-QList<ConnectionPoint> InvertedCoil::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "Y0";
+    setParameter("element_subtype", "inverted_coil");
 }
 
 void InvertedCoil::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -20, 0);
@@ -382,12 +292,6 @@ void InvertedCoil::drawElement(QPainter* painter) {
     painter->drawLine(-10, -8, 10, 8);
 }
 
-QMap<QString, QVariant> InvertedCoil::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "inverted_coil";
-    return map;
-}
-
 void InvertedCoil::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -402,18 +306,12 @@ LadderElement* InvertedCoil::clone() const {
 PositiveEdgeCoil::PositiveEdgeCoil(QGraphicsItem* parent)
     : LadderElement(ElementType::PositiveEdgeCoil, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "Y0";
-}
-
-QList<ConnectionPoint> PositiveEdgeCoil::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "Y0";
+    setParameter("element_subtype", "positive_edge_coil");
 }
 
 void PositiveEdgeCoil::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -20, 0);
@@ -436,12 +334,6 @@ void PositiveEdgeCoil::drawElement(QPainter* painter) {
     painter->drawLine(17, -15, 22, -10);
 }
 
-QMap<QString, QVariant> PositiveEdgeCoil::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "positive_edge_coil";
-    return map;
-}
-
 void PositiveEdgeCoil::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -456,18 +348,12 @@ LadderElement* PositiveEdgeCoil::clone() const {
 NegativeEdgeCoil::NegativeEdgeCoil(QGraphicsItem* parent)
     : LadderElement(ElementType::NegativeEdgeCoil, parent) {
     m_size = QSizeF(50, 35);
-    m_name = "Y0";
-}
-
-QList<ConnectionPoint> NegativeEdgeCoil::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "Y0";
+    setParameter("element_subtype", "negative_edge_coil");
 }
 
 void NegativeEdgeCoil::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制左连接线
     painter->drawLine(-m_size.width() / 2, 0, -20, 0);
@@ -490,12 +376,6 @@ void NegativeEdgeCoil::drawElement(QPainter* painter) {
     painter->drawLine(17, -5, 22, -10);
 }
 
-QMap<QString, QVariant> NegativeEdgeCoil::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "negative_edge_coil";
-    return map;
-}
-
 void NegativeEdgeCoil::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -510,20 +390,8 @@ LadderElement* NegativeEdgeCoil::clone() const {
 LeftPowerRail::LeftPowerRail(QGraphicsItem* parent)
     : LadderElement(ElementType::LeftPowerRail, parent) {
     m_size = QSizeF(20, 200);
-    m_name = "LEFT";
-}
-
-QList<ConnectionPoint> LeftPowerRail::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    // 提供多个输出连接点
-    for (int i = -4; i <= 4; ++i) {
-        points.append(ConnectionPoint(
-            QPointF(m_size.width() / 2, i * 20),
-            ConnectionType::PowerOut,
-            QString("OUT_%1").arg(i + 4)
-        ));
-    }
-    return points;
+    m_record.name = "LEFT";
+    setParameter("element_subtype", "left_power_rail");
 }
 
 void LeftPowerRail::drawElement(QPainter* painter) {
@@ -536,12 +404,6 @@ void LeftPowerRail::drawElement(QPainter* painter) {
                       m_size.width() / 2 + 3, m_size.height() / 2);
 }
 
-QMap<QString, QVariant> LeftPowerRail::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "left_power_rail";
-    return map;
-}
-
 void LeftPowerRail::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -556,20 +418,8 @@ LadderElement* LeftPowerRail::clone() const {
 RightPowerRail::RightPowerRail(QGraphicsItem* parent)
     : LadderElement(ElementType::RightPowerRail, parent) {
     m_size = QSizeF(20, 200);
-    m_name = "RIGHT";
-}
-
-QList<ConnectionPoint> RightPowerRail::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    // 提供多个输入连接点
-    for (int i = -4; i <= 4; ++i) {
-        points.append(ConnectionPoint(
-            QPointF(-m_size.width() / 2, i * 20),
-            ConnectionType::PowerIn,
-            QString("IN_%1").arg(i + 4)
-        ));
-    }
-    return points;
+    m_record.name = "RIGHT";
+    setParameter("element_subtype", "right_power_rail");
 }
 
 void RightPowerRail::drawElement(QPainter* painter) {
@@ -582,12 +432,6 @@ void RightPowerRail::drawElement(QPainter* painter) {
                       -m_size.width() / 2 + 3, m_size.height() / 2);
 }
 
-QMap<QString, QVariant> RightPowerRail::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "right_power_rail";
-    return map;
-}
-
 void RightPowerRail::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -602,22 +446,16 @@ LadderElement* RightPowerRail::clone() const {
 Timer::Timer(QGraphicsItem* parent)
     : LadderElement(ElementType::Timer, parent) {
     m_size = QSizeF(60, 40);
-    m_name = "T0";
+    m_record.name = "T0";
+    setParameter("element_subtype", "timer");
+    setParameter("timer_type", static_cast<int>(TON));
     setProperty("preset", 100);  // 预设值
     setProperty("current", 0);   // 当前值
     setProperty("timer_type", static_cast<int>(TON));
 }
 
-QList<ConnectionPoint> Timer::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, -10), ConnectionType::PowerOut, "OUT"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 10), ConnectionType::Input, "RESET"));
-    return points;
-}
-
 void Timer::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -638,7 +476,7 @@ void Timer::drawElement(QPainter* painter) {
     painter->drawText(-15, 5, typeStr);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(m_size.width() / 2 - 5, -10, m_size.width() / 2, -10);
     painter->drawLine(-m_size.width() / 2, 10, -m_size.width() / 2 + 5, 10);
@@ -646,6 +484,7 @@ void Timer::drawElement(QPainter* painter) {
 
 void Timer::setTimerType(TimerType type) {
     m_timerType = type;
+    setParameter("timer_type", static_cast<int>(type));
     setProperty("timer_type", static_cast<int>(type));
     update();
 }
@@ -654,16 +493,10 @@ Timer::TimerType Timer::timerType() const {
     return m_timerType;
 }
 
-QMap<QString, QVariant> Timer::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "timer";
-    map["timer_type"] = static_cast<int>(m_timerType);
-    return map;
-}
-
 void Timer::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
     m_timerType = static_cast<TimerType>(map["timer_type"].toInt());
+    setParameter("timer_type", static_cast<int>(m_timerType));
 }
 
 LadderElement* Timer::clone() const {
@@ -676,23 +509,16 @@ LadderElement* Timer::clone() const {
 Counter::Counter(QGraphicsItem* parent)
     : LadderElement(ElementType::Counter, parent) {
     m_size = QSizeF(60, 40);
-    m_name = "C0";
+    m_record.name = "C0";
+    setParameter("element_subtype", "counter");
+    setParameter("counter_type", static_cast<int>(CTU));
     setProperty("preset", 10);   // 预设值
     setProperty("current", 0);   // 当前值
     setProperty("counter_type", static_cast<int>(CTU));
 }
 
-QList<ConnectionPoint> Counter::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "CU"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 10), ConnectionType::Input, "CD"));
-    points.append(ConnectionPoint(QPointF(0, m_size.height() / 2), ConnectionType::Input, "RESET"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
-}
-
 void Counter::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -713,7 +539,7 @@ void Counter::drawElement(QPainter* painter) {
     painter->drawText(-15, 5, typeStr);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(-m_size.width() / 2, 10, -m_size.width() / 2 + 5, 10);
     painter->drawLine(0, m_size.height() / 2 - 5, 0, m_size.height() / 2);
@@ -722,6 +548,7 @@ void Counter::drawElement(QPainter* painter) {
 
 void Counter::setCounterType(CounterType type) {
     m_counterType = type;
+    setParameter("counter_type", static_cast<int>(type));
     setProperty("counter_type", static_cast<int>(type));
     update();
 }
@@ -730,16 +557,10 @@ Counter::CounterType Counter::counterType() const {
     return m_counterType;
 }
 
-QMap<QString, QVariant> Counter::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "counter";
-    map["counter_type"] = static_cast<int>(m_counterType);
-    return map;
-}
-
 void Counter::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
     m_counterType = static_cast<CounterType>(map["counter_type"].toInt());
+    setParameter("counter_type", static_cast<int>(m_counterType));
 }
 
 LadderElement* Counter::clone() const {
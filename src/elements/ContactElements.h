@@ -9,8 +9,6 @@ class NormallyOpenContact : public LadderElement {
 public:
     explicit NormallyOpenContact(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -23,8 +21,6 @@ class NormallyClosedContact : public LadderElement {
 public:
     explicit NormallyClosedContact(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -37,8 +33,6 @@ class OutputCoil : public LadderElement {
 public:
     explicit OutputCoil(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -51,8 +45,6 @@ class SetCoil : public LadderElement {
 public:
     explicit SetCoil(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -65,8 +57,6 @@ class ResetCoil : public LadderElement {
 public:
     explicit ResetCoil(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -79,8 +69,6 @@ class PositiveEdgeContact : public LadderElement {
 public:
     explicit PositiveEdgeContact(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -93,8 +81,6 @@ class NegativeEdgeContact : public LadderElement {
 public:
     explicit NegativeEdgeContact(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -107,8 +93,6 @@ class InvertedCoil : public LadderElement {
 public:
     explicit InvertedCoil(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -121,8 +105,6 @@ class PositiveEdgeCoil : public LadderElement {
 public:
     explicit PositiveEdgeCoil(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -135,8 +117,6 @@ class NegativeEdgeCoil : public LadderElement {
 public:
     explicit NegativeEdgeCoil(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -149,8 +129,6 @@ class LeftPowerRail : public LadderElement {
 public:
     explicit LeftPowerRail(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -163,8 +141,6 @@ class RightPowerRail : public LadderElement {
 public:
     explicit RightPowerRail(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -177,8 +153,6 @@ class Timer : public LadderElement {
 public:
     explicit Timer(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -194,6 +168,7 @@ public:
     
 protected:
     void drawElement(QPainter* painter) override;
+    int glyphVariant() const override { return static_cast<int>(m_timerType); }
     
 private:
     TimerType m_timerType = TON;
@@ -204,8 +179,6 @@ class Counter : public LadderElement {
 public:
     explicit Counter(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -221,6 +194,7 @@ public:
     
 protected:
     void drawElement(QPainter* painter) override;
+    int glyphVariant() const override { return static_cast<int>(m_counterType); }
     
 private:
     CounterType m_counterType = CTU;
@@ -7,18 +7,13 @@ namespace LadderDiagram {
 Jump::Jump(QGraphicsItem* parent)
     : LadderElement(ElementType::Jump, parent) {
     m_size = QSizeF(60, 40);
-    m_name = "JMP";
-    m_targetLabel = "";
-}
-
-QList<ConnectionPoint> Jump::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    return points;
+    m_record.name = "JMP";
+    setParameter("element_subtype", "jump");
+    setParameter("target_label", QString());
 }
 
 void Jump::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -31,20 +26,26 @@ void Jump::drawElement(QPainter* painter) {
     painter->setFont(font);
     painter->drawText(-15, 5, "JMP");
     
+    // 绘制连接线
+    painter->setPen(QPen(borderColor(), 1));
+    painter->drawLine(-m_size.width() / 2, 0, -m_size.width() / 2 + 5, 0);
+}
+
+void Jump::drawDynamic(QPainter* painter) {
     // 绘制目标标签（如果有）
     if (!m_targetLabel.isEmpty()) {
+        painter->setPen(QPen(borderColor(), 2));
+        QFont font = painter->font();
+        font.setBold(true);
         font.setPointSize(8);
         painter->setFont(font);
         painter->drawText(-m_size.width() / 2 + 8, -m_size.height() / 2 - 5, m_targetLabel);
     }
-    
-    // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
-    painter->drawLine(-m_size.width() / 2, 0, -m_size.width() / 2 + 5, 0);
 }
 
 void Jump::setTargetLabel(const QString& label) {
     m_targetLabel = label;
+    setParameter("target_label", label);
     setProperty("target_label", label);
     update();
 }
@@ -53,16 +54,10 @@ QString Jump::targetLabel() const {
     return m_targetLabel;
 }
 
-QMap<QString, QVariant> Jump::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "jump";
-    map["target_label"] = m_targetLabel;
-    return map;
-}
-
 void Jump::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
     m_targetLabel = map["target_label"].toString();
+    setParameter("target_label", m_targetLabel);
 }
 
 LadderElement* Jump::clone() const {
@@ -75,17 +70,12 @@ LadderElement* Jump::clone() const {
 Return::Return(QGraphicsItem* parent)
     : LadderElement(ElementType::Return, parent) {
     m_size = QSizeF(60, 40);
-    m_name = "RET";
-}
-
-QList<ConnectionPoint> Return::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    return points;
+    m_record.name = "RET";
+    setParameter("element_subtype", "return");
 }
 
 void Return::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -99,16 +89,10 @@ void Return::drawElement(QPainter* painter) {
     painter->drawText(-12, 5, "RET");
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, 0, -m_size.width() / 2 + 5, 0);
 }
 
-QMap<QString, QVariant> Return::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "return";
-    return map;
-}
-
 void Return::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -123,35 +107,27 @@ LadderElement* Return::clone() const {
 Label::Label(QGraphicsItem* parent)
     : LadderElement(ElementType::Label, parent) {
     m_size = QSizeF(80, 30);
-    m_name = "LBL";
-}
-
-QList<ConnectionPoint> Label::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    // 标签没有连接点，只是一个标记
-    return points;
+    m_record.name = "LBL";
+    setParameter("element_subtype", "label");
 }
 
 void Label::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制标签背景
     painter->setBrush(QBrush(QColor(240, 240, 240)));
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
                       m_size.width() - 10, m_size.height() - 10);
-    
+}
+
+void Label::drawDynamic(QPainter* painter) {
     // 绘制标签文字
+    painter->setPen(QPen(borderColor(), 2));
     QFont font = painter->font();
     font.setBold(true);
     font.setPointSize(10);
     painter->setFont(font);
-    painter->drawText(-30, 5, "LBL: " + m_name);
-}
-
-QMap<QString, QVariant> Label::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "label";
-    return map;
+    painter->drawText(-30, 5, "LBL: " + m_record.name);
 }
 
 void Label::fromMap(const QMap<QString, QVariant>& map) {
@@ -9,8 +9,6 @@ class Jump : public LadderElement {
 public:
     explicit Jump(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -19,6 +17,7 @@ public:
     
 protected:
     void drawElement(QPainter* painter) override;
+    void drawDynamic(QPainter* painter) override;
     
 private:
     QString m_targetLabel;
@@ -29,8 +28,6 @@ class Return : public LadderElement {
 public:
     explicit Return(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -43,13 +40,12 @@ class Label : public LadderElement {
 public:
     explicit Label(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
 protected:
     void drawElement(QPainter* painter) override;
+    void drawDynamic(QPainter* painter) override;
 };
 
 } // namespace LadderDiagram
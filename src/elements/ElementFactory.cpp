@@ -0,0 +1,80 @@
+#include "ElementFactory.h"
+#include "ContactElements.h"
+#include "FunctionBlockElements.h"
+#include "LogicElements.h"
+#include "MathElements.h"
+#include "ControlElements.h"
+
+namespace LadderDiagram {
+
+LadderElement* ElementFactory::create(ElementType type) {
+    switch (type) {
+        // 电源轨线
+        case ElementType::LeftPowerRail: return new LeftPowerRail();
+        case ElementType::RightPowerRail: return new RightPowerRail();
+        
+        // 触点
+        case ElementType::NormallyOpen: return new NormallyOpenContact();
+        case ElementType::NormallyClosed: return new NormallyClosedContact();
+        case ElementType::PositiveEdge: return new PositiveEdgeContact();
+        case ElementType::NegativeEdge: return new NegativeEdgeContact();
+        
+        // 线圈
+        case ElementType::OutputCoil: return new OutputCoil();
+        case ElementType::InvertedCoil: return new InvertedCoil();
+        case ElementType::SetCoil: return new SetCoil();
+        case ElementType::ResetCoil: return new ResetCoil();
+        case ElementType::PositiveEdgeCoil: return new PositiveEdgeCoil();
+        case ElementType::NegativeEdgeCoil: return new NegativeEdgeCoil();
+        
+        // 定时器
+        case ElementType::Timer: return new Timer();
+        case ElementType::TimerTOF: {
+            auto* timer = new Timer();
+            timer->setTimerType(Timer::TOF);
+            return timer;
+        }
+        case ElementType::TimerTP: {
+            auto* timer = new Timer();
+            timer->setTimerType(Timer::TP);
+            return timer;
+        }
+        
+        // 计数器
+        case ElementType::Counter: return new Counter();
+        case ElementType::CounterCTD: {
+            auto* counter = new Counter();
+            counter->setCounterType(Counter::CTD);
+            return counter;
+        }
+        case ElementType::CounterCTUD: {
+            auto* counter = new Counter();
+            counter->setCounterType(Counter::CTUD);
+            return counter;
+        }
+        
+        // 功能块
+        case ElementType::RTrig: return new RTrig();
+        case ElementType::FTrig: return new FTrig();
+        case ElementType::RS: return new RS();
+        case ElementType::SR: return new SR();
+        
+        // 逻辑运算
+        case ElementType::LogicAND: return new LogicAND();
+        case ElementType::LogicOR: return new LogicOR();
+        case ElementType::LogicNOT: return new LogicNOT();
+        
+        // 数学/比较
+        case ElementType::Comparison: return new Comparison();
+        case ElementType::MathOperation: return new MathOperation();
+        
+        // 程序控制
+        case ElementType::Jump: return new Jump();
+        case ElementType::Return: return new Return();
+        case ElementType::Label: return new Label();
+        
+        default: return nullptr;
+    }
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../core/LadderElement.h"
+
+namespace LadderDiagram {
+
+// 元件工厂 - 按元件类型创建元件（不支持的类型返回 nullptr）
+class ElementFactory {
+public:
+    static LadderElement* create(ElementType type);
+};
+
+} // namespace LadderDiagram
@@ -7,18 +7,12 @@ namespace LadderDiagram {
 RTrig::RTrig(QGraphicsItem* parent)
     : LadderElement(ElementType::RTrig, parent) {
     m_size = QSizeF(70, 50);
-    m_name = "R_TRIG";
-}
-
-QList<ConnectionPoint> RTrig::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "CLK"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, -10), ConnectionType::PowerOut, "Q"));
-    return points;
+    m_record.name = "R_TRIG";
+    setParameter("element_subtype", "r_trig");
 }
 
 void RTrig::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -36,17 +30,11 @@ void RTrig::drawElement(QPainter* painter) {
     painter->drawLine(-10, -25, -5, -20);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(m_size.width() / 2 - 5, -10, m_size.width() / 2, -10);
 }
 
-QMap<QString, QVariant> RTrig::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "r_trig";
-    return map;
-}
-
 void RTrig::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -61,18 +49,12 @@ LadderElement* RTrig::clone() const {
 FTrig::FTrig(QGraphicsItem* parent)
     : LadderElement(ElementType::FTrig, parent) {
     m_size = QSizeF(70, 50);
-    m_name = "F_TRIG";
-}
-
-QList<ConnectionPoint> FTrig::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "CLK"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, -10), ConnectionType::PowerOut, "Q"));
-    return points;
+    m_record.name = "F_TRIG";
+    setParameter("element_subtype", "f_trig");
 }
 
 void FTrig::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -90,17 +72,11 @@ void FTrig::drawElement(QPainter* painter) {
     painter->drawLine(-10, -15, -5, -20);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(m_size.width() / 2 - 5, -10, m_size.width() / 2, -10);
 }
 
-QMap<QString, QVariant> FTrig::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "f_trig";
-    return map;
-}
-
 void FTrig::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -115,19 +91,12 @@ LadderElement* FTrig::clone() const {
 RS::RS(QGraphicsItem* parent)
     : LadderElement(ElementType::RS, parent) {
     m_size = QSizeF(70, 60);
-    m_name = "RS";
-}
-
-QList<ConnectionPoint> RS::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -15), ConnectionType::PowerIn, "S"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 15), ConnectionType::Input, "R"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "Q"));
-    return points;
+    m_record.name = "RS";
+    setParameter("element_subtype", "rs");
 }
 
 void RS::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -148,18 +117,12 @@ void RS::drawElement(QPainter* painter) {
     painter->drawText(m_size.width() / 2 - 15, 5, "Q");
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -15, -m_size.width() / 2 + 5, -15);
     painter->drawLine(-m_size.width() / 2, 15, -m_size.width() / 2 + 5, 15);
     painter->drawLine(m_size.width() / 2 - 5, 0, m_size.width() / 2, 0);
 }
 
-QMap<QString, QVariant> RS::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "rs";
-    return map;
-}
-
 void RS::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -174,19 +137,12 @@ LadderElement* RS::clone() const {
 SR::SR(QGraphicsItem* parent)
     : LadderElement(ElementType::SR, parent) {
     m_size = QSizeF(70, 60);
-    m_name = "SR";
-}
-
-QList<ConnectionPoint> SR::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -15), ConnectionType::PowerIn, "S"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 15), ConnectionType::Input, "R"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "Q"));
-    return points;
+    m_record.name = "SR";
+    setParameter("element_subtype", "sr");
 }
 
 void SR::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -207,18 +163,12 @@ void SR::drawElement(QPainter* painter) {
     painter->drawText(m_size.width() / 2 - 15, 5, "Q");
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -15, -m_size.width() / 2 + 5, -15);
     painter->drawLine(-m_size.width() / 2, 15, -m_size.width() / 2 + 5, 15);
     painter->drawLine(m_size.width() / 2 - 5, 0, m_size.width() / 2, 0);
 }
 
-QMap<QString, QVariant> SR::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "sr";
-    return map;
-}
-
 void SR::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -9,8 +9,6 @@ class RTrig : public LadderElement {
 public:
     explicit RTrig(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -23,8 +21,6 @@ class FTrig : public LadderElement {
 public:
     explicit FTrig(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -37,8 +33,6 @@ class RS : public LadderElement {
 public:
     explicit RS(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -51,8 +45,6 @@ class SR : public LadderElement {
 public:
     explicit SR(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -7,19 +7,12 @@ namespace LadderDiagram {
 LogicAND::LogicAND(QGraphicsItem* parent)
     : LadderElement(ElementType::LogicAND, parent) {
     m_size = QSizeF(60, 50);
-    m_name = "AND";
-}
-
-QList<ConnectionPoint> LogicAND::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "IN1"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 10), ConnectionType::Input, "IN2"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "AND";
+    setParameter("element_subtype", "logic_and");
 }
 
 void LogicAND::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -33,18 +26,12 @@ void LogicAND::drawElement(QPainter* painter) {
     painter->drawText(-8, 6, "&");
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(-m_size.width() / 2, 10, -m_size.width() / 2 + 5, 10);
     painter->drawLine(m_size.width() / 2 - 5, 0, m_size.width() / 2, 0);
 }
 
-QMap<QString, QVariant> LogicAND::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "logic_and";
-    return map;
-}
-
 void LogicAND::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -59,19 +46,12 @@ LadderElement* LogicAND::clone() const {
 LogicOR::LogicOR(QGraphicsItem* parent)
     : LadderElement(ElementType::LogicOR, parent) {
     m_size = QSizeF(60, 50);
-    m_name = "OR";
-}
-
-QList<ConnectionPoint> LogicOR::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "IN1"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 10), ConnectionType::Input, "IN2"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "OR";
+    setParameter("element_subtype", "logic_or");
 }
 
 void LogicOR::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -85,18 +65,12 @@ void LogicOR::drawElement(QPainter* painter) {
     painter->drawText(-12, 5, ">=1");
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(-m_size.width() / 2, 10, -m_size.width() / 2 + 5, 10);
     painter->drawLine(m_size.width() / 2 - 5, 0, m_size.width() / 2, 0);
 }
 
-QMap<QString, QVariant> LogicOR::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "logic_or";
-    return map;
-}
-
 void LogicOR::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -111,18 +85,12 @@ LadderElement* LogicOR::clone() const {
 LogicNOT::LogicNOT(QGraphicsItem* parent)
     : LadderElement(ElementType::LogicNOT, parent) {
     m_size = QSizeF(50, 40);
-    m_name = "NOT";
-}
-
-QList<ConnectionPoint> LogicNOT::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 0), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    m_record.name = "NOT";
+    setParameter("element_subtype", "logic_not");
 }
 
 void LogicNOT::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -139,17 +107,11 @@ void LogicNOT::drawElement(QPainter* painter) {
     painter->drawEllipse(8, -4, 8, 8);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, 0, -m_size.width() / 2 + 5, 0);
     painter->drawLine(m_size.width() / 2 - 5, 0, m_size.width() / 2, 0);
 }
 
-QMap<QString, QVariant> LogicNOT::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "logic_not";
-    return map;
-}
-
 void LogicNOT::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
 }
@@ -9,8 +9,6 @@ class LogicAND : public LadderElement {
 public:
     explicit LogicAND(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -23,8 +21,6 @@ class LogicOR : public LadderElement {
 public:
     explicit LogicOR(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -37,8 +33,6 @@ class LogicNOT : public LadderElement {
 public:
     explicit LogicNOT(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -7,19 +7,16 @@ namespace LadderDiagram {
 Comparison::Comparison(QGraphicsItem* parent)
     : LadderElement(ElementType::Comparison, parent) {
     m_size = QSizeF(70, 50);
-    m_name = "CMP";
+    m_record.name = "CMP";
+    setParameter("element_subtype", "comparison");
+    setParameter("compare_op", static_cast<int>(EQ));
     setProperty("compare_op", static_cast<int>(EQ));
-}
-
-QList<ConnectionPoint> Comparison::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -10), ConnectionType::PowerIn, "IN"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, -10), ConnectionType::PowerOut, "OUT"));
-    return points;
+    setProperty("in1", "D0");
+    setProperty("in2", "0");
 }
 
 void Comparison::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -43,13 +40,14 @@ void Comparison::drawElement(QPainter* painter) {
     painter->drawText(-10, 5, opStr);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -10, -m_size.width() / 2 + 5, -10);
     painter->drawLine(m_size.width() / 2 - 5, -10, m_size.width() / 2, -10);
 }
 
 void Comparison::setCompareOp(CompareOp op) {
     m_compareOp = op;
+    setParameter("compare_op", static_cast<int>(op));
     setProperty("compare_op", static_cast<int>(op));
     update();
 }
@@ -58,16 +56,10 @@ Comparison::CompareOp Comparison::compareOp() const {
     return m_compareOp;
 }
 
-QMap<QString, QVariant> Comparison::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "comparison";
-    map["compare_op"] = static_cast<int>(m_compareOp);
-    return map;
-}
-
 void Comparison::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
     m_compareOp = static_cast<CompareOp>(map["compare_op"].toInt());
+    setParameter("compare_op", static_cast<int>(m_compareOp));
 }
 
 LadderElement* Comparison::clone() const {
@@ -80,20 +72,17 @@ LadderElement* Comparison::clone() const {
 MathOperation::MathOperation(QGraphicsItem* parent)
     : LadderElement(ElementType::MathOperation, parent) {
     m_size = QSizeF(70, 60);
-    m_name = "MATH";
+    m_record.name = "MATH";
+    setParameter("element_subtype", "math_operation");
+    setParameter("math_op", static_cast<int>(ADD));
     setProperty("math_op", static_cast<int>(ADD));
-}
-
-QList<ConnectionPoint> MathOperation::connectionPoints() const {
-    QList<ConnectionPoint> points;
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, -15), ConnectionType::PowerIn, "IN1"));
-    points.append(ConnectionPoint(QPointF(-m_size.width() / 2, 15), ConnectionType::Input, "IN2"));
-    points.append(ConnectionPoint(QPointF(m_size.width() / 2, 0), ConnectionType::PowerOut, "OUT"));
-    return points;
+    setProperty("in1", "D0");
+    setProperty("in2", "D1");
+    setProperty("out", "D2");
 }
 
 void MathOperation::drawElement(QPainter* painter) {
-    painter->setPen(QPen(m_borderColor, 2));
+    painter->setPen(QPen(borderColor(), 2));
     
     // 绘制方框
     painter->drawRect(-m_size.width() / 2 + 5, -m_size.height() / 2 + 5, 
@@ -115,7 +104,7 @@ void MathOperation::drawElement(QPainter* painter) {
     painter->drawText(-6, 6, opStr);
     
     // 绘制连接线
-    painter->setPen(QPen(m_borderColor, 1));
+    painter->setPen(QPen(borderColor(), 1));
     painter->drawLine(-m_size.width() / 2, -15, -m_size.width() / 2 + 5, -15);
     painter->drawLine(-m_size.width() / 2, 15, -m_size.width() / 2 + 5, 15);
     painter->drawLine(m_size.width() / 2 - 5, 0, m_size.width() / 2, 0);
@@ -123,6 +112,7 @@ void MathOperation::drawElement(QPainter* painter) {
 
 void MathOperation::setMathOp(MathOp op) {
     m_mathOp = op;
+    setParameter("math_op", static_cast<int>(op));
     setProperty("math_op", static_cast<int>(op));
     update();
 }
@@ -131,16 +121,10 @@ MathOperation::MathOp MathOperation::mathOp() const {
     return m_mathOp;
 }
 
-QMap<QString, QVariant> MathOperation::toMap() const {
-    auto map = LadderElement::toMap();
-    map["element_subtype"] = "math_operation";
-    map["math_op"] = static_cast<int>(m_mathOp);
-    return map;
-}
-
 void MathOperation::fromMap(const QMap<QString, QVariant>& map) {
     LadderElement::fromMap(map);
     m_mathOp = static_cast<MathOp>(map["math_op"].toInt());
+    setParameter("math_op", static_cast<int>(m_mathOp));
 }
 
 LadderElement* MathOperation::clone() const {
@@ -9,8 +9,6 @@ class Comparison : public LadderElement {
 public:
     explicit Comparison(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -29,6 +27,7 @@ public:
     
 protected:
     void drawElement(QPainter* painter) override;
+    int glyphVariant() const override { return static_cast<int>(m_compareOp); }
     
 private:
     CompareOp m_compareOp = EQ;
@@ -39,8 +38,6 @@ class MathOperation : public LadderElement {
 public:
     explicit MathOperation(QGraphicsItem* parent = nullptr);
     
-    QList<ConnectionPoint> connectionPoints() const override;
-    QMap<QString, QVariant> toMap() const override;
     void fromMap(const QMap<QString, QVariant>& map) override;
     LadderElement* clone() const override;
     
@@ -57,6 +54,7 @@ public:
     
 protected:
     void drawElement(QPainter* painter) override;
+    int glyphVariant() const override { return static_cast<int>(m_mathOp); }
     
 private:
     MathOp m_mathOp = ADD;
@@ -0,0 +1,168 @@
+// ldc - 梯形图命令行编译器
+//
+// 不依赖界面，把 .ldjson 工程编译为 ST 代码：
+//     ldc [-j N] [-o 输出目录] 工程.ldjson...
+// 默认输出到工程文件所在目录，扩展名改为 .st。
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QTextStream>
+#include <atomic>
+#include "codegen/STCodeGenerator.h"
+
+using namespace LadderDiagram;
+
+namespace {
+
+struct CompileJob {
+    QString input;
+    QString output;
+    QString error;      // 为空表示成功
+};
+
+void compile(CompileJob& job, int generatorThreads) {
+    STCodeGenerator generator;
+    generator.setMaxThreadCount(generatorThreads);
+    const QString programName = STCodeGenerator::programNameForFile(job.input);
+    if (!programName.isEmpty()) {
+        generator.setProgramName(programName);
+    }
+
+    QString loadError;
+    if (!generator.loadFromJsonFile(job.input, &loadError)) {
+        job.error = loadError.isEmpty() ? QStringLiteral("无法读取工程文件")
+                                        : QStringLiteral("无法读取工程文件: %1").arg(loadError);
+    } else if (!generator.saveToFile(job.output)) {
+        // 梯形图无法译为ST时不产生输出文件
+        job.error = generator.hasErrors() ? generator.errors().join(QStringLiteral("；"))
+                                          : QStringLiteral("无法写入 %1").arg(job.output);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("LadderDiagram");
+    app.setApplicationName("ldc");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("把梯形图工程 (.ldjson) 编译为 IEC 61131-3 ST 代码"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption jobsOption({"j", "jobs"},
+                                  QStringLiteral("并行编译的文件数（0 为按CPU核数）"), "N", "1");
+    QCommandLineOption outputOption({"o", "output"},
+                                    QStringLiteral("输出目录（默认与工程文件同目录）"), "dir");
+    QCommandLineOption quietOption({"q", "quiet"}, QStringLiteral("只输出错误"));
+    parser.addOption(jobsOption);
+    parser.addOption(outputOption);
+    parser.addOption(quietOption);
+    parser.addPositionalArgument("files", QStringLiteral("要编译的 .ldjson 文件"), "files...");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    bool ok = false;
+    int jobs = parser.value(jobsOption).toInt(&ok);
+    if (!ok || jobs < 0) {
+        err << QStringLiteral("ldc: 无效的 -j 参数: %1").arg(parser.value(jobsOption)) << Qt::endl;
+        return 1;
+    }
+    if (jobs == 0) {
+        jobs = QThread::idealThreadCount();
+    }
+
+    const QString outputDir = parser.value(outputOption);
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        err << QStringLiteral("ldc: 无法创建输出目录: %1").arg(outputDir) << Qt::endl;
+        return 1;
+    }
+
+    QVector<CompileJob> compileJobs(inputs.size());
+    for (int i = 0; i < inputs.size(); ++i) {
+        const QFileInfo info(inputs[i]);
+        const QDir dir = outputDir.isEmpty() ? info.dir() : QDir(outputDir);
+        compileJobs[i].input = inputs[i];
+        compileJobs[i].output = dir.filePath(info.completeBaseName() + ".st");
+    }
+
+    // 不同目录下的同名工程输出到同一目录时会互相覆盖，编译前先检查
+    QHash<QString, QString> outputOwners;
+    int collisions = 0;
+    for (const CompileJob& job : compileJobs) {
+        QString key = QDir::cleanPath(QFileInfo(job.output).absoluteFilePath());
+#ifdef Q_OS_WIN
+        key = key.toCaseFolded();
+#endif
+        auto it = outputOwners.constFind(key);
+        if (it != outputOwners.constEnd()) {
+            err << QStringLiteral("ldc: %1 与 %2 都输出到 %3")
+                       .arg(it.value(), job.input, job.output) << Qt::endl;
+            ++collisions;
+        } else {
+            outputOwners.insert(key, job.input);
+        }
+    }
+    if (collisions > 0) {
+        return 1;
+    }
+
+    // 每个文件独立编译，互不共享状态；多个文件并行时各文件内部串行编译，
+    // 总线程数不超过 -j
+    const bool parallelFiles = jobs > 1 && compileJobs.size() > 1;
+    const int generatorThreads = parallelFiles ? 1 : 0;
+    const bool quiet = parser.isSet(quietOption);
+    std::atomic<int> done{0};
+    QMutex outputMutex;
+    auto run = [&](CompileJob& job) {
+        compile(job, generatorThreads);
+        const int finished = ++done;
+        if (!quiet && job.error.isEmpty()) {
+            QMutexLocker locker(&outputMutex);
+            out << QStringLiteral("[%1/%2] %3 -> %4").arg(finished).arg(compileJobs.size())
+                       .arg(job.input, job.output) << Qt::endl;
+        }
+    };
+
+    if (!parallelFiles) {
+        for (CompileJob& job : compileJobs) {
+            run(job);
+        }
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(jobs);
+        for (CompileJob& job : compileJobs) {
+            pool.start([&run, &job] { run(job); });
+        }
+        pool.waitForDone();
+    }
+
+    // 错误按输入顺序汇总
+    int failures = 0;
+    for (const CompileJob& job : compileJobs) {
+        if (!job.error.isEmpty()) {
+            err << QStringLiteral("ldc: %1: %2").arg(job.input, job.error) << Qt::endl;
+            ++failures;
+        }
+    }
+
+    if (failures > 0) {
+        err << QStringLiteral("ldc: %1 个文件编译失败").arg(failures) << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include "BitSliceEvaluator.h"
+#include "../codegen/PowerFlowGraph.h"
+#include "../codegen/STCodeGenerator.h"
+#include <QtCore/QBuffer>
+#include <algorithm>
+
+namespace LadderDiagram {
+
+namespace {
+
+// 每批内按块执行：64个字（4096个通道）的工作集可以留在L1缓存中
+constexpr int BlockWords = 64;
+
+// 输入编号 0~5 在一个字内的取值模式
+constexpr quint64 LanePatterns[6] = {
+    0xAAAAAAAAAAAAAAAAULL,
+    0xCCCCCCCCCCCCCCCCULL,
+    0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL,
+    0xFFFF0000FFFF0000ULL,
+    0xFFFFFFFF00000000ULL
+};
+
+bool isSupported(ElementType type) {
+    switch (type) {
+        case ElementType::LeftPowerRail:
+        case ElementType::RightPowerRail:
+        case ElementType::NormallyOpen:
+        case ElementType::NormallyClosed:
+        case ElementType::OutputCoil:
+        case ElementType::InvertedCoil:
+        case ElementType::SetCoil:
+        case ElementType::ResetCoil:
+        case ElementType::LogicAND:
+        case ElementType::LogicOR:
+        case ElementType::LogicNOT:
+        case ElementType::Label:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isCoil(ElementType type) {
+    return type == ElementType::OutputCoil || type == ElementType::InvertedCoil
+           || type == ElementType::SetCoil || type == ElementType::ResetCoil;
+}
+
+} // namespace
+
+BitSliceEvaluator::BitSliceEvaluator()
+    : m_kernel(BitKernels::bestKernel())
+{
+}
+
+int BitSliceEvaluator::variableRow(const QString& name) {
+    auto it = m_variables.constFind(name);
+    if (it != m_variables.constEnd()) return it.value();
+    int row = m_rowCount++;
+    m_variables.insert(name, row);
+    return row;
+}
+
+void BitSliceEvaluator::append(BitKernels::Op op, int dst, int a, int b) {
+    m_ops.append(BitOp{op, dst, a, b});
+}
+
+bool BitSliceEvaluator::compileJson(const QByteArray& json) {
+    QByteArray bytes = json;
+    QBuffer buffer(&bytes);
+    LadderModel model;
+    if (!buffer.open(QIODevice::ReadOnly) || !model.readJson(&buffer)) {
+        m_error = QString("无效的梯形图数据");
+        return false;
+    }
+
+    return compile(model.elements, model.connections);
+}
+
+bool BitSliceEvaluator::compile(const QList<ElementData>& elements,
+                                const QList<ConnectionData>& connections) {
+    m_ops.clear();
+    m_variables.clear();
+    m_written.clear();
+    m_inputs.clear();
+    m_outputs.clear();
+    m_inputRows.clear();
+    m_outputRows.clear();
+    m_rowCount = 2;     // ZeroRow, OnesRow
+    m_error.clear();
+
+    for (const auto& element : elements) {
+        if (!isSupported(element.type)) {
+            m_error = QString("元件 %1 不是纯布尔元件，不能使用位切片仿真").arg(element.id);
+            return false;
+        }
+    }
+
+    const QList<LadderNetwork> networks = STCodeGenerator::splitNetworks(elements, connections);
+
+    // 先分配变量行，节点行放在其后并在各网络间复用
+    QStringList order;
+    for (const LadderNetwork& network : networks) {
+        for (const auto& element : network.elements) {
+            const ElementType type = element.type;
+            if (type != ElementType::NormallyOpen && type != ElementType::NormallyClosed && !isCoil(type)) {
+                continue;
+            }
+            const QString name = STCodeGenerator::operandName(element);
+            if (!m_variables.contains(name)) order.append(name);
+            variableRow(name);
+            if (isCoil(type)) m_written.insert(name);
+        }
+    }
+    for (const QString& name : order) {
+        if (m_written.contains(name)) {
+            m_outputs.append(name);
+            m_outputRows.append(m_variables.value(name));
+        } else {
+            m_inputs.append(name);
+            m_inputRows.append(m_variables.value(name));
+        }
+    }
+
+    const int netBase = m_rowCount;
+    int maxNets = 0;
+
+    for (const LadderNetwork& network : networks) {
+        PowerFlowGraph flow;
+        flow.build(network.elements, network.connections);
+        maxNets = qMax(maxNets, flow.netCount());
+
+        auto netRow = [&](int element, int pin) {
+            int net = flow.pinNet(element, pin);
+            return net == PowerFlowGraph::NoNet ? int(ZeroRow) : netBase + net;
+        };
+
+        for (int net = 0; net < flow.netCount(); ++net) {
+            append(net == flow.sourceNet() ? BitKernels::Ones : BitKernels::Zero, netBase + net);
+        }
+
+        for (int e : flow.schedule()) {
+            const auto& element = network.elements[e];
+            const ElementType type = flow.elementType(e);
+            const int out = flow.pinNet(e, type == ElementType::LogicAND || type == ElementType::LogicOR ? 2 : 1);
+
+            switch (type) {
+                case ElementType::NormallyOpen:
+                case ElementType::NormallyClosed: {
+                    if (out == PowerFlowGraph::NoNet || flow.pinNet(e, 0) == PowerFlowGraph::NoNet) break;
+                    const int variable = m_variables.value(STCodeGenerator::operandName(element));
+                    append(type == ElementType::NormallyOpen ? BitKernels::OrAnd : BitKernels::OrAndNot,
+                           netBase + out, netRow(e, 0), variable);
+                    break;
+                }
+
+                case ElementType::OutputCoil:
+                case ElementType::InvertedCoil:
+                case ElementType::SetCoil:
+                case ElementType::ResetCoil: {
+                    if (flow.pinNet(e, 0) == PowerFlowGraph::NoNet) break;
+                    const int variable = m_variables.value(STCodeGenerator::operandName(element));
+                    const int in = netRow(e, 0);
+                    switch (type) {
+                        case ElementType::OutputCoil: append(BitKernels::Copy, variable, in); break;
+                        case ElementType::InvertedCoil: append(BitKernels::Not, variable, in); break;
+                        case ElementType::SetCoil: append(BitKernels::OrBits, variable, in); break;
+                        default: append(BitKernels::ClearBits, variable, in); break;
+                    }
+                    if (out != PowerFlowGraph::NoNet) append(BitKernels::OrBits, netBase + out, in);
+                    break;
+                }
+
+                case ElementType::LogicAND:
+                    if (out != PowerFlowGraph::NoNet) {
+                        append(BitKernels::OrAnd, netBase + out, netRow(e, 0), netRow(e, 1));
+                    }
+                    break;
+
+                case ElementType::LogicOR:
+                    if (out != PowerFlowGraph::NoNet) {
+                        append(BitKernels::OrBits, netBase + out, netRow(e, 0));
+                        append(BitKernels::OrBits, netBase + out, netRow(e, 1));
+                    }
+                    break;
+
+                case ElementType::LogicNOT:
+                    if (out != PowerFlowGraph::NoNet) {
+                        append(BitKernels::OrNotBits, netBase + out, netRow(e, 0));
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    m_rowCount = netBase + maxNets;
+    reset();
+    return true;
+}
+
+void BitSliceEvaluator::setLaneCount(int lanes) {
+    m_words = qMax(4, ((lanes + 255) / 256) * 4);
+    reset();
+}
+
+void BitSliceEvaluator::reset() {
+    m_memory.fill(0, m_rowCount * m_words);
+    std::fill(m_memory.begin() + OnesRow * m_words, m_memory.begin() + (OnesRow + 1) * m_words,
+              ~quint64(0));
+}
+
+quint64* BitSliceEvaluator::inputRow(int input) {
+    return m_memory.data() + qsizetype(m_inputRows[input]) * m_words;
+}
+
+const quint64* BitSliceEvaluator::outputRow(int output) const {
+    return m_memory.constData() + qsizetype(m_outputRows[output]) * m_words;
+}
+
+bool BitSliceEvaluator::output(int output, int lane) const {
+    return (outputRow(output)[lane >> 6] >> (lane & 63)) & 1u;
+}
+
+void BitSliceEvaluator::evaluate() {
+    quint64* base = m_memory.data();
+    const BitOp* ops = m_ops.constData();
+    const int opCount = m_ops.size();
+
+    for (int offset = 0; offset < m_words; offset += BlockWords) {
+        const int words = qMin(BlockWords, m_words - offset);
+        for (int i = 0; i < opCount; ++i) {
+            const BitOp& op = ops[i];
+            m_kernel(op.op,
+                     base + qsizetype(op.dst) * m_words + offset,
+                     base + qsizetype(op.a) * m_words + offset,
+                     base + qsizetype(op.b) * m_words + offset,
+                     words);
+        }
+    }
+}
+
+void BitSliceEvaluator::fillInputPattern(int input, qint64 firstVector) {
+    quint64* row = inputRow(input);
+    if (input < 6) {
+        std::fill(row, row + m_words, LanePatterns[input]);
+        return;
+    }
+    for (int w = 0; w < m_words; ++w) {
+        const qint64 vector = firstVector + qint64(w) * 64;
+        row[w] = ((vector >> input) & 1) ? ~quint64(0) : 0;
+    }
+}
+
+bool BitSliceEvaluator::sweep(const SweepCallback& callback) {
+    const int inputCount = m_inputs.size();
+    if (inputCount > MaxSweepInputs) {
+        m_error = QString("输入数量过多，无法完整扫描（%1 > %2）").arg(inputCount).arg(MaxSweepInputs);
+        return false;
+    }
+
+    const qint64 total = qint64(1) << inputCount;
+    const int lanes = laneCount();
+    for (qint64 first = 0; first < total; first += lanes) {
+        reset();
+        for (int i = 0; i < inputCount; ++i) {
+            fillInputPattern(i, first);
+        }
+        for (int scan = 0; scan < m_scansPerVector; ++scan) {
+            evaluate();
+        }
+        callback(first, int(qMin<qint64>(lanes, total - first)), *this);
+    }
+    return true;
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <QtCore/QByteArray>
+#include <functional>
+#include "BitSliceKernels.h"
+#include "../core/LadderModel.h"
+
+namespace LadderDiagram {
+
+// 位切片仿真 - 同时对大量输入向量执行纯布尔网络
+//
+// 只包含触点(NO/NC)、线圈(输出/取反/置位/复位)、逻辑门与电源轨的网络
+// 可降级为按字运算的 AND/OR/ANDNOT 序列：每个变量占一行 laneCount() 位，
+// 每一位是一个独立的输入向量。运算按块执行以保持工作集在缓存内，
+// CPU 支持时使用 AVX2，否则使用可移植实现。
+class BitSliceEvaluator {
+public:
+    // 一批向量的回调：firstVector 为本批第一个向量的编号，count 为本批有效向量数
+    using SweepCallback = std::function<void(qint64 firstVector, int count, const BitSliceEvaluator& evaluator)>;
+
+    // 组合扫描允许的最大输入数
+    static constexpr int MaxSweepInputs = 40;
+
+    BitSliceEvaluator();
+
+    // 由 .ldjson 数据编译
+    bool compileJson(const QByteArray& json);
+
+    // 由元件与连接线编译；含非布尔元件时返回 false
+    bool compile(const QList<ElementData>& elements, const QList<ConnectionData>& connections);
+    QString errorString() const { return m_error; }
+
+    // 只读不写的变量（输入）与被线圈驱动的变量（输出）
+    const QStringList& inputs() const { return m_inputs; }
+    const QStringList& outputs() const { return m_outputs; }
+
+    // 每批的并行向量数（向上取整到256的倍数）
+    void setLaneCount(int lanes);
+    int laneCount() const { return m_words * 64; }
+
+    // 每批执行的扫描次数（自保持等反馈回路需要多次扫描才稳定）
+    void setScansPerVector(int scans) { m_scansPerVector = qMax(1, scans); }
+    int scansPerVector() const { return m_scansPerVector; }
+
+    // 清零全部变量（包括置位/复位线圈保持的状态）
+    void reset();
+
+    // 输入/输出行（laneCount()/64 个字）
+    quint64* inputRow(int input);
+    const quint64* outputRow(int output) const;
+    bool output(int output, int lane) const;
+
+    // 对所有通道执行一次扫描
+    void evaluate();
+
+    // 遍历全部 2^n 种输入组合；每批开始前复位状态，批数据由回调读取
+    bool sweep(const SweepCallback& callback);
+
+    // 是否使用 AVX2 实现
+    static bool usesAvx2() { return BitKernels::cpuHasAvx2(); }
+
+private:
+    struct BitOp {
+        BitKernels::Op op;
+        qint32 dst;
+        qint32 a;
+        qint32 b;
+    };
+
+    static constexpr int ZeroRow = 0;
+    static constexpr int OnesRow = 1;
+
+    int variableRow(const QString& name);
+    void append(BitKernels::Op op, int dst, int a = ZeroRow, int b = ZeroRow);
+    void fillInputPattern(int input, qint64 firstVector);
+
+    QVector<BitOp> m_ops;
+    QHash<QString, int> m_variables;
+    QSet<QString> m_written;
+    QStringList m_inputs;
+    QStringList m_outputs;
+    QVector<int> m_inputRows;
+    QVector<int> m_outputRows;
+    int m_rowCount = 2;
+    int m_words = 64;
+    int m_scansPerVector = 1;
+    QVector<quint64> m_memory;          // 行主序：row * m_words
+    BitKernels::KernelFn m_kernel;
+    QString m_error;
+};
+
+} // namespace LadderDiagram
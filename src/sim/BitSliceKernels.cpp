@@ -0,0 +1,149 @@
+#include "BitSliceKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LD_AVX2_KERNEL 1
+#define LD_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#define LD_AVX2_KERNEL 1
+#define LD_AVX2_TARGET
+#endif
+
+namespace LadderDiagram {
+namespace BitKernels {
+
+void scalarKernel(Op op, uint64_t* dst, const uint64_t* a, const uint64_t* b, int words) {
+    switch (op) {
+        case Zero:
+            for (int i = 0; i < words; ++i) dst[i] = 0;
+            break;
+        case Ones:
+            for (int i = 0; i < words; ++i) dst[i] = ~uint64_t(0);
+            break;
+        case Copy:
+            for (int i = 0; i < words; ++i) dst[i] = a[i];
+            break;
+        case Not:
+            for (int i = 0; i < words; ++i) dst[i] = ~a[i];
+            break;
+        case OrBits:
+            for (int i = 0; i < words; ++i) dst[i] |= a[i];
+            break;
+        case OrNotBits:
+            for (int i = 0; i < words; ++i) dst[i] |= ~a[i];
+            break;
+        case ClearBits:
+            for (int i = 0; i < words; ++i) dst[i] &= ~a[i];
+            break;
+        case OrAnd:
+            for (int i = 0; i < words; ++i) dst[i] |= a[i] & b[i];
+            break;
+        case OrAndNot:
+            for (int i = 0; i < words; ++i) dst[i] |= a[i] & ~b[i];
+            break;
+    }
+}
+
+#ifdef LD_AVX2_KERNEL
+
+namespace {
+
+LD_AVX2_TARGET
+void avx2Kernel(Op op, uint64_t* dst, const uint64_t* a, const uint64_t* b, int words) {
+    auto* d = reinterpret_cast<__m256i*>(dst);
+    const auto* x = reinterpret_cast<const __m256i*>(a);
+    const auto* y = reinterpret_cast<const __m256i*>(b);
+    const int n = words / 4;
+    const __m256i ones = _mm256_set1_epi64x(-1);
+
+    switch (op) {
+        case Zero:
+            for (int i = 0; i < n; ++i) _mm256_storeu_si256(d + i, _mm256_setzero_si256());
+            break;
+        case Ones:
+            for (int i = 0; i < n; ++i) _mm256_storeu_si256(d + i, ones);
+            break;
+        case Copy:
+            for (int i = 0; i < n; ++i) _mm256_storeu_si256(d + i, _mm256_loadu_si256(x + i));
+            break;
+        case Not:
+            for (int i = 0; i < n; ++i) {
+                _mm256_storeu_si256(d + i, _mm256_xor_si256(_mm256_loadu_si256(x + i), ones));
+            }
+            break;
+        case OrBits:
+            for (int i = 0; i < n; ++i) {
+                __m256i v = _mm256_or_si256(_mm256_loadu_si256(d + i), _mm256_loadu_si256(x + i));
+                _mm256_storeu_si256(d + i, v);
+            }
+            break;
+        case OrNotBits:
+            for (int i = 0; i < n; ++i) {
+                __m256i inv = _mm256_xor_si256(_mm256_loadu_si256(x + i), ones);
+                _mm256_storeu_si256(d + i, _mm256_or_si256(_mm256_loadu_si256(d + i), inv));
+            }
+            break;
+        case ClearBits:
+            for (int i = 0; i < n; ++i) {
+                // andnot(x, d) = ~x & d
+                __m256i v = _mm256_andnot_si256(_mm256_loadu_si256(x + i), _mm256_loadu_si256(d + i));
+                _mm256_storeu_si256(d + i, v);
+            }
+            break;
+        case OrAnd:
+            for (int i = 0; i < n; ++i) {
+                __m256i t = _mm256_and_si256(_mm256_loadu_si256(x + i), _mm256_loadu_si256(y + i));
+                _mm256_storeu_si256(d + i, _mm256_or_si256(_mm256_loadu_si256(d + i), t));
+            }
+            break;
+        case OrAndNot:
+            for (int i = 0; i < n; ++i) {
+                __m256i t = _mm256_andnot_si256(_mm256_loadu_si256(y + i), _mm256_loadu_si256(x + i));
+                _mm256_storeu_si256(d + i, _mm256_or_si256(_mm256_loadu_si256(d + i), t));
+            }
+            break;
+    }
+}
+
+} // namespace
+
+bool cpuHasAvx2() {
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // 需要操作系统保存 YMM 寄存器
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#endif
+}
+
+KernelFn bestKernel() {
+    static const KernelFn kernel = cpuHasAvx2() ? &avx2Kernel : &scalarKernel;
+    return kernel;
+}
+
+#else
+
+bool cpuHasAvx2() {
+    return false;
+}
+
+KernelFn bestKernel() {
+    return &scalarKernel;
+}
+
+#endif
+
+} // namespace BitKernels
+} // namespace LadderDiagram
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace LadderDiagram {
+namespace BitKernels {
+
+// 位切片运算：每个 64 位字的每一位是一个独立的输入向量（通道）
+enum Op : uint8_t {
+    Zero,           // dst = 0
+    Ones,           // dst = ~0
+    Copy,           // dst = a
+    Not,            // dst = ~a
+    OrBits,         // dst |= a
+    OrNotBits,      // dst |= ~a
+    ClearBits,      // dst &= ~a
+    OrAnd,          // dst |= a & b
+    OrAndNot        // dst |= a & ~b
+};
+
+// 对 words 个字执行一条运算（words 为 4 的倍数）
+using KernelFn = void (*)(Op op, uint64_t* dst, const uint64_t* a, const uint64_t* b, int words);
+
+// 可移植实现
+void scalarKernel(Op op, uint64_t* dst, const uint64_t* a, const uint64_t* b, int words);
+
+// 当前CPU是否支持 AVX2
+bool cpuHasAvx2();
+
+// 选择最快的实现（支持 AVX2 时使用 256 位实现）
+KernelFn bestKernel();
+
+} // namespace BitKernels
+} // namespace LadderDiagram
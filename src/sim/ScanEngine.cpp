@@ -0,0 +1,127 @@
+#include "ScanEngine.h"
+#include <QtCore/QThread>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+
+namespace LadderDiagram {
+
+ScanEngine::ScanEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+ScanEngine::~ScanEngine() {
+    stop();
+}
+
+void ScanEngine::start(const SimProgram& program) {
+    stop();
+
+    m_program = std::make_shared<const SimProgram>(program);
+    m_stopRequested = false;
+    m_scanCount = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pendingWrites.clear();
+        m_published.clear();
+        m_hasSnapshot = false;
+    }
+
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("ScanEngine");
+    m_thread->start(QThread::TimeCriticalPriority);
+}
+
+void ScanEngine::stop() {
+    if (!m_thread) return;
+
+    m_stopRequested = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_program.reset();
+}
+
+void ScanEngine::setScanPeriod(int ms) {
+    m_periodMs = qBound(MinScanPeriod, ms, MaxScanPeriod);
+}
+
+void ScanEngine::writeBit(int slot, bool value) {
+    if (slot < 0) return;
+    QMutexLocker locker(&m_mutex);
+    m_pendingWrites.append(qMakePair(slot, value ? 1 : 0));
+}
+
+void ScanEngine::toggleBit(int slot) {
+    if (slot < 0) return;
+    QMutexLocker locker(&m_mutex);
+    m_pendingWrites.append(qMakePair(slot, -1));
+}
+
+bool ScanEngine::takeSnapshot(QVector<quint64>& bits) {
+    QMutexLocker locker(&m_mutex);
+    if (!m_hasSnapshot) return false;
+    bits = m_published;
+    m_hasSnapshot = false;
+    return true;
+}
+
+void ScanEngine::run() {
+    const std::shared_ptr<const SimProgram> program = m_program;
+    SimMemory memory = program->createMemory();
+    QVector<QPair<int, int>> writes;
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 lastScanNs = clock.nsecsElapsed();
+    qint64 nextScanNs = lastScanNs;
+    qint64 lastPublishNs = lastScanNs - qint64(PublishInterval) * 1000000;
+
+    while (!m_stopRequested) {
+        // 应用界面线程的强制写入
+        {
+            QMutexLocker locker(&m_mutex);
+            writes.swap(m_pendingWrites);
+        }
+        for (const auto& write : writes) {
+            if (write.first >= memory.bits.size() * 64) continue;
+            memory.setBit(write.first, write.second < 0 ? !memory.bit(write.first) : write.second != 0);
+        }
+        writes.clear();
+
+        const qint64 nowNs = clock.nsecsElapsed();
+        const qint64 elapsedUs = (nowNs - lastScanNs) / 1000;
+        lastScanNs = nowNs;
+
+        if (!program->scan(memory, elapsedUs)) {
+            emit faulted(tr("扫描超出指令预算（可能存在后向跳转死循环）"));
+            break;
+        }
+        m_scanCount.fetch_add(1, std::memory_order_relaxed);
+
+        // 按显示刷新率发布位映像
+        if (nowNs - lastPublishNs >= qint64(PublishInterval) * 1000000) {
+            lastPublishNs = nowNs;
+            QMutexLocker locker(&m_mutex);
+            m_published = memory.bits;
+            m_hasSnapshot = true;
+        }
+
+        // 等待下一个扫描周期；落后超过一个周期时不追赶
+        const qint64 periodNs = qint64(m_periodMs.load()) * 1000000;
+        nextScanNs += periodNs;
+        const qint64 remainingNs = nextScanNs - clock.nsecsElapsed();
+        if (remainingNs > 0) {
+            QThread::usleep(static_cast<unsigned long>(remainingNs / 1000));
+        } else if (-remainingNs > periodNs) {
+            nextScanNs = clock.nsecsElapsed();
+        }
+    }
+
+    // 停止时发布最终状态
+    QMutexLocker locker(&m_mutex);
+    m_published = memory.bits;
+    m_hasSnapshot = true;
+}
+
+} // namespace LadderDiagram
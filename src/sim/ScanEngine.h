@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+#include <QtCore/QPair>
+#include <atomic>
+#include <memory>
+#include "SimProgram.h"
+
+class QThread;
+
+namespace LadderDiagram {
+
+// 扫描周期仿真引擎 - 在工作线程上按固定周期循环执行 SimProgram
+//
+// 界面线程通过 writeBit/toggleBit 强制输入（在下一次扫描开始时生效），
+// 并以显示刷新率调用 takeSnapshot 读取位映像；引擎只按发布间隔
+// 复制位映像，不会每次扫描都向界面发送数据。
+class ScanEngine : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int MinScanPeriod = 1;         // ms
+    static constexpr int MaxScanPeriod = 100;       // ms
+    static constexpr int PublishInterval = 33;      // ms，约30帧/秒
+
+    explicit ScanEngine(QObject* parent = nullptr);
+    ~ScanEngine();
+
+    // 启动/停止仿真（启动时复制程序并重置内存映像）
+    void start(const SimProgram& program);
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    // 扫描周期（毫秒，限制在 1~100）
+    void setScanPeriod(int ms);
+    int scanPeriod() const { return m_periodMs.load(); }
+
+    // 强制位
+    void writeBit(int slot, bool value);
+    void toggleBit(int slot);
+
+    // 取最新发布的位映像；自上次读取后没有新数据时返回 false
+    bool takeSnapshot(QVector<quint64>& bits);
+
+    // 已执行的扫描次数
+    quint64 scanCount() const { return m_scanCount.load(); }
+
+signals:
+    // 扫描异常（如后向跳转导致超出指令预算），引擎已停止扫描
+    void faulted(const QString& message);
+
+private:
+    void run();
+
+    std::shared_ptr<const SimProgram> m_program;
+    QThread* m_thread = nullptr;
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<int> m_periodMs{10};
+    std::atomic<quint64> m_scanCount{0};
+
+    // 以下成员由 m_mutex 保护
+    QMutex m_mutex;
+    QVector<QPair<int, int>> m_pendingWrites;       // 槽位 -> 0/1，-1 表示取反
+    QVector<quint64> m_published;
+    bool m_hasSnapshot = false;
+};
+
+} // namespace LadderDiagram
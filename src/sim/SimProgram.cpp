@@ -0,0 +1,512 @@
+#include "SimProgram.h"
+#include "../codegen/PowerFlowGraph.h"
+#include "../codegen/STCodeGenerator.h"
+#include <QtCore/QBuffer>
+#include <limits>
+
+namespace LadderDiagram {
+
+namespace {
+
+SimTimer::Kind timerKind(const ElementData& element, ElementType type) {
+    if (type == ElementType::TimerTOF) return SimTimer::TOF;
+    if (type == ElementType::TimerTP) return SimTimer::TP;
+    switch (element.parameter("timer_type").toInt()) {
+        case 1: return SimTimer::TOF;
+        case 2: return SimTimer::TP;
+        default: return SimTimer::TON;
+    }
+}
+
+SimCounter::Kind counterKind(const ElementData& element, ElementType type) {
+    if (type == ElementType::CounterCTD) return SimCounter::CTD;
+    if (type == ElementType::CounterCTUD) return SimCounter::CTUD;
+    switch (element.parameter("counter_type").toInt()) {
+        case 1: return SimCounter::CTD;
+        case 2: return SimCounter::CTUD;
+        default: return SimCounter::CTU;
+    }
+}
+
+} // namespace
+
+bool SimProgram::compileJson(const QByteArray& json) {
+    QByteArray bytes = json;
+    QBuffer buffer(&bytes);
+    if (!buffer.open(QIODevice::ReadOnly)) return false;
+
+    LadderModel model;
+    if (!model.readJson(&buffer)) return false;
+
+    compile(model.elements, model.connections);
+    return true;
+}
+
+int SimProgram::allocBits(int count) {
+    int slot = m_bitCount;
+    m_bitCount += count;
+    return slot;
+}
+
+int SimProgram::bitSymbol(const QString& name) {
+    auto it = m_bitSymbols.constFind(name);
+    if (it != m_bitSymbols.constEnd()) return it.value();
+    int slot = allocBits(1);
+    m_bitSymbols.insert(name, slot);
+    return slot;
+}
+
+int SimProgram::wordOperand(const QString& text) {
+    QString operand = text.trimmed();
+    if (operand.isEmpty()) operand = "0";
+
+    bool isLiteral = false;
+    const int value = operand.toInt(&isLiteral);
+    // 常量以 '#' 前缀与变量区分，相同常量共用一个槽位
+    const QString key = isLiteral ? "#" + QString::number(value) : operand;
+
+    auto it = m_wordSymbols.constFind(key);
+    if (it != m_wordSymbols.constEnd()) return it.value();
+
+    int slot = m_initial.words.size();
+    m_initial.words.append(isLiteral ? value : 0);
+    m_wordSymbols.insert(key, slot);
+    return slot;
+}
+
+void SimProgram::append(SimOp op, int a, int b, int c, int sub) {
+    SimInstruction instruction;
+    instruction.op = op;
+    instruction.sub = static_cast<quint8>(sub);
+    instruction.a = a;
+    instruction.b = b;
+    instruction.c = c;
+    m_code.append(instruction);
+}
+
+void SimProgram::compile(const QList<ElementData>& elements, const QList<ConnectionData>& connections) {
+    m_code.clear();
+    m_initial = SimMemory();
+    m_bitSymbols.clear();
+    m_wordSymbols.clear();
+    m_elementBits.clear();
+    m_operandBits.clear();
+    m_bitCount = 2;     // FalseBit, TrueBit
+
+    QHash<QString, int> labelAddress;
+    QVector<QPair<int, QString>> jumps;
+
+    const QList<LadderNetwork> networks = STCodeGenerator::splitNetworks(elements, connections);
+    for (const LadderNetwork& network : networks) {
+        PowerFlowGraph flow;
+        flow.build(network.elements, network.connections);
+
+        for (int e = 0; e < flow.elementCount(); ++e) {
+            if (flow.elementType(e) == ElementType::Label) {
+                labelAddress.insert(network.elements[e].name, m_code.size());
+            }
+        }
+
+        // 网络开始：清零节点位，左电源轨节点置位
+        const int netBase = allocBits(flow.netCount());
+        if (flow.netCount() > 0) {
+            append(SimOp::ClearRange, netBase, flow.netCount());
+        }
+        if (flow.sourceNet() != PowerFlowGraph::NoNet) {
+            append(SimOp::Load, TrueBit);
+            append(SimOp::Store, netBase + flow.sourceNet());
+        }
+
+        auto netBit = [&](int element, int pin) {
+            int net = flow.pinNet(element, pin);
+            return net == PowerFlowGraph::NoNet ? int(FalseBit) : netBase + net;
+        };
+        auto driveOutput = [&](int element, int pin) {
+            if (flow.pinNet(element, pin) != PowerFlowGraph::NoNet) {
+                append(SimOp::OrStore, netBit(element, pin));
+            }
+        };
+
+        const QVector<int> order = flow.schedule();
+        for (int e : order) {
+            const auto& element = network.elements[e];
+            const ElementType type = flow.elementType(e);
+            const QString& id = element.id;
+            const auto& properties = element.properties;
+
+            if (type == ElementType::LeftPowerRail) {
+                m_elementBits.insert(id, TrueBit);
+                continue;
+            }
+            if (type == ElementType::RightPowerRail) {
+                if (flow.sinkNet() != PowerFlowGraph::NoNet) {
+                    m_elementBits.insert(id, netBase + flow.sinkNet());
+                }
+                continue;
+            }
+            if (type == ElementType::Label || PowerFlowGraph::pinCount(type) == 0) {
+                continue;
+            }
+
+            const int powered = allocBits(1);
+            m_elementBits.insert(id, powered);
+
+            switch (type) {
+                case ElementType::NormallyOpen:
+                case ElementType::NormallyClosed:
+                case ElementType::PositiveEdge:
+                case ElementType::NegativeEdge: {
+                    const int operand = bitSymbol(STCodeGenerator::operandName(element));
+                    m_operandBits.insert(id, operand);
+                    append(type == ElementType::NormallyClosed ? SimOp::LoadNot : SimOp::Load, operand);
+                    if (type == ElementType::PositiveEdge) append(SimOp::EdgeRise, allocBits(1));
+                    if (type == ElementType::NegativeEdge) append(SimOp::EdgeFall, allocBits(1));
+                    append(SimOp::And, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 1);
+                    break;
+                }
+
+                case ElementType::ComparisonContact:
+                case ElementType::Comparison: {
+                    int op = element.parameter("compare_op").toInt();
+                    append(SimOp::Compare, wordOperand(properties.value("in1").toString()),
+                           wordOperand(properties.value("in2").toString()), 0, op);
+                    append(SimOp::And, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 1);
+                    break;
+                }
+
+                case ElementType::OutputCoil:
+                case ElementType::InvertedCoil:
+                case ElementType::SetCoil:
+                case ElementType::ResetCoil:
+                case ElementType::PositiveEdgeCoil:
+                case ElementType::NegativeEdgeCoil: {
+                    // 输入未接入能流的线圈不驱动变量（与ST生成一致）
+                    if (flow.pinNet(e, 0) == PowerFlowGraph::NoNet) break;
+                    const int operand = bitSymbol(STCodeGenerator::operandName(element));
+                    m_operandBits.insert(id, operand);
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    switch (type) {
+                        case ElementType::OutputCoil: append(SimOp::Store, operand); break;
+                        case ElementType::InvertedCoil: append(SimOp::StoreNot, operand); break;
+                        case ElementType::SetCoil: append(SimOp::SetIf, operand); break;
+                        case ElementType::ResetCoil: append(SimOp::ResetIf, operand); break;
+                        case ElementType::PositiveEdgeCoil:
+                            append(SimOp::EdgeRise, allocBits(1));
+                            append(SimOp::Store, operand);
+                            append(SimOp::Load, powered);
+                            break;
+                        default:
+                            append(SimOp::EdgeFall, allocBits(1));
+                            append(SimOp::Store, operand);
+                            append(SimOp::Load, powered);
+                            break;
+                    }
+                    driveOutput(e, 1);
+                    break;
+                }
+
+                case ElementType::Timer:
+                case ElementType::TimerTOF:
+                case ElementType::TimerTP: {
+                    SimTimer timer;
+                    timer.kind = timerKind(element, type);
+                    timer.presetUs = qint64(properties.value("preset", 100).toInt()) * 1000;
+                    const int index = m_initial.timers.size();
+                    m_initial.timers.append(timer);
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Timer, index, netBit(e, 2));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 1);
+                    break;
+                }
+
+                case ElementType::Counter:
+                case ElementType::CounterCTD:
+                case ElementType::CounterCTUD: {
+                    SimCounter counter;
+                    counter.kind = counterKind(element, type);
+                    counter.preset = properties.value("preset", 10).toInt();
+                    const int index = m_initial.counters.size();
+                    m_initial.counters.append(counter);
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Counter, index, netBit(e, 1), netBit(e, 2));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 3);
+                    break;
+                }
+
+                case ElementType::RTrig:
+                case ElementType::FTrig:
+                    append(SimOp::Load, netBit(e, 0));
+                    append(type == ElementType::RTrig ? SimOp::EdgeRise : SimOp::EdgeFall, allocBits(1));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 1);
+                    break;
+
+                case ElementType::RS:
+                case ElementType::SR:
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Bistable, allocBits(1), netBit(e, 1), 0,
+                           type == ElementType::SR ? 1 : 0);
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 2);
+                    break;
+
+                case ElementType::MathOperation: {
+                    int op = element.parameter("math_op").toInt();
+                    QString out = properties.value("out").toString().trimmed();
+                    if (out.isEmpty()) out = STCodeGenerator::operandName(element);
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    append(SimOp::Math, wordOperand(properties.value("in1").toString()),
+                           wordOperand(properties.value("in2").toString()), wordOperand(out), op);
+                    driveOutput(e, 2);
+                    break;
+                }
+
+                case ElementType::LogicAND:
+                case ElementType::LogicOR:
+                    append(SimOp::Load, netBit(e, 0));
+                    append(type == ElementType::LogicAND ? SimOp::And : SimOp::Or, netBit(e, 1));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 2);
+                    break;
+
+                case ElementType::LogicNOT:
+                    append(SimOp::LoadNot, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    driveOutput(e, 1);
+                    break;
+
+                case ElementType::Jump: {
+                    QString target = element.parameter("target_label").toString();
+                    if (target.isEmpty()) target = properties.value("target_label").toString();
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    jumps.append(qMakePair(int(m_code.size()), target));
+                    append(SimOp::JumpIf, 0);
+                    break;
+                }
+
+                case ElementType::Return:
+                    append(SimOp::Load, netBit(e, 0));
+                    append(SimOp::Store, powered);
+                    append(SimOp::ReturnIf);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    append(SimOp::End);
+
+    // 回填跳转地址；目标标签不存在时跳转不起作用
+    for (const auto& jump : jumps) {
+        m_code[jump.first].a = labelAddress.value(jump.second, jump.first + 1);
+    }
+
+    m_initial.bits.fill(0, (m_bitCount + 63) / 64);
+    m_initial.setBit(TrueBit, true);
+}
+
+bool SimProgram::scan(SimMemory& memory, qint64 elapsedUs) const {
+    const SimInstruction* code = m_code.constData();
+    const int size = m_code.size();
+    quint64* bits = memory.bits.data();
+    qint32* words = memory.words.data();
+
+    auto get = [bits](int slot) -> bool {
+        return (bits[slot >> 6] >> (slot & 63)) & 1u;
+    };
+    auto put = [bits](int slot, bool value) {
+        const quint64 mask = quint64(1) << (slot & 63);
+        bits[slot >> 6] = value ? (bits[slot >> 6] | mask) : (bits[slot >> 6] & ~mask);
+    };
+
+    // 指令预算：防止后向跳转造成死循环
+    qint64 budget = qint64(size) * 8 + 64;
+    bool acc = false;
+    int pc = 0;
+
+    while (pc < size) {
+        if (--budget < 0) return false;
+        const SimInstruction& in = code[pc++];
+
+        switch (in.op) {
+            case SimOp::Load: acc = get(in.a); break;
+            case SimOp::LoadNot: acc = !get(in.a); break;
+            case SimOp::And: acc = acc && get(in.a); break;
+            case SimOp::AndNot: acc = acc && !get(in.a); break;
+            case SimOp::Or: acc = acc || get(in.a); break;
+            case SimOp::Store: put(in.a, acc); break;
+            case SimOp::StoreNot: put(in.a, !acc); break;
+            case SimOp::OrStore: if (acc) put(in.a, true); break;
+            case SimOp::SetIf: if (acc) put(in.a, true); break;
+            case SimOp::ResetIf: if (acc) put(in.a, false); break;
+
+            case SimOp::ClearRange:
+                for (int slot = in.a; slot < in.a + in.b; ++slot) put(slot, false);
+                break;
+
+            case SimOp::EdgeRise: {
+                const bool last = get(in.a);
+                put(in.a, acc);
+                acc = acc && !last;
+                break;
+            }
+
+            case SimOp::EdgeFall: {
+                const bool last = get(in.a);
+                put(in.a, acc);
+                acc = !acc && last;
+                break;
+            }
+
+            case SimOp::Compare: {
+                const qint32 x = words[in.a];
+                const qint32 y = words[in.b];
+                switch (in.sub) {
+                    case 1: acc = x != y; break;
+                    case 2: acc = x > y; break;
+                    case 3: acc = x >= y; break;
+                    case 4: acc = x < y; break;
+                    case 5: acc = x <= y; break;
+                    default: acc = x == y; break;
+                }
+                break;
+            }
+
+            case SimOp::Math: {
+                if (!acc) break;
+                const qint64 x = words[in.a];
+                const qint64 y = words[in.b];
+                switch (in.sub) {
+                    case 1: words[in.c] = static_cast<qint32>(x - y); break;
+                    case 2: words[in.c] = static_cast<qint32>(x * y); break;
+                    case 3: if (y != 0) words[in.c] = static_cast<qint32>(x / y); break;
+                    default: words[in.c] = static_cast<qint32>(x + y); break;
+                }
+                break;
+            }
+
+            case SimOp::Timer: {
+                SimTimer& timer = memory.timers[in.a];
+                if (get(in.b)) {
+                    timer.q = false;
+                    timer.running = false;
+                    timer.elapsedUs = 0;
+                } else {
+                    switch (timer.kind) {
+                        case SimTimer::TON:
+                            if (!acc) {
+                                timer.elapsedUs = 0;
+                            } else if (timer.lastIn) {
+                                timer.elapsedUs = qMin(timer.presetUs, timer.elapsedUs + elapsedUs);
+                            }
+                            timer.q = acc && timer.elapsedUs >= timer.presetUs;
+                            break;
+                        case SimTimer::TOF:
+                            if (acc) {
+                                timer.q = true;
+                                timer.running = false;
+                                timer.elapsedUs = 0;
+                            } else if (timer.lastIn) {
+                                timer.running = true;
+                                timer.elapsedUs = 0;
+                            } else if (timer.running) {
+                                timer.elapsedUs += elapsedUs;
+                                if (timer.elapsedUs >= timer.presetUs) {
+                                    timer.elapsedUs = timer.presetUs;
+                                    timer.running = false;
+                                    timer.q = false;
+                                }
+                            }
+                            break;
+                        case SimTimer::TP:
+                            if (acc && !timer.lastIn && !timer.running) {
+                                timer.running = true;
+                                timer.elapsedUs = 0;
+                                timer.q = true;
+                            } else if (timer.running) {
+                                timer.elapsedUs += elapsedUs;
+                                if (timer.elapsedUs >= timer.presetUs) {
+                                    timer.elapsedUs = timer.presetUs;
+                                    timer.running = false;
+                                    timer.q = false;
+                                }
+                            }
+                            break;
+                    }
+                }
+                timer.lastIn = acc;
+                acc = timer.q;
+                break;
+            }
+
+            case SimOp::Counter: {
+                SimCounter& counter = memory.counters[in.a];
+                const bool down = get(in.b);
+                const bool reset = get(in.c);
+                const bool upEdge = acc && !counter.lastUp;
+                const bool downEdge = down && !counter.lastDown;
+                counter.lastUp = acc;
+                counter.lastDown = down;
+
+                switch (counter.kind) {
+                    case SimCounter::CTU:
+                        if (reset) counter.value = 0;
+                        else if (upEdge && counter.value < std::numeric_limits<qint32>::max()) counter.value++;
+                        counter.q = counter.value >= counter.preset;
+                        break;
+                    case SimCounter::CTD:
+                        // CTD 的计数输入接在第一个引脚，复位引脚作为装载(LD)
+                        if (reset) counter.value = counter.preset;
+                        else if (upEdge && counter.value > std::numeric_limits<qint32>::min()) counter.value--;
+                        counter.q = counter.value <= 0;
+                        break;
+                    case SimCounter::CTUD:
+                        if (reset) {
+                            counter.value = 0;
+                        } else {
+                            if (upEdge && counter.value < std::numeric_limits<qint32>::max()) counter.value++;
+                            if (downEdge && counter.value > std::numeric_limits<qint32>::min()) counter.value--;
+                        }
+                        counter.q = counter.value >= counter.preset;
+                        break;
+                }
+                acc = counter.q;
+                break;
+            }
+
+            case SimOp::Bistable: {
+                const bool reset = get(in.b);
+                const bool q = get(in.a);
+                // RS 复位优先，SR 置位优先
+                acc = in.sub == 0 ? (!reset && (acc || q)) : (acc || (!reset && q));
+                put(in.a, acc);
+                break;
+            }
+
+            case SimOp::JumpIf:
+                if (acc) pc = in.a;
+                break;
+
+            case SimOp::ReturnIf:
+                if (acc) return true;
+                break;
+
+            case SimOp::End:
+                return true;
+        }
+    }
+    return true;
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <QtCore/QByteArray>
+#include "../core/LadderModel.h"
+
+namespace LadderDiagram {
+
+// 仿真指令操作码（单一累加器 acc 的位逻辑机）
+enum class SimOp : quint8 {
+    Load,           // acc = bit[a]
+    LoadNot,        // acc = !bit[a]
+    And,            // acc &= bit[a]
+    AndNot,         // acc &= !bit[a]
+    Or,             // acc |= bit[a]
+    Store,          // bit[a] = acc
+    StoreNot,       // bit[a] = !acc
+    OrStore,        // bit[a] |= acc
+    SetIf,          // if (acc) bit[a] = 1
+    ResetIf,        // if (acc) bit[a] = 0
+    ClearRange,     // bit[a .. a+b) = 0
+    EdgeRise,       // acc = acc && !bit[a]; bit[a] = 旧acc
+    EdgeFall,       // acc = !acc && bit[a]; bit[a] = 旧acc
+    Compare,        // acc = word[a] <sub> word[b]
+    Math,           // if (acc) word[c] = word[a] <sub> word[b]
+    Timer,          // 定时器 a，acc = IN，b = 复位位；结果 acc = Q
+    Counter,        // 计数器 a，acc = CU，b = CD 位，c = 复位位；结果 acc = Q
+    Bistable,       // RS/SR，a = Q1 位，acc = 置位，b = 复位位，sub 0=RS 1=SR；结果 acc = Q1
+    JumpIf,         // if (acc) pc = a
+    ReturnIf,       // if (acc) 结束本次扫描
+    End
+};
+
+// 仿真指令（16字节定长，连续存放）
+struct SimInstruction {
+    SimOp op = SimOp::End;
+    quint8 sub = 0;
+    qint32 a = 0;
+    qint32 b = 0;
+    qint32 c = 0;
+};
+
+// 定时器运行状态
+struct SimTimer {
+    enum Kind : quint8 { TON, TOF, TP };
+    Kind kind = TON;
+    bool q = false;
+    bool running = false;
+    bool lastIn = false;
+    qint64 presetUs = 0;
+    qint64 elapsedUs = 0;
+};
+
+// 计数器运行状态
+struct SimCounter {
+    enum Kind : quint8 { CTU, CTD, CTUD };
+    Kind kind = CTU;
+    bool q = false;
+    bool lastUp = false;
+    bool lastDown = false;
+    qint32 preset = 0;
+    qint32 value = 0;
+};
+
+// 仿真内存映像：位区按64位打包，字区为 INT
+struct SimMemory {
+    QVector<quint64> bits;
+    QVector<qint32> words;
+    QVector<SimTimer> timers;
+    QVector<SimCounter> counters;
+
+    bool bit(int slot) const { return (bits[slot >> 6] >> (slot & 63)) & 1u; }
+    void setBit(int slot, bool value) {
+        const quint64 mask = quint64(1) << (slot & 63);
+        if (value) bits[slot >> 6] |= mask;
+        else bits[slot >> 6] &= ~mask;
+    }
+};
+
+// 仿真程序 - 把梯形图网络编译为扁平指令序列
+//
+// 每个网络按能流节点的依赖顺序展开：网络开始时清零其节点位，
+// 元件读取输入节点、写入自身的通电位与输出节点。变量位、节点位、
+// 元件通电位与边沿记忆位共用一个位映像，比较/运算操作数使用字映像。
+class SimProgram {
+public:
+    // 位映像中的常量位
+    static constexpr int FalseBit = 0;
+    static constexpr int TrueBit = 1;
+
+    // 由 .ldjson 数据编译
+    bool compileJson(const QByteArray& json);
+
+    // 由元件与连接线编译
+    void compile(const QList<ElementData>& elements, const QList<ConnectionData>& connections);
+
+    const QVector<SimInstruction>& instructions() const { return m_code; }
+
+    // 初始内存映像
+    SimMemory createMemory() const { return m_initial; }
+
+    // 执行一次扫描；超出指令预算（如后向跳转死循环）时返回 false
+    bool scan(SimMemory& memory, qint64 elapsedUs) const;
+
+    // 变量位槽位（不存在时为 -1）
+    int bitSlot(const QString& name) const { return m_bitSymbols.value(name, -1); }
+
+    // 元件通电位槽位（按元件ID，不参与仿真的元件为 -1）
+    int elementSlot(const QString& elementId) const { return m_elementBits.value(elementId, -1); }
+
+    // 元件的主操作数位（触点/线圈），用于在界面上强制输入
+    int operandSlot(const QString& elementId) const { return m_operandBits.value(elementId, -1); }
+
+private:
+    int allocBits(int count);
+    int bitSymbol(const QString& name);
+    int wordOperand(const QString& text);
+    void append(SimOp op, int a = 0, int b = 0, int c = 0, int sub = 0);
+
+    QVector<SimInstruction> m_code;
+    SimMemory m_initial;
+    int m_bitCount = 0;
+
+    QHash<QString, int> m_bitSymbols;
+    QHash<QString, int> m_wordSymbols;
+    QHash<QString, int> m_elementBits;
+    QHash<QString, int> m_operandBits;
+};
+
+} // namespace LadderDiagram
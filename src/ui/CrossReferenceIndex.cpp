@@ -0,0 +1,175 @@
+#include "CrossReferenceIndex.h"
+#include "../core/LadderElement.h"
+
+namespace LadderDiagram {
+
+namespace {
+
+// 操作数是否为变量（数字常量不登记）
+bool isVariable(const QString& operand) {
+    if (operand.isEmpty()) return false;
+    bool ok = false;
+    operand.toDouble(&ok);
+    return !ok;
+}
+
+void appendOperand(QList<QPair<QString, CrossReferenceIndex::Access>>& operands,
+                   const QString& text, CrossReferenceIndex::Access access) {
+    const QString operand = text.trimmed();
+    if (!isVariable(operand)) return;
+    for (const auto& existing : operands) {
+        if (existing.second == access && existing.first.compare(operand, Qt::CaseInsensitive) == 0) return;
+    }
+    operands.append({operand, access});
+}
+
+} // namespace
+
+QList<QPair<QString, CrossReferenceIndex::Access>> CrossReferenceIndex::operandsOf(const LadderElement* element) {
+    QList<QPair<QString, Access>> operands;
+    auto own = [&](Access access) {
+        appendOperand(operands, element->name(), access);
+        appendOperand(operands, element->address(), access);
+    };
+    
+    switch (element->elementType()) {
+        case ElementType::NormallyOpen:
+        case ElementType::NormallyClosed:
+        case ElementType::PositiveEdge:
+        case ElementType::NegativeEdge:
+            own(Access::Read);
+            break;
+            
+        case ElementType::OutputCoil:
+        case ElementType::InvertedCoil:
+        case ElementType::PositiveEdgeCoil:
+        case ElementType::NegativeEdgeCoil:
+            own(Access::Write);
+            break;
+            
+        case ElementType::SetCoil:
+        case ElementType::ResetCoil:
+            own(Access::SetReset);
+            break;
+            
+        case ElementType::Timer:
+        case ElementType::TimerTOF:
+        case ElementType::TimerTP:
+        case ElementType::Counter:
+        case ElementType::CounterCTD:
+        case ElementType::CounterCTUD:
+        case ElementType::RTrig:
+        case ElementType::FTrig:
+        case ElementType::RS:
+        case ElementType::SR:
+            own(Access::Instance);
+            break;
+            
+        case ElementType::ComparisonContact:
+        case ElementType::Comparison:
+            appendOperand(operands, element->getProperty("in1").toString(), Access::Read);
+            appendOperand(operands, element->getProperty("in2").toString(), Access::Read);
+            break;
+            
+        case ElementType::MathOperation: {
+            appendOperand(operands, element->getProperty("in1").toString(), Access::Read);
+            appendOperand(operands, element->getProperty("in2").toString(), Access::Read);
+            const QString out = element->getProperty("out").toString().trimmed();
+            if (out.isEmpty()) {
+                own(Access::Write);
+            } else {
+                appendOperand(operands, out, Access::Write);
+            }
+            break;
+        }
+            
+        default:
+            break;
+    }
+    return operands;
+}
+
+bool CrossReferenceIndex::isCoilWrite(const Reference& reference) {
+    return reference.access == Access::Write
+        && reference.element->elementType() != ElementType::MathOperation;
+}
+
+void CrossReferenceIndex::addElement(LadderElement* element) {
+    if (m_keysOf.contains(element)) return;
+    
+    QStringList keys;
+    for (const auto& operand : operandsOf(element)) {
+        const QString key = keyOf(operand.first);
+        Entry& entry = m_symbols[key];
+        if (entry.references.isEmpty()) {
+            entry.display = operand.first;
+        }
+        const Reference reference{element, operand.second};
+        entry.references.append(reference);
+        if (isCoilWrite(reference) && ++entry.coilWrites == 2) {
+            m_multiCoil.insert(key);
+        }
+        keys.append(key);
+    }
+    m_keysOf.insert(element, keys);
+}
+
+void CrossReferenceIndex::removeElement(LadderElement* element) {
+    const QStringList keys = m_keysOf.take(element);
+    for (const QString& key : keys) {
+        auto it = m_symbols.find(key);
+        if (it == m_symbols.end()) continue;
+        
+        Entry& entry = it.value();
+        for (int i = 0; i < entry.references.size(); ++i) {
+            if (entry.references[i].element != element) continue;
+            if (isCoilWrite(entry.references[i]) && --entry.coilWrites == 1) {
+                m_multiCoil.remove(key);
+            }
+            entry.references.removeAt(i);
+            break;
+        }
+        if (entry.references.isEmpty()) {
+            m_symbols.erase(it);
+        }
+    }
+}
+
+void CrossReferenceIndex::elementChanged(LadderElement* element) {
+    if (!m_keysOf.contains(element)) return;
+    removeElement(element);
+    addElement(element);
+}
+
+void CrossReferenceIndex::clear() {
+    m_symbols.clear();
+    m_keysOf.clear();
+    m_multiCoil.clear();
+}
+
+QList<CrossReferenceIndex::Reference> CrossReferenceIndex::references(const QString& symbol) const {
+    auto it = m_symbols.constFind(keyOf(symbol));
+    return it != m_symbols.constEnd() ? it->references : QList<Reference>();
+}
+
+QString CrossReferenceIndex::displayName(const QString& symbol) const {
+    auto it = m_symbols.constFind(keyOf(symbol));
+    return it != m_symbols.constEnd() ? it->display : symbol;
+}
+
+QStringList CrossReferenceIndex::find(const QString& prefix, int limit) const {
+    // 键有序，前缀匹配的键连续排列
+    const QString key = keyOf(prefix.trimmed());
+    QStringList result;
+    for (auto it = m_symbols.lowerBound(key); it != m_symbols.constEnd() && result.size() < limit; ++it) {
+        if (!it.key().startsWith(key)) break;
+        result.append(it.key());
+    }
+    return result;
+}
+
+QStringList CrossReferenceIndex::multiCoilSymbols() const {
+    return QStringList(m_multiCoil.begin(), m_multiCoil.end());
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "../core/ElementTypes.h"
+
+namespace LadderDiagram {
+
+class LadderElement;
+
+// 变量交叉引用索引：每个变量/地址在哪些元件中被读、写或作为实例使用
+//
+// 元件的名称和地址都作为变量登记（不区分大小写），比较/运算元件另外登记
+// in1/in2（读）与 out（写）操作数。元件增删或内容变化时只重新登记该元件。
+// 同一变量被两个以上的输出线圈写入时记为双线圈候选，是否跨网络由场景判断。
+class CrossReferenceIndex {
+public:
+    enum class Access {
+        Read,       // 触点、比较输入
+        Write,      // 输出线圈、运算结果
+        SetReset,   // 置位/复位线圈（允许多处）
+        Instance    // 定时器、计数器、功能块实例
+    };
+
+    struct Reference {
+        LadderElement* element = nullptr;
+        Access access = Access::Read;
+    };
+
+    void addElement(LadderElement* element);
+    void removeElement(LadderElement* element);
+    void elementChanged(LadderElement* element);
+    void clear();
+
+    // 按变量名查找（不区分大小写）
+    QList<Reference> references(const QString& symbol) const;
+    QString displayName(const QString& symbol) const;
+
+    // 以 prefix 开头的变量，按名称排序，最多 limit 个
+    QStringList find(const QString& prefix, int limit) const;
+    int symbolCount() const { return m_symbols.size(); }
+
+    // 被多个输出线圈写入的变量
+    QStringList multiCoilSymbols() const;
+
+    // 是否为线圈写入（运算结果不算线圈，同一变量可在多处计算）
+    static bool isCoilWrite(const Reference& reference);
+
+    // 元件引用的变量及访问方式
+    static QList<QPair<QString, Access>> operandsOf(const LadderElement* element);
+
+private:
+    struct Entry {
+        QString display;                // 首次登记时的写法
+        QList<Reference> references;
+        int coilWrites = 0;
+    };
+
+    static QString keyOf(const QString& symbol) { return symbol.toUpper(); }
+
+    QMap<QString, Entry> m_symbols;                 // 变量键 -> 引用
+    QHash<LadderElement*, QStringList> m_keysOf;    // 元件 -> 登记过的变量键
+    QSet<QString> m_multiCoil;
+};
+
+} // namespace LadderDiagram
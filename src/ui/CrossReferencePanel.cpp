@@ -0,0 +1,174 @@
+#include "CrossReferencePanel.h"
+#include <QVBoxLayout>
+#include <QHeaderView>
+
+namespace LadderDiagram {
+
+namespace {
+
+constexpr int ElementRole = Qt::UserRole;
+constexpr int SymbolRole = Qt::UserRole + 1;
+
+} // namespace
+
+CrossReferencePanel::CrossReferencePanel(LadderScene* scene, QWidget* parent)
+    : QWidget(parent)
+    , m_scene(scene)
+{
+    setupUI();
+    
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(0);
+    connect(m_refreshTimer, &QTimer::timeout, this, &CrossReferencePanel::refresh);
+    connect(m_scene, &LadderScene::contentChanged, this, &CrossReferencePanel::scheduleRefresh);
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &CrossReferencePanel::refresh);
+    connect(m_tree, &QTreeWidget::itemActivated, this, &CrossReferencePanel::onItemActivated);
+    connect(m_tree, &QTreeWidget::itemClicked, this, &CrossReferencePanel::onItemActivated);
+}
+
+void CrossReferencePanel::setupUI() {
+    setWindowTitle(tr("交叉引用"));
+    
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    
+    m_filterEdit = new QLineEdit();
+    m_filterEdit->setPlaceholderText(tr("输入变量名或地址，如 Y0"));
+    m_filterEdit->setClearButtonEnabled(true);
+    layout->addWidget(m_filterEdit);
+    
+    m_tree = new QTreeWidget();
+    m_tree->setObjectName("crossReferenceTree");
+    m_tree->setColumnCount(4);
+    m_tree->setHeaderLabels({tr("变量/元件"), tr("访问"), tr("梯级"), tr("位置")});
+    m_tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_tree->setUniformRowHeights(true);
+    layout->addWidget(m_tree, 1);
+    
+    m_summaryLabel = new QLabel();
+    layout->addWidget(m_summaryLabel);
+}
+
+void CrossReferencePanel::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    refresh();
+}
+
+void CrossReferencePanel::scheduleRefresh() {
+    if (isVisible()) m_refreshTimer->start();
+}
+
+void CrossReferencePanel::refresh() {
+    if (!isVisible()) return;
+    
+    const CrossReferenceIndex& index = m_scene->crossReferences();
+    const QStringList doubleCoils = m_scene->doubleCoils();
+    const QSet<QString> flagged(doubleCoils.begin(), doubleCoils.end());
+    
+    // 保留展开状态
+    QSet<QString> expanded;
+    for (int i = 0; i < m_tree->topLevelItemCount(); ++i) {
+        QTreeWidgetItem* item = m_tree->topLevelItem(i);
+        if (item->isExpanded()) expanded.insert(item->data(0, SymbolRole).toString());
+    }
+    
+    m_tree->setUpdatesEnabled(false);
+    m_tree->clear();
+    
+    const QStringList symbols = index.find(m_filterEdit->text(), MaxSymbols);
+    for (const QString& symbol : symbols) {
+        const auto references = index.references(symbol);
+        
+        QTreeWidgetItem* symbolItem = new QTreeWidgetItem(m_tree);
+        symbolItem->setText(0, index.displayName(symbol));
+        symbolItem->setText(1, tr("%1 处").arg(references.size()));
+        symbolItem->setData(0, SymbolRole, symbol);
+        if (flagged.contains(symbol)) {
+            symbolItem->setText(1, tr("双线圈"));
+            symbolItem->setForeground(0, Qt::red);
+            symbolItem->setForeground(1, Qt::red);
+            symbolItem->setToolTip(0, tr("该变量在多个网络中被输出线圈写入"));
+        }
+        
+        for (const auto& ref : references) {
+            QTreeWidgetItem* item = new QTreeWidgetItem(symbolItem);
+            const QString label = ref.element->name().isEmpty() ? ref.element->address() : ref.element->name();
+            item->setText(0, QString("%1 %2").arg(kindText(ref.element->elementType()), label));
+            item->setText(1, accessText(ref.access));
+            const int rung = m_scene->rungOf(ref.element);
+            item->setText(2, rung > 0 ? QString::number(rung) : QString("-"));
+            item->setText(3, QString("(%1, %2)").arg(ref.element->x()).arg(ref.element->y()));
+            item->setData(0, ElementRole, QVariant::fromValue(static_cast<void*>(ref.element)));
+            if (flagged.contains(symbol) && CrossReferenceIndex::isCoilWrite(ref)) {
+                item->setForeground(1, Qt::red);
+            }
+        }
+        
+        // 精确匹配或原先展开的变量直接展开
+        if (expanded.contains(symbol) || symbols.size() == 1) {
+            symbolItem->setExpanded(true);
+        }
+    }
+    
+    m_tree->setUpdatesEnabled(true);
+    
+    QString summary = tr("%1 个变量").arg(index.symbolCount());
+    if (symbols.size() >= MaxSymbols) {
+        summary += tr("，仅显示前 %1 个").arg(MaxSymbols);
+    }
+    if (!doubleCoils.isEmpty()) {
+        summary += tr("，双线圈: %1").arg(doubleCoils.join(", "));
+    }
+    m_summaryLabel->setText(summary);
+}
+
+void CrossReferencePanel::onItemActivated(QTreeWidgetItem* item, int column) {
+    Q_UNUSED(column)
+    auto* element = static_cast<LadderElement*>(item->data(0, ElementRole).value<void*>());
+    // 刷新前元件可能已被删除，只接受场景中仍登记的元件
+    if (element && m_scene->containsElement(element)) {
+        emit elementActivated(element);
+    }
+}
+
+QString CrossReferencePanel::accessText(CrossReferenceIndex::Access access) {
+    switch (access) {
+        case CrossReferenceIndex::Access::Read: return tr("读");
+        case CrossReferenceIndex::Access::Write: return tr("写");
+        case CrossReferenceIndex::Access::SetReset: return tr("置位/复位");
+        case CrossReferenceIndex::Access::Instance: return tr("实例");
+    }
+    return QString();
+}
+
+QString CrossReferencePanel::kindText(ElementType type) {
+    switch (type) {
+        case ElementType::NormallyOpen: return tr("常开触点");
+        case ElementType::NormallyClosed: return tr("常闭触点");
+        case ElementType::PositiveEdge: return tr("上升沿触点");
+        case ElementType::NegativeEdge: return tr("下降沿触点");
+        case ElementType::ComparisonContact: return tr("比较触点");
+        case ElementType::OutputCoil: return tr("输出线圈");
+        case ElementType::InvertedCoil: return tr("取反线圈");
+        case ElementType::SetCoil: return tr("置位线圈");
+        case ElementType::ResetCoil: return tr("复位线圈");
+        case ElementType::PositiveEdgeCoil: return tr("上升沿线圈");
+        case ElementType::NegativeEdgeCoil: return tr("下降沿线圈");
+        case ElementType::Timer:
+        case ElementType::TimerTOF:
+        case ElementType::TimerTP: return tr("定时器");
+        case ElementType::Counter:
+        case ElementType::CounterCTD:
+        case ElementType::CounterCTUD: return tr("计数器");
+        case ElementType::RTrig:
+        case ElementType::FTrig: return tr("边沿检测");
+        case ElementType::RS:
+        case ElementType::SR: return tr("触发器");
+        case ElementType::Comparison: return tr("比较");
+        case ElementType::MathOperation: return tr("运算");
+        default: return tr("元件");
+    }
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QWidget>
+#include <QLineEdit>
+#include <QTreeWidget>
+#include <QLabel>
+#include <QTimer>
+#include "LadderScene.h"
+
+namespace LadderDiagram {
+
+// 交叉引用面板：按变量列出读、写和实例引用，标出跨网络的双线圈
+class CrossReferencePanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CrossReferencePanel(LadderScene* scene, QWidget* parent = nullptr);
+
+public slots:
+    // 场景变化后合并到下一轮事件循环刷新（面板不可见时不刷新）
+    void scheduleRefresh();
+    void refresh();
+
+signals:
+    // 点击引用：定位到元件
+    void elementActivated(LadderElement* element);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
+private slots:
+    void onItemActivated(QTreeWidgetItem* item, int column);
+
+private:
+    void setupUI();
+    static QString accessText(CrossReferenceIndex::Access access);
+    static QString kindText(ElementType type);
+
+    // 列出的变量数上限（过滤条件为空时也能立即显示）
+    static constexpr int MaxSymbols = 500;
+
+    LadderScene* m_scene = nullptr;
+    QLineEdit* m_filterEdit = nullptr;
+    QTreeWidget* m_tree = nullptr;
+    QLabel* m_summaryLabel = nullptr;
+    QTimer* m_refreshTimer = nullptr;
+};
+
+} // namespace LadderDiagram
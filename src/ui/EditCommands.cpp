@@ -0,0 +1,219 @@
+#include "EditCommands.h"
+#include "LadderScene.h"
+#include "../core/LadderElement.h"
+#include "../elements/ConnectionLine.h"
+
+namespace LadderDiagram {
+
+namespace {
+
+// 图元常驻内存的粗略估算（对象本身 + 文本 + 属性）
+qsizetype elementBytes(const LadderElement* element) {
+    qsizetype bytes = 512 + (element->name().size() + element->address().size()
+                             + element->comment().size()) * qsizetype(sizeof(QChar));
+    return bytes + element->properties().size() * 64;
+}
+
+qsizetype connectionBytes(const ConnectionLine* connection) {
+    return 256 + connection->route().size() * qsizetype(sizeof(QPointF));
+}
+
+} // namespace
+
+// ===== AddItemsCommand =====
+
+AddItemsCommand::AddItemsCommand(LadderScene* scene, const QList<LadderElement*>& elements,
+                                 const QList<ConnectionLine*>& connections, const QString& text,
+                                 QUndoCommand* parent)
+    : EditCommand(text, parent)
+    , m_scene(scene)
+    , m_elements(elements)
+    , m_connections(connections)
+{
+}
+
+AddItemsCommand::~AddItemsCommand() {
+    if (m_owned) {
+        qDeleteAll(m_connections);
+        qDeleteAll(m_elements);
+    }
+}
+
+void AddItemsCommand::redo() {
+    m_scene->addItems(m_elements, m_ids, m_connections);
+    if (m_ids.isEmpty()) {
+        m_ids.reserve(m_elements.size());
+        for (auto* element : m_elements) {
+            m_ids.append(m_scene->getElementId(element));
+        }
+    }
+    m_owned = false;
+}
+
+void AddItemsCommand::undo() {
+    m_scene->removeItems(m_elements, m_connections);
+    m_owned = true;
+}
+
+qsizetype AddItemsCommand::byteSize() const {
+    qsizetype bytes = EditCommand::byteSize() + (m_elements.size() + m_connections.size()) * 8;
+    for (const QString& id : m_ids) {
+        bytes += 32 + id.size() * qsizetype(sizeof(QChar));
+    }
+    // 已执行时图元属于场景，不计入历史
+    return bytes;
+}
+
+// ===== RemoveItemsCommand =====
+
+RemoveItemsCommand::RemoveItemsCommand(LadderScene* scene, const QList<LadderElement*>& elements,
+                                       const QList<ConnectionLine*>& connections, QUndoCommand* parent)
+    : EditCommand(parent)
+    , m_scene(scene)
+    , m_elements(elements)
+{
+    // 删除元件时与之相连的连接线一并删除，撤销时一并恢复
+    QSet<ConnectionLine*> seen;
+    auto collect = [&](ConnectionLine* connection) {
+        if (!seen.contains(connection)) {
+            seen.insert(connection);
+            m_connections.append(connection);
+        }
+    };
+    for (auto* connection : connections) collect(connection);
+    for (auto* element : elements) {
+        for (auto* connection : scene->connectionsOf(element)) collect(connection);
+    }
+    
+    const int count = m_elements.size() + m_connections.size();
+    setText(count == 1 ? QObject::tr("删除") : QObject::tr("删除 %1 项").arg(count));
+}
+
+RemoveItemsCommand::~RemoveItemsCommand() {
+    if (m_owned) {
+        qDeleteAll(m_connections);
+        qDeleteAll(m_elements);
+    }
+}
+
+void RemoveItemsCommand::redo() {
+    m_ids.clear();
+    for (auto* element : m_elements) {
+        m_ids.append(m_scene->getElementId(element));
+    }
+    m_scene->removeItems(m_elements, m_connections);
+    m_owned = true;
+}
+
+void RemoveItemsCommand::undo() {
+    m_scene->addItems(m_elements, m_ids, m_connections);
+    m_owned = false;
+}
+
+qsizetype RemoveItemsCommand::byteSize() const {
+    qsizetype bytes = EditCommand::byteSize() + (m_elements.size() + m_connections.size()) * 8;
+    for (const QString& id : m_ids) {
+        bytes += 32 + id.size() * qsizetype(sizeof(QChar));
+    }
+    // 已执行时被删除的图元只由本命令持有
+    for (auto* element : m_elements) bytes += elementBytes(element);
+    for (auto* connection : m_connections) bytes += connectionBytes(connection);
+    return bytes;
+}
+
+// ===== MoveElementsCommand =====
+
+MoveElementsCommand::MoveElementsCommand(LadderScene* scene, const QList<Move>& moves, QUndoCommand* parent)
+    : EditCommand(moves.size() == 1 ? QObject::tr("移动元件") : QObject::tr("移动 %1 个元件").arg(moves.size()),
+                  parent)
+    , m_scene(scene)
+    , m_moves(moves)
+{
+}
+
+void MoveElementsCommand::redo() {
+    // 所有元件就位后统一布线一次
+    m_scene->beginBatch();
+    for (const Move& move : m_moves) {
+        move.element->setPos(move.to);
+    }
+    m_scene->endBatch();
+}
+
+void MoveElementsCommand::undo() {
+    m_scene->beginBatch();
+    for (const Move& move : m_moves) {
+        move.element->setPos(move.from);
+    }
+    m_scene->endBatch();
+}
+
+qsizetype MoveElementsCommand::byteSize() const {
+    return EditCommand::byteSize() + m_moves.size() * qsizetype(sizeof(Move));
+}
+
+// ===== ChangeElementCommand =====
+
+ChangeElementCommand::ChangeElementCommand(LadderElement* element, Field field, const QString& key,
+                                           const QVariant& value, QUndoCommand* parent)
+    : EditCommand(parent)
+    , m_element(element)
+    , m_field(field)
+    , m_key(key)
+    , m_oldValue(valueOf(element, field, key))
+    , m_newValue(value)
+{
+    switch (field) {
+        case Name: setText(QObject::tr("修改名称")); break;
+        case Address: setText(QObject::tr("修改地址")); break;
+        case Comment: setText(QObject::tr("修改注释")); break;
+        case Property: setText(QObject::tr("修改属性 %1").arg(key)); break;
+    }
+    setObsolete(m_oldValue == m_newValue);
+}
+
+QVariant ChangeElementCommand::valueOf(const LadderElement* element, Field field, const QString& key) {
+    switch (field) {
+        case Name: return element->name();
+        case Address: return element->address();
+        case Comment: return element->comment();
+        case Property: return element->getProperty(key);
+    }
+    return QVariant();
+}
+
+void ChangeElementCommand::apply(const QVariant& value) {
+    switch (m_field) {
+        case Name: m_element->setName(value.toString()); break;
+        case Address: m_element->setAddress(value.toString()); break;
+        case Comment: m_element->setComment(value.toString()); break;
+        case Property: m_element->setProperty(m_key, value); break;
+    }
+}
+
+void ChangeElementCommand::redo() {
+    apply(m_newValue);
+}
+
+void ChangeElementCommand::undo() {
+    apply(m_oldValue);
+}
+
+bool ChangeElementCommand::mergeWith(const QUndoCommand* other) {
+    const auto* next = static_cast<const ChangeElementCommand*>(other);
+    if (next->m_element != m_element || next->m_field != m_field || next->m_key != m_key) return false;
+    
+    m_newValue = next->m_newValue;
+    setObsolete(m_newValue == m_oldValue);
+    return true;
+}
+
+qsizetype ChangeElementCommand::byteSize() const {
+    auto valueBytes = [](const QVariant& value) {
+        return qsizetype(sizeof(QVariant)) + value.toString().size() * qsizetype(sizeof(QChar));
+    };
+    return EditCommand::byteSize() + m_key.size() * qsizetype(sizeof(QChar))
+           + valueBytes(m_oldValue) + valueBytes(m_newValue);
+}
+
+} // namespace LadderDiagram
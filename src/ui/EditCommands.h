@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include "UndoHistory.h"
+
+namespace LadderDiagram {
+
+class LadderScene;
+class LadderElement;
+class ConnectionLine;
+
+// 合并用的命令编号
+enum EditCommandId {
+    ChangeElementCommandId = 1
+};
+
+// 向场景添加元件和连接线（新建、连线、粘贴）。
+// 撤销后图元不在场景中，由命令负责释放
+class AddItemsCommand : public EditCommand {
+public:
+    AddItemsCommand(LadderScene* scene, const QList<LadderElement*>& elements,
+                    const QList<ConnectionLine*>& connections, const QString& text,
+                    QUndoCommand* parent = nullptr);
+    ~AddItemsCommand() override;
+
+    void undo() override;
+    void redo() override;
+    qsizetype byteSize() const override;
+
+private:
+    LadderScene* m_scene;
+    QList<LadderElement*> m_elements;
+    QList<ConnectionLine*> m_connections;
+    QStringList m_ids;                  // 首次添加时分配的元件ID，重做时沿用
+    bool m_owned = false;
+};
+
+// 从场景删除元件与连接线（含与这些元件相连的所有连接线）。
+// 执行后图元不在场景中，由命令负责释放
+class RemoveItemsCommand : public EditCommand {
+public:
+    RemoveItemsCommand(LadderScene* scene, const QList<LadderElement*>& elements,
+                       const QList<ConnectionLine*>& connections, QUndoCommand* parent = nullptr);
+    ~RemoveItemsCommand() override;
+
+    void undo() override;
+    void redo() override;
+    qsizetype byteSize() const override;
+
+private:
+    LadderScene* m_scene;
+    QList<LadderElement*> m_elements;
+    QList<ConnectionLine*> m_connections;
+    QStringList m_ids;
+    bool m_owned = false;
+};
+
+// 移动元件：一次拖动在松开鼠标时生成一条命令，不与其它拖动合并
+class MoveElementsCommand : public EditCommand {
+public:
+    struct Move {
+        LadderElement* element;
+        QPointF from;
+        QPointF to;
+    };
+
+    MoveElementsCommand(LadderScene* scene, const QList<Move>& moves, QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    qsizetype byteSize() const override;
+
+private:
+    LadderScene* m_scene;
+    QList<Move> m_moves;
+};
+
+// 修改元件的名称、地址、注释或单个属性：一次输入过程中对同一字段的连续修改
+// 合并为一步，输入结束时由编辑器调用 UndoHistory::closeMergeChain()
+class ChangeElementCommand : public EditCommand {
+public:
+    enum Field {
+        Name,
+        Address,
+        Comment,
+        Property
+    };
+
+    ChangeElementCommand(LadderElement* element, Field field, const QString& key,
+                         const QVariant& value, QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    int id() const override { return ChangeElementCommandId; }
+    bool mergeWith(const QUndoCommand* other) override;
+    qsizetype byteSize() const override;
+
+    // 元件该字段的当前值
+    static QVariant valueOf(const LadderElement* element, Field field, const QString& key);
+
+private:
+    void apply(const QVariant& value);
+
+    LadderElement* m_element;
+    Field m_field;
+    QString m_key;                      // 属性名（仅 Property）
+    QVariant m_oldValue;
+    QVariant m_newValue;
+};
+
+} // namespace LadderDiagram
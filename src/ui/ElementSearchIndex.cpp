@@ -0,0 +1,188 @@
+#include "ElementSearchIndex.h"
+#include "../core/LadderElement.h"
+#include <algorithm>
+
+namespace LadderDiagram {
+
+namespace {
+
+// 字段开头的边界符（不会出现在正常文本中）
+constexpr char16_t Boundary = 0x0001;
+
+struct Match {
+    int score = 0;
+    QPointF position;
+    LadderElement* element = nullptr;
+};
+
+} // namespace
+
+quint64 ElementSearchIndex::trigram(QChar a, QChar b, QChar c) {
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+void ElementSearchIndex::collectTrigrams(const QString& field, QSet<quint64>& out) {
+    if (field.isEmpty()) return;
+    const QString padded = QString(2, QChar(Boundary)) + field;
+    for (qsizetype i = 0; i + 2 < padded.size(); ++i) {
+        out.insert(trigram(padded[i], padded[i + 1], padded[i + 2]));
+    }
+}
+
+QVector<quint64> ElementSearchIndex::queryTrigrams(const QString& term) {
+    QVector<quint64> result;
+    if (term.size() == 1) {
+        result.append(trigram(QChar(Boundary), QChar(Boundary), term[0]));
+    } else if (term.size() == 2) {
+        result.append(trigram(QChar(Boundary), term[0], term[1]));
+    } else {
+        for (qsizetype i = 0; i + 2 < term.size(); ++i) {
+            result.append(trigram(term[i], term[i + 1], term[i + 2]));
+        }
+    }
+    return result;
+}
+
+void ElementSearchIndex::addElement(LadderElement* element) {
+    if (m_docOf.contains(element)) return;
+    
+    Document doc;
+    doc.element = element;
+    doc.fields.append(element->name().trimmed().toLower());
+    doc.fields.append(element->address().trimmed().toLower());
+    doc.fields.append(element->comment().trimmed().toLower());
+    const auto properties = element->properties();
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        // 布尔开关不作为可检索文本
+        if (it.value().typeId() == QMetaType::Bool) continue;
+        const QString value = it.value().toString().trimmed().toLower();
+        if (!value.isEmpty()) doc.fields.append(value);
+    }
+    
+    QSet<quint64> trigrams;
+    for (const QString& field : doc.fields) {
+        collectTrigrams(field, trigrams);
+    }
+    doc.trigrams = QVector<quint64>(trigrams.begin(), trigrams.end());
+    
+    int slot;
+    if (!m_freeDocs.isEmpty()) {
+        slot = m_freeDocs.takeLast();
+    } else {
+        slot = m_docs.size();
+        m_docs.append(Document());
+    }
+    for (quint64 t : doc.trigrams) {
+        m_postings[t].insert(slot);
+    }
+    m_docs[slot] = std::move(doc);
+    m_docOf.insert(element, slot);
+}
+
+void ElementSearchIndex::removeElement(LadderElement* element) {
+    auto it = m_docOf.find(element);
+    if (it == m_docOf.end()) return;
+    
+    const int slot = it.value();
+    m_docOf.erase(it);
+    for (quint64 t : m_docs[slot].trigrams) {
+        auto posting = m_postings.find(t);
+        if (posting == m_postings.end()) continue;
+        posting->remove(slot);
+        if (posting->isEmpty()) m_postings.erase(posting);
+    }
+    m_docs[slot] = Document();
+    m_freeDocs.append(slot);
+}
+
+void ElementSearchIndex::elementChanged(LadderElement* element) {
+    if (!m_docOf.contains(element)) return;
+    removeElement(element);
+    addElement(element);
+}
+
+void ElementSearchIndex::clear() {
+    m_docs.clear();
+    m_freeDocs.clear();
+    m_docOf.clear();
+    m_postings.clear();
+}
+
+int ElementSearchIndex::scoreTerm(const Document& doc, const QString& term) {
+    // 短查询只按前缀匹配（与索引的边界三字符组一致）
+    const bool substring = term.size() >= 3;
+    int best = 0;
+    for (int i = 0; i < doc.fields.size(); ++i) {
+        const QString& field = doc.fields[i];
+        const int weight = i <= Address ? 2 : 1;
+        int score = 0;
+        if (field == term) {
+            score = 20 * weight;
+        } else if (field.startsWith(term)) {
+            score = 15 * weight;
+        } else if (substring && field.contains(term)) {
+            score = 5 * weight;
+        }
+        best = qMax(best, score);
+    }
+    return best;
+}
+
+QList<LadderElement*> ElementSearchIndex::search(const QString& query, int limit) const {
+    const QStringList terms = query.toLower().split(QChar(' '), Qt::SkipEmptyParts);
+    if (terms.isEmpty() || limit <= 0) return {};
+    
+    // 所有词的三字符组对应的倒排表；任何一个不存在即无结果
+    QVector<const QSet<int>*> postings;
+    for (const QString& term : terms) {
+        for (quint64 t : queryTrigrams(term)) {
+            auto it = m_postings.constFind(t);
+            if (it == m_postings.constEnd()) return {};
+            postings.append(&it.value());
+        }
+    }
+    std::sort(postings.begin(), postings.end(), [](const QSet<int>* a, const QSet<int>* b) {
+        return a->size() < b->size();
+    });
+    
+    QVector<Match> matches;
+    for (int slot : *postings.first()) {
+        bool candidate = true;
+        for (int i = 1; i < postings.size() && candidate; ++i) {
+            candidate = postings[i]->contains(slot);
+        }
+        if (!candidate) continue;
+        
+        // 三字符组可能分散在不同字段或不相邻，逐词核对原文
+        const Document& doc = m_docs[slot];
+        int score = 0;
+        for (const QString& term : terms) {
+            const int termScore = scoreTerm(doc, term);
+            if (termScore == 0) {
+                score = 0;
+                break;
+            }
+            score += termScore;
+        }
+        if (score > 0) {
+            matches.append(Match{score, doc.element->pos(), doc.element});
+        }
+    }
+    
+    auto better = [](const Match& a, const Match& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.position.y() != b.position.y()) return a.position.y() < b.position.y();
+        return a.position.x() < b.position.x();
+    };
+    const int count = qMin<int>(limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), better);
+    
+    QList<LadderElement*> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result.append(matches[i].element);
+    }
+    return result;
+}
+
+} // namespace LadderDiagram
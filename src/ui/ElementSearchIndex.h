@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace LadderDiagram {
+
+class LadderElement;
+
+// 元件全文检索索引（名称、地址、注释与属性值）
+//
+// 各字段转为小写后按三字符组（trigram）建倒排表，字段开头补两个边界符，
+// 因此一两个字符的查询按字段前缀匹配，三个字符以上按子串匹配。
+// 查询时取最短的倒排表作候选，再与其余三字符组求交并逐个核对原文。
+// 元件增删或内容变化时只重建该元件的条目。
+class ElementSearchIndex {
+public:
+    void addElement(LadderElement* element);
+    void removeElement(LadderElement* element);
+    void elementChanged(LadderElement* element);
+    void clear();
+
+    int size() const { return m_docOf.size(); }
+
+    // 按相关度排序的匹配元件（空格分隔的多个词须全部匹配），最多 limit 个。
+    // 名称/地址完全相同的排最前，其次是前缀匹配，再次是子串匹配；
+    // 同分时按位置自上而下、自左而右
+    QList<LadderElement*> search(const QString& query, int limit) const;
+
+private:
+    // 字段权重：名称与地址优先于注释与属性
+    enum Field { Name, Address, Comment, Property };
+
+    struct Document {
+        LadderElement* element = nullptr;
+        QStringList fields;             // 小写字段文本，前两项为名称和地址
+        QVector<quint64> trigrams;      // 已去重，删除时据此撤销倒排
+    };
+
+    static quint64 trigram(QChar a, QChar b, QChar c);
+    static void collectTrigrams(const QString& field, QSet<quint64>& out);
+    static QVector<quint64> queryTrigrams(const QString& term);
+    static int scoreTerm(const Document& doc, const QString& term);
+
+    QVector<Document> m_docs;                   // 文档槽位（删除后留空复用）
+    QVector<int> m_freeDocs;
+    QHash<LadderElement*, int> m_docOf;
+    QHash<quint64, QSet<int>> m_postings;       // 三字符组 -> 文档槽位
+};
+
+} // namespace LadderDiagram
@@ -0,0 +1,81 @@
+#include "LadderClipboard.h"
+#include "../core/LdBinFormat.h"
+#include "../core/LadderModel.h"
+#include <QMimeData>
+#include <QBuffer>
+
+namespace LadderDiagram {
+
+QMimeData* LadderClipboard::toMimeData(const SceneSnapshot& snapshot) {
+    auto* mime = new QMimeData();
+    mime->setData(MimeType, snapshot.toBinary());
+    
+    QByteArray json;
+    QBuffer buffer(&json);
+    buffer.open(QIODevice::WriteOnly);
+    if (snapshot.writeJson(&buffer)) {
+        mime->setText(QString::fromUtf8(json));
+    }
+    return mime;
+}
+
+bool LadderClipboard::fromMimeData(const QMimeData* mime, SceneSnapshot& snapshot) {
+    if (!mime) return false;
+    
+    if (mime->hasFormat(MimeType) && fromBinary(mime->data(MimeType), snapshot)) {
+        return true;
+    }
+    return mime->hasText() && fromJson(mime->text().toUtf8(), snapshot);
+}
+
+bool LadderClipboard::fromBinary(const QByteArray& data, SceneSnapshot& snapshot) {
+    LdBinReader reader;
+    if (!reader.openData(reinterpret_cast<const uchar*>(data.constData()), data.size())) {
+        return false;
+    }
+    
+    snapshot = SceneSnapshot();
+    snapshot.elements.reserve(reader.elementCount());
+    QStringList ids;
+    ids.reserve(reader.elementCount());
+    for (quint32 i = 0; i < reader.elementCount(); ++i) {
+        snapshot.elements.append(reader.elementMap(i));
+        ids.append(snapshot.elements.last().value("id").toString());
+    }
+    
+    // 连线端点以元件ID表示，与 LadderModel::toSnapshot() 的记录一致
+    snapshot.connections.reserve(reader.connectionCount());
+    for (quint32 i = 0; i < reader.connectionCount(); ++i) {
+        const LdBin::ConnectionRecord& record = reader.connection(i);
+        if (record.startElement >= quint32(ids.size()) || record.endElement >= quint32(ids.size())) {
+            continue;
+        }
+        
+        QMap<QString, QVariant> map;
+        map["start_x"] = record.startX;
+        map["start_y"] = record.startY;
+        map["end_x"] = record.endX;
+        map["end_y"] = record.endY;
+        map["start_element"] = ids[record.startElement];
+        map["start_connection_index"] = int(record.startPin);
+        map["end_element"] = ids[record.endElement];
+        map["end_connection_index"] = int(record.endPin);
+        snapshot.connections.append(map);
+    }
+    return !snapshot.elements.isEmpty();
+}
+
+bool LadderClipboard::fromJson(const QByteArray& data, SceneSnapshot& snapshot) {
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    
+    LadderModel model;
+    if (!model.readJson(&buffer) || model.elements.isEmpty()) {
+        return false;
+    }
+    snapshot = model.toSnapshot();
+    return true;
+}
+
+} // namespace LadderDiagram
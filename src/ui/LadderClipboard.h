@@ -0,0 +1,28 @@
+#pragma once
+
+#include "../core/SceneSnapshot.h"
+
+class QMimeData;
+
+namespace LadderDiagram {
+
+// 剪贴板格式
+//
+// 主格式为 .ldbin 二进制（MIME 类型 application/x-ladder-diagram），
+// 同时以 .ldjson 文本作为纯文本备用，可粘贴到文本编辑器或其他实例中。
+// 读取时优先用二进制，缺失或损坏时再尝试文本。
+class LadderClipboard {
+public:
+    static constexpr const char* MimeType = "application/x-ladder-diagram";
+
+    static QMimeData* toMimeData(const SceneSnapshot& snapshot);
+
+    // 剪贴板中没有可识别的梯形图内容时返回 false
+    static bool fromMimeData(const QMimeData* mime, SceneSnapshot& snapshot);
+
+private:
+    static bool fromBinary(const QByteArray& data, SceneSnapshot& snapshot);
+    static bool fromJson(const QByteArray& data, SceneSnapshot& snapshot);
+};
+
+} // namespace LadderDiagram
@@ -1,279 +1,639 @@
 #include "LadderScene.h"
 #include "../elements/ContactElements.h"
+#include "../elements/ElementFactory.h"
+#include "../core/LdJsonStream.h"
+#include "../core/ElementRenderCache.h"
+#include "WireRouter.h"
+#include "EditCommands.h"
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
 #include <QKeyEvent>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QUndoCommand>
+#include <QBuffer>
 #include <QScrollBar>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
 
 namespace LadderDiagram {
 
-// 添加元件命令
-class AddElementCommand : public QUndoCommand {
-public:
-    AddElementCommand(LadderScene* scene, LadderElement* element)
-        : m_scene(scene), m_element(element) {
-        setText(QObject::tr("添加元件"));
-    }
-    
-    void undo() override {
-        m_scene->removeElement(m_element);
-    }
-    
-    void redo() override {
-        m_scene->addElement(m_element);
-    }
-    
-private:
-    LadderScene* m_scene;
-    LadderElement* m_element;
-};
-
-// 删除元件命令
-class RemoveElementCommand : public QUndoCommand {
-public:
-    RemoveElementCommand(LadderScene* scene, LadderElement* element)
-        : m_scene(scene), m_element(element) {
-        setText(QObject::tr("删除元件"));
-    }
-    
-    void undo() override {
-        m_scene->addElement(m_element);
-    }
-    
-    void redo() override {
-        m_scene->removeElement(m_element);
-    }
-    
-private:
-    LadderScene* m_scene;
-    LadderElement* m_element;
-};
-
 LadderScene::LadderScene(QObject* parent)
     : QGraphicsScene(parent)
-    , m_undoStack(new QUndoStack(this)) {
+    , m_undoStack(new UndoHistory(this)) {
     setSceneRect(-5000, -5000, 10000, 10000);
 }
 
 LadderScene::~LadderScene() = default;
 
-void LadderScene::addElement(LadderElement* element) {
-    // 生成唯一ID
-    QString id = QString("E%1").arg(m_nextElementId++);
-    m_elementMap[id] = element;
+void LadderScene::addElement(LadderElement* element, const QString& id) {
+    if (m_elementSlots.contains(element)) return;
+    
+    // 生成唯一ID（或沿用给定ID）
+    QString elementId = id;
+    if (elementId.isEmpty() || m_elementMap.contains(elementId)) {
+        elementId = QString("E%1").arg(m_nextElementId++);
+    } else if (elementId.startsWith('E')) {
+        bool ok = false;
+        int number = elementId.mid(1).toInt(&ok);
+        if (ok && number >= m_nextElementId) {
+            m_nextElementId = number + 1;
+        }
+    }
+    
+    m_elementSlots.insert(element, m_elements.size());
+    m_elements.append(element);
+    m_elementIds.insert(element, elementId);
+    m_elementMap.insert(elementId, element);
     
     // 对齐到网格
     element->setPos(snapToGrid(element->pos()));
     
     addItem(element);
+    element->setChangeListener(this);
+    m_pinIndex.update(element);
+    m_rungs.addElement(element);
+    m_crossReferences.addElement(element);
+    m_search.addElement(element);
     
-    // 使用场景的选择变化来更新连接（简化方案）
-    connect(this, &QGraphicsScene::selectionChanged, this, [this]() {
-        for (auto* item : items()) {
-            if (auto* conn = dynamic_cast<ConnectionLine*>(item)) {
-                if (conn->startElement() && conn->endElement()) {
-                    conn->updateConnection();
-                }
-            }
-        }
-    });
+    // 新元件可能挡住已有连线
+    const QRectF outline = element->mapRectToScene(element->outlineRect());
+    m_elementOutlines.insert(element, outline);
+    if (m_batchDepth > 0) {
+        m_batchRegion |= outline;
+        m_batchChanged = true;
+        return;
+    }
+    rerouteAround(outline);
+    emit contentChanged();
 }
 
 void LadderScene::removeElement(LadderElement* element) {
     // 删除相关连接
-    QList<ConnectionLine*> connectionsToRemove;
-    for (auto* item : items()) {
-        if (auto* conn = dynamic_cast<ConnectionLine*>(item)) {
-            if (conn->startElement() == element || conn->endElement() == element) {
-                connectionsToRemove.append(conn);
-            }
-        }
-    }
-    
+    const QList<ConnectionLine*> connectionsToRemove = m_adjacency.value(element);
     for (auto* conn : connectionsToRemove) {
         removeConnection(conn);
         delete conn;
     }
+    m_adjacency.remove(element);
+    m_rungs.removeElement(element);
+    m_crossReferences.removeElement(element);
+    m_search.removeElement(element);
+    m_dragOrigins.remove(element);
     
-    // 从映射中移除
-    QString idToRemove;
-    for (auto it = m_elementMap.begin(); it != m_elementMap.end(); ++it) {
-        if (it.value() == element) {
-            idToRemove = it.key();
-            break;
-        }
-    }
-    if (!idToRemove.isEmpty()) {
-        m_elementMap.remove(idToRemove);
+    // 从注册表中移除（与末尾元素交换后弹出）
+    auto slotIt = m_elementSlots.find(element);
+    if (slotIt != m_elementSlots.end()) {
+        int slot = slotIt.value();
+        LadderElement* last = m_elements.last();
+        m_elements[slot] = last;
+        m_elementSlots[last] = slot;
+        m_elements.removeLast();
+        m_elementSlots.erase(m_elementSlots.find(element));
+        
+        m_elementMap.remove(m_elementIds.take(element));
     }
     
+    element->setChangeListener(nullptr);
+    m_pinIndex.remove(element);
+    if (m_hoverPin.element == element) {
+        setHoverPin(PinGridIndex::Hit());
+    }
     removeItem(element);
+    
+    // 让出的空间可能使附近连线走得更短
+    const QRectF outline = m_elementOutlines.take(element);
+    if (m_batchDepth > 0) {
+        m_batchRegion |= outline;
+        m_batchChanged = true;
+        return;
+    }
+    rerouteAround(outline);
+    emit contentChanged();
 }
 
 void LadderScene::addConnection(ConnectionLine* connection) {
+    if (m_connectionSlots.contains(connection)) return;
+    
     addItem(connection);
     connection->setZValue(-1);
+    
+    m_connectionSlots.insert(connection, m_connections.size());
+    m_connections.append(connection);
+    
+    attachConnection(connection->startElement(), connection);
+    attachConnection(connection->endElement(), connection);
+    m_rungs.addConnection(connection);
+    
+    // 引脚连线状态
+    if (connection->startElement()) connection->startElement()->attachPin(connection->startConnectionIndex());
+    if (connection->endElement()) connection->endElement()->attachPin(connection->endConnectionIndex());
+    
+    if (m_batchDepth > 0) {
+        m_batchRoutes.append(connection);
+        m_batchChanged = true;
+        return;
+    }
+    routeConnection(connection);
+    emit contentChanged();
 }
 
 void LadderScene::removeConnection(ConnectionLine* connection) {
+    auto slotIt = m_connectionSlots.find(connection);
+    const bool registered = slotIt != m_connectionSlots.end();
+    if (registered) {
+        int slot = slotIt.value();
+        ConnectionLine* last = m_connections.last();
+        m_connections[slot] = last;
+        m_connectionSlots[last] = slot;
+        m_connections.removeLast();
+        m_connectionSlots.erase(m_connectionSlots.find(connection));
+    }
+    
+    detachConnection(connection->startElement(), connection);
+    detachConnection(connection->endElement(), connection);
+    
+    if (registered) {
+        m_rungs.removeConnection(connection);
+        if (connection->startElement()) connection->startElement()->detachPin(connection->startConnectionIndex());
+        if (connection->endElement()) connection->endElement()->detachPin(connection->endConnectionIndex());
+    }
+    
     removeItem(connection);
+    if (m_batchDepth > 0) {
+        m_batchRoutes.removeOne(connection);
+        m_batchChanged = true;
+        return;
+    }
+    emit contentChanged();
 }
 
-QList<LadderElement*> LadderScene::elements() const {
-    QList<LadderElement*> result;
-    for (auto* item : items()) {
-        if (auto* element = dynamic_cast<LadderElement*>(item)) {
-            result.append(element);
-        }
+void LadderScene::addItems(const QList<LadderElement*>& elements, const QStringList& ids,
+                           const QList<ConnectionLine*>& connections) {
+    beginBatch();
+    for (int i = 0; i < elements.size(); ++i) {
+        addElement(elements[i], ids.value(i));
     }
-    return result;
+    for (auto* conn : connections) {
+        addConnection(conn);
+    }
+    endBatch();
+}
+
+void LadderScene::removeItems(const QList<LadderElement*>& elements, const QList<ConnectionLine*>& connections) {
+    beginBatch();
+    for (auto* conn : connections) {
+        removeConnection(conn);
+    }
+    for (auto* element : elements) {
+        removeElement(element);
+    }
+    endBatch();
+}
+
+void LadderScene::beginBatch() {
+    ++m_batchDepth;
 }
 
-QList<ConnectionLine*> LadderScene::connections() const {
-    QList<ConnectionLine*> result;
-    for (auto* item : items()) {
-        if (auto* conn = dynamic_cast<ConnectionLine*>(item)) {
-            result.append(conn);
+void LadderScene::endBatch() {
+    if (--m_batchDepth > 0) return;
+    
+    // 先给新连线布线（此时所有元件都已就位），再重布受影响区域内的其余连线
+    QSet<ConnectionLine*> routed;
+    for (auto* conn : std::as_const(m_batchRoutes)) {
+        routeConnection(conn);
+        routed.insert(conn);
+    }
+    rerouteAround(m_batchRegion, &routed);
+    
+    m_batchRoutes.clear();
+    m_batchRegion = QRectF();
+    if (m_batchChanged) {
+        m_batchChanged = false;
+        emit contentChanged();
+    }
+}
+
+void LadderScene::attachConnection(LadderElement* element, ConnectionLine* connection) {
+    if (!element) return;
+    auto& list = m_adjacency[element];
+    if (!list.contains(connection)) {
+        list.append(connection);
+    }
+}
+
+void LadderScene::detachConnection(LadderElement* element, ConnectionLine* connection) {
+    if (!element) return;
+    auto it = m_adjacency.find(element);
+    if (it != m_adjacency.end()) {
+        it->removeOne(connection);
+        if (it->isEmpty()) {
+            m_adjacency.erase(it);
         }
     }
-    return result;
 }
 
-QString LadderScene::getElementId(LadderElement* element) const {
-    for (auto it = m_elementMap.begin(); it != m_elementMap.end(); ++it) {
-        if (it.value() == element) {
-            return it.key();
+QList<ConnectionLine*> LadderScene::connectionsOf(LadderElement* element) const {
+    return m_adjacency.value(element);
+}
+
+void LadderScene::elementGeometryChanged(LadderElement* element) {
+    m_pinIndex.update(element);
+    m_rungs.elementChanged(element);
+    
+    const QRectF outline = element->mapRectToScene(element->outlineRect());
+    const QRectF previous = m_elementOutlines.value(element, outline);
+    m_elementOutlines.insert(element, outline);
+    
+    // 批量编辑（拖动）期间：相连连线只更新端点和直角折线，
+    // 自动布线推迟到区间结束时对最终位置做一次
+    const QList<ConnectionLine*> attached = m_adjacency.value(element);
+    if (m_batchDepth > 0) {
+        for (auto* conn : attached) {
+            conn->updateConnection();
+            if (!m_batchRoutes.contains(conn)) {
+                m_batchRoutes.append(conn);
+            }
         }
+        m_batchRegion |= previous.united(outline);
+        m_batchChanged = true;
+        return;
     }
-    return QString();
+    
+    // 与移动元件相连的连接线：端点变了，重新布线
+    QSet<ConnectionLine*> routed;
+    for (auto* conn : attached) {
+        conn->updateConnection();
+        routeConnection(conn);
+        routed.insert(conn);
+    }
+    
+    // 其余连线只有走廊覆盖了旧位置或新位置时才需要重布
+    rerouteAround(previous.united(outline), &routed);
+    emit contentChanged();
 }
 
-LadderElement* LadderScene::getElementById(const QString& id) const {
-    return m_elementMap.value(id, nullptr);
+void LadderScene::elementContentChanged(LadderElement* element) {
+    m_rungs.elementChanged(element);
+    m_crossReferences.elementChanged(element);
+    m_search.elementChanged(element);
+    emit contentChanged();
 }
 
-QByteArray LadderScene::toJson() const {
-    QJsonObject root;
-    
-    // 保存元件
-    QJsonArray elementsArray;
-    for (auto* element : elements()) {
-        QJsonObject elemObj;
-        auto map = element->toMap();
-        for (auto it = map.begin(); it != map.end(); ++it) {
-            elemObj[it.key()] = QJsonValue::fromVariant(it.value());
+QStringList LadderScene::doubleCoils() const {
+    // 候选变量只有少数，逐个检查写入它的线圈是否分属不同梯级
+    QStringList result;
+    for (const QString& symbol : m_crossReferences.multiCoilSymbols()) {
+        QSet<int> rungs;
+        for (const auto& ref : m_crossReferences.references(symbol)) {
+            if (CrossReferenceIndex::isCoilWrite(ref)) {
+                rungs.insert(m_rungs.rungOf(ref.element));
+            }
         }
-        elemObj["id"] = getElementId(element);
-        elementsArray.append(elemObj);
-    }
-    root["elements"] = elementsArray;
-    
-    // 保存连接
-    QJsonArray connectionsArray;
-    for (auto* conn : connections()) {
-        QJsonObject connObj;
-        auto map = conn->toMap();
-        for (auto it = map.begin(); it != map.end(); ++it) {
-            connObj[it.key()] = QJsonValue::fromVariant(it.value());
+        if (rungs.size() > 1) {
+            result.append(symbol);
         }
-        connectionsArray.append(connObj);
     }
-    root["connections"] = connectionsArray;
+    result.sort();
+    return result;
+}
+
+namespace {
+
+// 连线端点的引出方向：按连接点相对元件外框中心的位置取主方向
+WireRouter::Endpoint routeEndpoint(LadderElement* element, int pin,
+                                   const QPointF& position, const QPointF& other) {
+    WireRouter::Endpoint endpoint{position, QPoint(other.x() >= position.x() ? 1 : -1, 0)};
+    if (!element) return endpoint;
     
-    QJsonDocument doc(root);
-    return doc.toJson();
+    const auto points = element->connectionPoints();
+    if (pin < 0 || pin >= int(points.size())) return endpoint;
+    
+    const QRectF outline = element->outlineRect();
+    const QPointF local = points[pin].position - outline.center();
+    const qreal rx = outline.width() > 0 ? local.x() / outline.width() : 0;
+    const qreal ry = outline.height() > 0 ? local.y() / outline.height() : 0;
+    if (qAbs(rx) >= qAbs(ry)) {
+        endpoint.exit = QPoint(rx < 0 ? -1 : 1, 0);
+    } else {
+        endpoint.exit = QPoint(0, ry < 0 ? -1 : 1);
+    }
+    return endpoint;
 }
 
-bool LadderScene::fromJson(const QByteArray& json) {
-    QJsonDocument doc = QJsonDocument::fromJson(json);
-    if (doc.isNull()) return false;
+} // namespace
+
+void LadderScene::routeConnection(ConnectionLine* connection) {
+    const WireRouter::Endpoint from = routeEndpoint(connection->startElement(), connection->startConnectionIndex(),
+                                                    connection->startPoint(), connection->endPoint());
+    const WireRouter::Endpoint to = routeEndpoint(connection->endElement(), connection->endConnectionIndex(),
+                                                  connection->endPoint(), connection->startPoint());
+    const QRectF corridor = WireRouter::corridor(from, to, m_gridSize);
     
-    clearScene();
+    // 走廊内的元件外框作为障碍
+    QVector<QRectF> obstacles;
+    for (auto* item : items(corridor, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder)) {
+        if (auto* element = dynamic_cast<LadderElement*>(item)) {
+            obstacles.append(element->mapRectToScene(element->outlineRect()));
+        }
+    }
+    
+    // 无解时保留默认直角折线，但仍记下走廊，障碍变化后会再试
+    connection->setRoute(WireRouter::route(from, to, m_gridSize, obstacles), corridor);
+}
+
+void LadderScene::rerouteAround(const QRectF& region, QSet<ConnectionLine*>* routed) {
+    if (region.isNull()) return;
     
-    QJsonObject root = doc.object();
+    // 走廊最多比连线自身的边界多出 CorridorMargin 格，据此扩大查询范围
+    const qreal margin = (WireRouter::CorridorMargin + 1) * m_gridSize;
+    const QRectF query = region.adjusted(-margin, -margin, margin, margin);
     
-    // 加载元件
-    QJsonArray elementsArray = root["elements"].toArray();
-    for (const auto& elemValue : elementsArray) {
-        QJsonObject elemObj = elemValue.toObject();
+    QList<ConnectionLine*> affected;
+    for (auto* item : items(query, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder)) {
+        auto* conn = dynamic_cast<ConnectionLine*>(item);
+        if (!conn || !m_connectionSlots.contains(conn)) continue;
+        if (routed && routed->contains(conn)) continue;
+        if (conn->isRouted() && !conn->corridor().intersects(region)) continue;
+        affected.append(conn);
+    }
+    
+    for (auto* conn : affected) {
+        routeConnection(conn);
+        if (routed) routed->insert(conn);
+    }
+}
+
+QString LadderScene::getElementId(LadderElement* element) const {
+    return m_elementIds.value(element);
+}
+
+LadderElement* LadderScene::getElementById(const QString& id) const {
+    return m_elementMap.value(id, nullptr);
+}
+
+namespace {
+
+// 流式加载：元件逐条创建；连接线若引用尚未读到的元件（旧文件中 "connections"
+// 可能排在 "elements" 之前），先暂存，全部读完后再建立
+class SceneJsonLoader : public LdJsonHandler {
+public:
+    explicit SceneJsonLoader(LadderScene* scene) : m_scene(scene) {}
+    
+    void element(const QMap<QString, QVariant>& record) override {
+        ElementType type = static_cast<ElementType>(record.value("type").toInt());
+        LadderElement* element = ElementFactory::create(type);
+        if (!element) return;
         
-        ElementType type = static_cast<ElementType>(elemObj["type"].toInt());
-        LadderElement* element = nullptr;
+        element->fromMap(record);
+        m_scene->addElement(element, record.value("id").toString());
+    }
+    
+    void connection(const QMap<QString, QVariant>& record) override {
+        if (!resolved(record.value("start_element").toString())
+            || !resolved(record.value("end_element").toString())) {
+            m_pending.append(record);
+            return;
+        }
+        createConnection(record);
+    }
+    
+    void finish() {
+        for (const auto& record : m_pending) {
+            createConnection(record);
+        }
+        m_pending.clear();
+    }
+    
+private:
+    bool resolved(const QString& id) const {
+        return id.isEmpty() || m_scene->getElementById(id);
+    }
+    
+    void createConnection(const QMap<QString, QVariant>& record) {
+        ConnectionLine* conn = new ConnectionLine();
+        conn->fromMap(record);
         
-        // 根据类型创建元件
-        switch (type) {
-            case ElementType::NormallyOpen:
-                element = new NormallyOpenContact();
-                break;
-            case ElementType::NormallyClosed:
-                element = new NormallyClosedContact();
-                break;
-            case ElementType::OutputCoil:
-                element = new OutputCoil();
-                break;
-            case ElementType::SetCoil:
-                element = new SetCoil();
-                break;
-            case ElementType::ResetCoil:
-                element = new ResetCoil();
-                break;
-            case ElementType::LeftPowerRail:
-                element = new LeftPowerRail();
-                break;
-            case ElementType::RightPowerRail:
-                element = new RightPowerRail();
-                break;
-            case ElementType::Timer:
-                element = new Timer();
-                break;
-            case ElementType::Counter:
-                element = new Counter();
-                break;
-            default:
-                continue;
+        // 重新建立元素连接
+        QString startElemId = record.value("start_element").toString();
+        QString endElemId = record.value("end_element").toString();
+        if (!startElemId.isEmpty()) {
+            conn->setStartElement(m_scene->getElementById(startElemId),
+                                  record.value("start_connection_index").toInt());
+        }
+        if (!endElemId.isEmpty()) {
+            conn->setEndElement(m_scene->getElementById(endElemId),
+                                record.value("end_connection_index").toInt());
         }
+        conn->updateConnection();
         
-        if (element) {
-            QMap<QString, QVariant> map;
-            for (auto it = elemObj.begin(); it != elemObj.end(); ++it) {
-                map[it.key()] = it.value().toVariant();
+        m_scene->addConnection(conn);
+    }
+    
+    LadderScene* m_scene;
+    QList<QMap<QString, QVariant>> m_pending;
+};
+
+} // namespace
+
+ElementData LadderScene::elementData(LadderElement* element) const {
+    ElementData data = element->elementData();
+    data.id = getElementId(element);
+    return data;
+}
+
+ConnectionData LadderScene::connectionData(ConnectionLine* connection) const {
+    ConnectionData data;
+    data.startPoint = connection->startPoint();
+    data.endPoint = connection->endPoint();
+    // 端点元件ID只有场景知道，在这里补充，保证加载时能重新建立连接
+    if (connection->startElement()) {
+        data.startElement = getElementId(connection->startElement());
+        data.startPin = connection->startConnectionIndex();
+    }
+    if (connection->endElement()) {
+        data.endElement = getElementId(connection->endElement());
+        data.endPin = connection->endConnectionIndex();
+    }
+    return data;
+}
+
+QMap<QString, QVariant> LadderScene::elementRecord(LadderElement* element) const {
+    return elementData(element).toMap();
+}
+
+QMap<QString, QVariant> LadderScene::connectionRecord(ConnectionLine* connection) const {
+    return connectionData(connection).toMap();
+}
+
+LadderModel LadderScene::snapshot() const {
+    // 只复制各元件的记录（隐式共享）与位置，排序和转换为键值表留给调用方
+    LadderModel model;
+    model.elements.reserve(m_elements.size());
+    model.connections.reserve(m_connections.size());
+    
+    for (auto* element : m_elements) {
+        model.elements.append(elementData(element));
+    }
+    for (auto* conn : m_connections) {
+        model.connections.append(connectionData(conn));
+    }
+    
+    return model;
+}
+
+LadderScene::RungRecords LadderScene::buildRungRecords(const QList<LadderElement*>& members) const {
+    RungRecords records;
+    
+    // 梯级的连线与其两端的电源轨
+    QList<ConnectionLine*> wires;
+    QList<LadderElement*> rails;
+    QSet<ConnectionLine*> seen;
+    for (auto* element : members) {
+        for (auto* conn : m_adjacency.value(element)) {
+            if (seen.contains(conn)) continue;
+            seen.insert(conn);
+            wires.append(conn);
+            for (auto* end : {conn->startElement(), conn->endElement()}) {
+                if (end && RungIndex::isRail(end) && !rails.contains(end)) rails.append(end);
             }
-            element->fromMap(map);
-            addElement(element);
-            
-            // 恢复ID映射
-            QString id = elemObj["id"].toString();
-            m_elementMap[id] = element;
         }
     }
     
-    // 加载连接（需要在所有元件加载完成后）
-    QJsonArray connectionsArray = root["connections"].toArray();
-    for (const auto& connValue : connectionsArray) {
-        QJsonObject connObj = connValue.toObject();
-        
-        ConnectionLine* conn = new ConnectionLine();
-        QMap<QString, QVariant> map;
-        for (auto it = connObj.begin(); it != connObj.end(); ++it) {
-            map[it.key()] = it.value().toVariant();
+    // 未接线的孤立元件不构成网络（标签本身没有连接点）
+    if (wires.isEmpty() && members.first()->elementType() != ElementType::Label) {
+        return records;
+    }
+    
+    // 与 STCodeGenerator::splitNetworks 相同的顺序：元件按 (y, x)，电源轨与连线按登记顺序
+    QList<LadderElement*> sorted = members;
+    std::sort(sorted.begin(), sorted.end(), [this](LadderElement* a, LadderElement* b) {
+        if (a->pos().y() != b->pos().y()) return a->pos().y() < b->pos().y();
+        if (a->pos().x() != b->pos().x()) return a->pos().x() < b->pos().x();
+        return m_elementSlots.value(a) < m_elementSlots.value(b);
+    });
+    std::sort(rails.begin(), rails.end(), [this](LadderElement* a, LadderElement* b) {
+        return m_elementSlots.value(a) < m_elementSlots.value(b);
+    });
+    std::sort(wires.begin(), wires.end(), [this](ConnectionLine* a, ConnectionLine* b) {
+        return m_connectionSlots.value(a) < m_connectionSlots.value(b);
+    });
+    
+    records.elements.reserve(rails.size() + sorted.size());
+    for (auto* rail : rails) records.elements.append(elementData(rail));
+    for (auto* element : sorted) records.elements.append(elementData(element));
+    records.connections.reserve(wires.size());
+    for (auto* conn : wires) records.connections.append(connectionData(conn));
+    records.topLeft = sorted.first()->pos();
+    return records;
+}
+
+QList<LadderNetwork> LadderScene::networks() {
+    // 只重建内容变化过的梯级
+    const QSet<int> dirty = m_rungs.takeDirty();
+    for (int rung : dirty) {
+        const QList<LadderElement*> members = m_rungs.members(rung);
+        if (members.isEmpty()) {
+            m_rungRecords.remove(rung);
+        } else {
+            RungRecords records = buildRungRecords(members);
+            records.revision = ++m_rungRevision;
+            m_rungRecords.insert(rung, records);
         }
-        conn->fromMap(map);
+    }
+    
+    // 梯级之间按最上方元件排序
+    QList<QPair<int, QPointF>> order;
+    order.reserve(m_rungRecords.size());
+    for (auto it = m_rungRecords.cbegin(); it != m_rungRecords.cend(); ++it) {
+        if (!it->elements.isEmpty()) order.append(qMakePair(it.key(), it->topLeft));
+    }
+    std::sort(order.begin(), order.end(), [](const QPair<int, QPointF>& a, const QPair<int, QPointF>& b) {
+        if (a.second.y() != b.second.y()) return a.second.y() < b.second.y();
+        if (a.second.x() != b.second.x()) return a.second.x() < b.second.x();
+        return a.first < b.first;
+    });
+    
+    QList<LadderNetwork> result;
+    result.reserve(order.size());
+    for (const auto& entry : order) {
+        const int rung = entry.first;
+        const RungRecords& records = *m_rungRecords.constFind(rung);
+        LadderNetwork network;
+        network.id = result.size() + 1;
+        network.rungId = rung;
+        network.revision = records.revision;
+        network.elements = records.elements;
+        network.connections = records.connections;
+        result.append(network);
+    }
+    return result;
+}
+
+bool LadderScene::writeJson(QIODevice* device) const {
+    LadderModel model = snapshot();
+    model.sortForSave();
+    return model.toSnapshot().writeJson(device);
+}
+
+bool LadderScene::readJson(QIODevice* device, QString* errorString) {
+    clearScene();
+    
+    SceneJsonLoader loader(this);
+    LdJsonReader reader;
+    const bool ok = reader.read(device, loader);
+    loader.finish();
+    
+    if (!ok && errorString) {
+        *errorString = reader.errorString();
+    }
+    return ok;
+}
+
+QByteArray LadderScene::toJson() const {
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    writeJson(&buffer);
+    return data;
+}
+
+bool LadderScene::fromJson(const QByteArray& json) {
+    QBuffer buffer;
+    buffer.setData(json);
+    buffer.open(QIODevice::ReadOnly);
+    return readJson(&buffer);
+}
+
+QByteArray LadderScene::toBinary() const {
+    LadderModel model = snapshot();
+    model.sortForSave();
+    return model.toSnapshot().toBinary();
+}
+
+bool LadderScene::fromBinary(const LdBinReader& reader) {
+    clearScene();
+    
+    // 元件表下标 -> 元件
+    QVector<LadderElement*> loaded(reader.elementCount(), nullptr);
+    for (quint32 i = 0; i < reader.elementCount(); ++i) {
+        const LdBin::ElementRecord& record = reader.element(i);
+        LadderElement* element = ElementFactory::create(static_cast<ElementType>(record.type));
+        if (!element) continue;
         
-        // 重新建立元素连接
-        QString startElemId = connObj["start_element"].toString();
-        QString endElemId = connObj["end_element"].toString();
-        int startIdx = connObj["start_connection_index"].toInt();
-        int endIdx = connObj["end_connection_index"].toInt();
+        element->fromMap(reader.elementMap(i));
+        addElement(element, reader.text(record.id));
+        loaded[i] = element;
+    }
+    
+    for (quint32 i = 0; i < reader.connectionCount(); ++i) {
+        const LdBin::ConnectionRecord& record = reader.connection(i);
         
-        if (!startElemId.isEmpty()) {
-            conn->setStartElement(getElementById(startElemId), startIdx);
+        ConnectionLine* conn = new ConnectionLine();
+        conn->setStartPoint(QPointF(record.startX, record.startY));
+        conn->setEndPoint(QPointF(record.endX, record.endY));
+        if (record.startElement != LdBin::NoElement && loaded[record.startElement]) {
+            conn->setStartElement(loaded[record.startElement], record.startPin);
         }
-        if (!endElemId.isEmpty()) {
-            conn->setEndElement(getElementById(endElemId), endIdx);
+        if (record.endElement != LdBin::NoElement && loaded[record.endElement]) {
+            conn->setEndElement(loaded[record.endElement], record.endPin);
         }
         conn->updateConnection();
         
@@ -284,10 +644,28 @@ bool LadderScene::fromJson(const QByteArray& json) {
 }
 
 void LadderScene::clearScene() {
+    cancelConnection();
+    m_adjacency.clear();
+    m_elements.clear();
+    m_elementSlots.clear();
+    m_elementIds.clear();
+    m_connections.clear();
+    m_connectionSlots.clear();
+    m_pinIndex.clear();
+    m_hoverPin = PinGridIndex::Hit();
+    m_elementOutlines.clear();
+    m_rungs.clear();
+    m_rungRecords.clear();
+    m_crossReferences.clear();
+    m_search.clear();
+    m_dragOrigins.clear();
+    m_batchRoutes.clear();
+    m_batchRegion = QRectF();
     clear();
     m_elementMap.clear();
     m_nextElementId = 1;
     m_undoStack->clear();
+    emit contentChanged();
 }
 
 void LadderScene::setGridEnabled(bool enabled) {
@@ -312,6 +690,7 @@ void LadderScene::setConnectionMode(bool enabled) {
     m_connectionMode = enabled;
     if (!enabled) {
         cancelConnection();
+        setHoverPin(PinGridIndex::Hit());
     }
 }
 
@@ -372,23 +751,68 @@ void LadderScene::drawBackground(QPainter* painter, const QRectF& rect) {
 }
 
 void LadderScene::drawGrid(QPainter* painter, const QRectF& rect) {
-    painter->setPen(QPen(QColor(200, 200, 200), 0.5));
+    const qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const qreal pixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
     
-    qreal left = qFloor(rect.left() / m_gridSize) * m_gridSize;
-    qreal top = qFloor(rect.top() / m_gridSize) * m_gridSize;
+    // 网格过密时不绘制
+    if (m_gridSize * scale < 4) return;
     
-    for (qreal x = left; x < rect.right(); x += m_gridSize) {
-        painter->drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+    // 网格按缩放档位预先绘制成一个格子的平铺画刷，只在档位或格距变化时重建
+    const int bucket = ElementRenderCache::zoomBucket(scale);
+    if (m_gridTile.isNull() || bucket != m_gridTileBucket || m_gridSize != m_gridTileSize
+        || pixelRatio != m_gridTilePixelRatio) {
+        const qreal resolution = ElementRenderCache::bucketScale(bucket) * pixelRatio;
+        const int pixels = qMax(1, qRound(m_gridSize * resolution));
+        
+        QPixmap tile(pixels, pixels);
+        tile.fill(Qt::transparent);
+        QPainter tilePainter(&tile);
+        tilePainter.setPen(QPen(QColor(200, 200, 200), qMax<qreal>(1.0, 0.5 * resolution)));
+        tilePainter.drawLine(QPointF(0, 0), QPointF(pixels, 0));
+        tilePainter.drawLine(QPointF(0, 0), QPointF(0, pixels));
+        tilePainter.end();
+        
+        m_gridTile = tile;
+        m_gridTileBucket = bucket;
+        m_gridTileSize = m_gridSize;
+        m_gridTilePixelRatio = pixelRatio;
     }
     
-    for (qreal y = top; y < rect.bottom(); y += m_gridSize) {
-        painter->drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
-    }
+    // 画刷坐标以场景原点对齐，一个平铺单元恰为一个格距
+    QBrush brush(m_gridTile);
+    brush.setTransform(QTransform::fromScale(qreal(m_gridSize) / m_gridTile.width(),
+                                             qreal(m_gridSize) / m_gridTile.height()));
+    painter->fillRect(rect, brush);
 }
 
-void LadderScene::updateTemporaryConnection(const QPointF& point) {
+void LadderScene::updateTemporaryConnection(const QPointF& point, const PinGridIndex::Hit& pin) {
     if (m_tempConnection) {
-        m_tempConnection->setEndPoint(snapToGrid(point));
+        // 靠近连接点时吸附到连接点，否则对齐网格
+        m_tempConnection->setEndPoint(pin.isValid() ? pin.position : snapToGrid(point));
+    }
+}
+
+void LadderScene::setHoverPin(const PinGridIndex::Hit& pin) {
+    if (pin == m_hoverPin) return;
+    
+    // 只重绘新旧高亮点附近的区域
+    const qreal margin = PinSnapRadius + 2;
+    if (m_hoverPin.isValid()) {
+        update(QRectF(m_hoverPin.position - QPointF(margin, margin), QSizeF(2 * margin, 2 * margin)));
+    }
+    m_hoverPin = pin;
+    if (m_hoverPin.isValid()) {
+        update(QRectF(m_hoverPin.position - QPointF(margin, margin), QSizeF(2 * margin, 2 * margin)));
+    }
+}
+
+void LadderScene::drawForeground(QPainter* painter, const QRectF& rect) {
+    QGraphicsScene::drawForeground(painter, rect);
+    
+    if (m_connectionMode && m_hoverPin.isValid()) {
+        painter->setPen(QPen(QColor(0, 120, 215), 2));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawEllipse(m_hoverPin.position, PinSnapRadius - 2, PinSnapRadius - 2);
     }
 }
 
@@ -397,58 +821,175 @@ void LadderScene::completeConnection(LadderElement* element, int connectionIndex
     conn->setStartElement(m_startElement, m_startConnectionIndex);
     conn->setEndElement(element, connectionIndex);
     conn->updateConnection();
-    addConnection(conn);
+    m_undoStack->push(new AddItemsCommand(this, {}, {conn}, tr("连线")));
+}
+
+void LadderScene::deleteSelection() {
+    QList<LadderElement*> elements;
+    QList<ConnectionLine*> connections;
+    for (auto* item : selectedItems()) {
+        if (auto* element = dynamic_cast<LadderElement*>(item)) {
+            if (containsElement(element)) elements.append(element);
+        } else if (auto* conn = dynamic_cast<ConnectionLine*>(item)) {
+            if (containsConnection(conn)) connections.append(conn);
+        }
+    }
+    if (elements.isEmpty() && connections.isEmpty()) return;
+    
+    m_undoStack->push(new RemoveItemsCommand(this, elements, connections));
+}
+
+SceneSnapshot LadderScene::selectionSnapshot() const {
+    SceneSnapshot snapshot;
+    QSet<LadderElement*> selected;
+    for (auto* item : selectedItems()) {
+        auto* element = dynamic_cast<LadderElement*>(item);
+        if (element && containsElement(element)) {
+            selected.insert(element);
+            snapshot.elements.append(elementRecord(element));
+        }
+    }
+    
+    // 只复制两端都在选区内的连线
+    QSet<ConnectionLine*> seen;
+    for (auto* element : selected) {
+        for (auto* conn : m_adjacency.value(element)) {
+            if (seen.contains(conn)) continue;
+            seen.insert(conn);
+            if (selected.contains(conn->startElement()) && selected.contains(conn->endElement())) {
+                snapshot.connections.append(connectionRecord(conn));
+            }
+        }
+    }
+    return snapshot;
+}
+
+QList<LadderElement*> LadderScene::paste(const SceneSnapshot& snapshot, const QPointF& offset) {
+    // 按记录创建图元；元件在加入场景时分配新ID，连线端点按旧ID映射到新元件
+    QList<LadderElement*> elements;
+    elements.reserve(snapshot.elements.size());
+    QHash<QString, LadderElement*> byId;
+    byId.reserve(snapshot.elements.size());
+    for (const auto& record : snapshot.elements) {
+        LadderElement* element = ElementFactory::create(static_cast<ElementType>(record.value("type").toInt()));
+        if (!element) continue;
+        
+        element->fromMap(record);
+        element->setPos(snapToGrid(element->pos() + offset));
+        elements.append(element);
+        byId.insert(record.value("id").toString(), element);
+    }
+    
+    QList<ConnectionLine*> connections;
+    connections.reserve(snapshot.connections.size());
+    for (const auto& record : snapshot.connections) {
+        LadderElement* start = byId.value(record.value("start_element").toString());
+        LadderElement* end = byId.value(record.value("end_element").toString());
+        if (!start || !end) continue;
+        
+        ConnectionLine* conn = new ConnectionLine();
+        conn->setStartElement(start, record.value("start_connection_index").toInt());
+        conn->setEndElement(end, record.value("end_connection_index").toInt());
+        conn->updateConnection();
+        connections.append(conn);
+    }
+    
+    if (elements.isEmpty()) return elements;
+    
+    m_undoStack->push(new AddItemsCommand(this, elements, connections, tr("粘贴 %1 个元件").arg(elements.size())));
+    
+    clearSelection();
+    for (auto* element : elements) {
+        element->setSelected(true);
+    }
+    return elements;
 }
 
 void LadderScene::mousePressEvent(QGraphicsSceneMouseEvent* event) {
     if (m_connectionMode && event->button() == Qt::LeftButton) {
         // 检查是否点击了连接点
-        QPointF scenePos = event->scenePos();
-        
-        for (auto* item : items(scenePos)) {
-            if (auto* element = dynamic_cast<LadderElement*>(item)) {
-                auto points = element->connectionPoints();
-                for (int i = 0; i < points.size(); ++i) {
-                    QPointF connPos = element->mapToScene(points[i].position);
-                    if (QLineF(scenePos, connPos).length() < 10) {
-                        if (!m_isConnecting) {
-                            startConnection(element, i);
-                        } else {
-                            endConnection(element, i);
-                        }
-                        return;
-                    }
-                }
+        const PinGridIndex::Hit pin = m_pinIndex.nearest(event->scenePos(), PinSnapRadius);
+        if (pin.isValid()) {
+            if (!m_isConnecting) {
+                startConnection(pin.element, pin.pin);
+            } else {
+                endConnection(pin.element, pin.pin);
             }
+            return;
         }
     }
     
     QGraphicsScene::mousePressEvent(event);
+    
+    // 记录拖动前选中元件的位置，松开鼠标时生成一条移动命令；
+    // 拖动过程作为一个批量编辑区间，松开时才自动布线
+    m_dragOrigins.clear();
+    if (event->button() == Qt::LeftButton) {
+        for (auto* item : selectedItems()) {
+            if (auto* element = dynamic_cast<LadderElement*>(item)) {
+                m_dragOrigins.insert(element, element->pos());
+            }
+        }
+        if (!m_dragOrigins.isEmpty() && !m_dragBatch) {
+            m_dragBatch = true;
+            beginBatch();
+        }
+    }
+}
+
+void LadderScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        for (auto* item : items(event->scenePos())) {
+            if (auto* element = dynamic_cast<LadderElement*>(item)) {
+                emit elementDoubleClicked(element);
+                break;
+            }
+        }
+    }
+    
+    QGraphicsScene::mouseDoubleClickEvent(event);
 }
 
 void LadderScene::mouseMoveEvent(QGraphicsSceneMouseEvent* event) {
-    if (m_isConnecting) {
-        updateTemporaryConnection(event->scenePos());
+    if (m_connectionMode) {
+        const PinGridIndex::Hit pin = m_pinIndex.nearest(event->scenePos(), PinSnapRadius);
+        setHoverPin(pin);
+        if (m_isConnecting) {
+            updateTemporaryConnection(event->scenePos(), pin);
+        }
     }
     
     QGraphicsScene::mouseMoveEvent(event);
 }
 
 void LadderScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
+    // 元件在自身的松开事件中对齐网格，之后的位置才是最终位置
     QGraphicsScene::mouseReleaseEvent(event);
+    
+    if (event->button() != Qt::LeftButton) return;
+    if (m_dragBatch) {
+        m_dragBatch = false;
+        endBatch();
+    }
+    if (m_dragOrigins.isEmpty()) return;
+    
+    QList<MoveElementsCommand::Move> moves;
+    for (auto it = m_dragOrigins.constBegin(); it != m_dragOrigins.constEnd(); ++it) {
+        LadderElement* element = it.key();
+        if (containsElement(element) && element->pos() != it.value()) {
+            moves.append(MoveElementsCommand::Move{element, it.value(), element->pos()});
+        }
+    }
+    m_dragOrigins.clear();
+    
+    if (!moves.isEmpty()) {
+        m_undoStack->push(new MoveElementsCommand(this, moves));
+    }
 }
 
 void LadderScene::keyPressEvent(QKeyEvent* event) {
     if (event->key() == Qt::Key_Delete) {
-        // 删除选中的项
-        for (auto* item : selectedItems()) {
-            if (auto* element = dynamic_cast<LadderElement*>(item)) {
-                m_undoStack->push(new RemoveElementCommand(this, element));
-            } else if (auto* conn = dynamic_cast<ConnectionLine*>(item)) {
-                removeConnection(conn);
-                delete conn;
-            }
-        }
+        deleteSelection();
     } else if (event->key() == Qt::Key_Escape) {
         if (m_isConnecting) {
             cancelConnection();
@@ -476,7 +1017,10 @@ LadderScene* LadderView::ladderScene() const {
 
 void LadderView::setupViewport() {
     setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
-    setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    // 只重绘变化区域；背景网格缓存在视图中，滚动时才补画露出的部分
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    setCacheMode(QGraphicsView::CacheBackground);
+    setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing);
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
     setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
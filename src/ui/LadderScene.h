@@ -3,21 +3,32 @@
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QMap>
-#include <QUndoStack>
+#include <QHash>
+#include <QSet>
 #include "../core/LadderElement.h"
 #include "../elements/ConnectionLine.h"
+#include "../core/LdBinFormat.h"
+#include "../core/SceneSnapshot.h"
+#include "../codegen/STCodeGenerator.h"
+#include "PinGridIndex.h"
+#include "RungIndex.h"
+#include "CrossReferenceIndex.h"
+#include "ElementSearchIndex.h"
+#include "UndoHistory.h"
+
+class QIODevice;
 
 namespace LadderDiagram {
 
-class LadderScene : public QGraphicsScene {
+class LadderScene : public QGraphicsScene, public ElementChangeListener {
     Q_OBJECT
 
 public:
     explicit LadderScene(QObject* parent = nullptr);
     ~LadderScene();
     
-    // 添加元件
-    void addElement(LadderElement* element);
+    // 添加元件（id 为空时自动分配新ID）
+    void addElement(LadderElement* element, const QString& id = QString());
     void removeElement(LadderElement* element);
     
     // 添加连接线
@@ -25,19 +36,50 @@ public:
     void removeConnection(ConnectionLine* connection);
     
     // 获取所有元件
-    QList<LadderElement*> elements() const;
+    QList<LadderElement*> elements() const { return m_elements; }
+    int elementCount() const { return m_elements.size(); }
     
     // 获取所有连接线
-    QList<ConnectionLine*> connections() const;
+    QList<ConnectionLine*> connections() const { return m_connections; }
+    int connectionCount() const { return m_connections.size(); }
+    
+    // 是否为场景中登记的元件/连接线
+    bool containsElement(LadderElement* element) const { return m_elementSlots.contains(element); }
+    bool containsConnection(ConnectionLine* connection) const { return m_connectionSlots.contains(connection); }
+    
+    // 获取与指定元件相连的连接线
+    QList<ConnectionLine*> connectionsOf(LadderElement* element) const;
     
     // 获取元件ID（用于序列化）
     QString getElementId(LadderElement* element) const;
     LadderElement* getElementById(const QString& id) const;
     
-    // 序列化
+    // 模型快照：各元件与连接线的值类型记录，按注册表顺序（不稳定）。
+    // 复制开销很小，排序与序列化可以交给工作线程；仿真直接由它编译
+    LadderModel snapshot() const;
+    
+    // 按梯级划分的网络，按纵向位置排序；只有内容变化过的梯级重新生成记录，
+    // 并取得新的 revision
+    QList<LadderNetwork> networks();
+    int rungOf(LadderElement* element) const { return m_rungs.rungOf(element); }
+    
+    // 变量交叉引用；doubleCoils() 返回在不同梯级中被输出线圈重复写入的变量
+    const CrossReferenceIndex& crossReferences() const { return m_crossReferences; }
+    QStringList doubleCoils() const;
+    
+    // 按名称、地址、注释和属性值查找元件，按相关度排序
+    QList<LadderElement*> findElements(const QString& text, int limit) const { return m_search.search(text, limit); }
+    
+    // 序列化（.ldjson，逐条记录流式读写设备）
+    bool writeJson(QIODevice* device) const;
+    bool readJson(QIODevice* device, QString* errorString = nullptr);
     QByteArray toJson() const;
     bool fromJson(const QByteArray& json);
     
+    // 二进制序列化（.ldbin）
+    QByteArray toBinary() const;
+    bool fromBinary(const LdBinReader& reader);
+    
     // 清除所有
     void clearScene();
     
@@ -60,24 +102,78 @@ public:
     void cancelConnection();
     bool isConnecting() const { return m_isConnecting; }
     
+    // 删除选中的元件和连接线（可撤销）
+    void deleteSelection();
+    
+    // 批量添加/移除：重新布线和 contentChanged 在全部完成后统一做一次
+    void addItems(const QList<LadderElement*>& elements, const QStringList& ids,
+                  const QList<ConnectionLine*>& connections);
+    void removeItems(const QList<LadderElement*>& elements, const QList<ConnectionLine*>& connections);
+    
+    // 批量编辑区间：期间移动、增删只更新端点与直角折线，
+    // 区间结束时统一自动布线并发出一次 contentChanged（可嵌套）
+    void beginBatch();
+    void endBatch();
+    
+    // 复制：选中的元件及两端都在选区内的连线
+    SceneSnapshot selectionSnapshot() const;
+    
+    // 粘贴：按快照创建图元（分配新ID、平移 offset），一次加入场景并记为一步撤销；
+    // 粘贴后的元件处于选中状态
+    QList<LadderElement*> paste(const SceneSnapshot& snapshot, const QPointF& offset);
+    
     // 获取撤销栈
-    QUndoStack* undoStack() { return m_undoStack; }
+    UndoHistory* undoStack() { return m_undoStack; }
+    
+    // ElementChangeListener
+    void elementGeometryChanged(LadderElement* element) override;
+    void elementContentChanged(LadderElement* element) override;
+
+signals:
+    // 双击元件（仿真时用于切换触点/线圈的变量）
+    void elementDoubleClicked(LadderElement* element);
+    
+    // 逻辑内容变化（增删元件或连线、移动、属性修改），用于增量刷新ST预览
+    void contentChanged();
 
 protected:
     void drawBackground(QPainter* painter, const QRectF& rect) override;
+    void drawForeground(QPainter* painter, const QRectF& rect) override;
     void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
     void mouseMoveEvent(QGraphicsSceneMouseEvent* event) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
+    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
 
 private:
     void drawGrid(QPainter* painter, const QRectF& rect);
-    void updateTemporaryConnection(const QPointF& point);
+    void updateTemporaryConnection(const QPointF& point, const PinGridIndex::Hit& pin);
+    void setHoverPin(const PinGridIndex::Hit& pin);
     void completeConnection(LadderElement* element, int connectionIndex);
     
+    // 连接线邻接索引维护
+    void attachConnection(LadderElement* element, ConnectionLine* connection);
+    void detachConnection(LadderElement* element, ConnectionLine* connection);
+    
+    // 逻辑记录（元件附带ID，连接线端点以元件ID表示）及其序列化形式
+    ElementData elementData(LadderElement* element) const;
+    ConnectionData connectionData(ConnectionLine* connection) const;
+    QMap<QString, QVariant> elementRecord(LadderElement* element) const;
+    QMap<QString, QVariant> connectionRecord(ConnectionLine* connection) const;
+    
+    // 自动布线：重新布一条连线，或重布走廊与 region 相交的所有连线
+    void routeConnection(ConnectionLine* connection);
+    void rerouteAround(const QRectF& region, QSet<ConnectionLine*>* routed = nullptr);
+    
     bool m_gridEnabled = true;
     int m_gridSize = 20;
     
+    // 网格平铺画刷的单元位图（按缩放档位缓存）
+    QPixmap m_gridTile;
+    int m_gridTileBucket = 0;
+    int m_gridTileSize = 0;
+    qreal m_gridTilePixelRatio = 0;
+    
     // 连接模式
     bool m_connectionMode = false;
     bool m_isConnecting = false;
@@ -85,12 +181,58 @@ private:
     int m_startConnectionIndex = -1;
     ConnectionLine* m_tempConnection = nullptr;
     
-    // 元素ID映射
-    QMap<QString, LadderElement*> m_elementMap;
+    // 连接点空间索引（吸附、拖线与悬停高亮）
+    static constexpr qreal PinSnapRadius = 10.0;
+    PinGridIndex m_pinIndex;
+    PinGridIndex::Hit m_hoverPin;
+    
+    // 元件注册表：连续存储 + 指针到槽位/ID 的哈希，删除时与末尾交换
+    QList<LadderElement*> m_elements;
+    QHash<LadderElement*, int> m_elementSlots;
+    QHash<LadderElement*, QString> m_elementIds;
+    QHash<QString, LadderElement*> m_elementMap;
     int m_nextElementId = 1;
     
+    // 连接线注册表
+    QList<ConnectionLine*> m_connections;
+    QHash<ConnectionLine*, int> m_connectionSlots;
+    
+    // 元件 -> 相连连接线 邻接索引
+    QHash<LadderElement*, QList<ConnectionLine*>> m_adjacency;
+    
+    // 梯级划分（依赖上面的邻接索引）与各梯级的记录缓存
+    struct RungRecords {
+        QList<ElementData> elements;
+        QList<ConnectionData> connections;
+        QPointF topLeft;                // 最上方元件的位置，用于梯级排序
+        quint64 revision = 0;           // 重建时取新值，代码生成器据此复用编译结果
+    };
+    RungIndex m_rungs{m_adjacency};
+    QHash<int, RungRecords> m_rungRecords;
+    quint64 m_rungRevision = 0;
+    RungRecords buildRungRecords(const QList<LadderElement*>& members) const;
+    
+    // 变量交叉引用（随元件增删和内容修改增量维护）
+    CrossReferenceIndex m_crossReferences;
+    
+    // 元件全文检索（同上，增量维护）
+    ElementSearchIndex m_search;
+    
+    // 元件外框（场景坐标）：移动时据此找出旧位置附近需要重布的连线
+    QHash<LadderElement*, QRectF> m_elementOutlines;
+    
+    // 批量编辑期间推迟的布线
+    int m_batchDepth = 0;
+    bool m_batchChanged = false;
+    QRectF m_batchRegion;                       // 增删、移动元件的新旧外框并集
+    QList<ConnectionLine*> m_batchRoutes;       // 新加入或端点移动、尚未布线的连线
+    
+    // 拖动开始时选中元件的位置；拖动期间处于一个批量编辑区间内
+    QHash<LadderElement*, QPointF> m_dragOrigins;
+    bool m_dragBatch = false;
+    
     // 撤销栈
-    QUndoStack* m_undoStack;
+    UndoHistory* m_undoStack;
 };
 
 // 梯形图视图
@@ -140,8 +140,8 @@ void MainWindow::setupStatusBar() {
 
 void MainWindow::setupConnections() {
     // 撤销重做
-    connect(m_scene->undoStack(), &QUndoStack::canUndoChanged, m_actionUndo, &QAction::setEnabled);
-    connect(m_scene->undoStack(), &QUndoStack::canRedoChanged, m_actionRedo, &QAction::setEnabled);
+    connect(m_scene->undoStack(), &UndoHistory::canUndoChanged, m_actionUndo, &QAction::setEnabled);
+    connect(m_scene->undoStack(), &UndoHistory::canRedoChanged, m_actionRedo, &QAction::setEnabled);
     
     // 场景选择变化
     connect(m_scene, &QGraphicsScene::selectionChanged, this, &MainWindow::onSceneSelectionChanged);
@@ -0,0 +1,74 @@
+#include "PinGridIndex.h"
+#include "../core/LadderElement.h"
+#include <QtMath>
+
+namespace LadderDiagram {
+
+quint64 PinGridIndex::cellKey(qint32 cx, qint32 cy) {
+    return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+quint64 PinGridIndex::cellKey(const QPointF& pos) {
+    return cellKey(qint32(qFloor(pos.x() / CellSize)), qint32(qFloor(pos.y() / CellSize)));
+}
+
+void PinGridIndex::update(LadderElement* element) {
+    remove(element);
+
+    const auto points = element->connectionPoints();
+    if (points.isEmpty()) return;
+
+    QVector<quint64>& cells = m_elementCells[element];
+    for (int i = 0; i < points.size(); ++i) {
+        const QPointF position = element->mapToScene(points[i].position);
+        const quint64 key = cellKey(position);
+        m_cells[key].append(Entry{element, i, position});
+        if (!cells.contains(key)) cells.append(key);
+    }
+}
+
+void PinGridIndex::remove(LadderElement* element) {
+    auto it = m_elementCells.find(element);
+    if (it == m_elementCells.end()) return;
+
+    for (quint64 key : *it) {
+        auto cell = m_cells.find(key);
+        if (cell == m_cells.end()) continue;
+        cell->removeIf([element](const Entry& entry) { return entry.element == element; });
+        if (cell->isEmpty()) m_cells.erase(cell);
+    }
+    m_elementCells.erase(it);
+}
+
+void PinGridIndex::clear() {
+    m_cells.clear();
+    m_elementCells.clear();
+}
+
+PinGridIndex::Hit PinGridIndex::nearest(const QPointF& pos, qreal radius) const {
+    Hit hit;
+    qreal best = radius * radius;
+
+    const qint32 cx = qint32(qFloor(pos.x() / CellSize));
+    const qint32 cy = qint32(qFloor(pos.y() / CellSize));
+    for (qint32 dx = -1; dx <= 1; ++dx) {
+        for (qint32 dy = -1; dy <= 1; ++dy) {
+            auto cell = m_cells.constFind(cellKey(cx + dx, cy + dy));
+            if (cell == m_cells.constEnd()) continue;
+
+            for (const Entry& entry : *cell) {
+                const QPointF delta = entry.position - pos;
+                const qreal distance = QPointF::dotProduct(delta, delta);
+                if (distance < best) {
+                    best = distance;
+                    hit.element = entry.element;
+                    hit.pin = entry.pin;
+                    hit.position = entry.position;
+                }
+            }
+        }
+    }
+    return hit;
+}
+
+} // namespace LadderDiagram
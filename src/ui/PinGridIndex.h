@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QHash>
+#include <QPointF>
+#include <QVector>
+
+namespace LadderDiagram {
+
+class LadderElement;
+
+// 连接点空间索引 - 均匀网格
+//
+// 以场景坐标记录所有元件连接点，格子边长不小于吸附半径，
+// 查询时只需检查查询点周围 3x3 个格子，与场景中连接点总数无关。
+// 元件移动时只重新登记该元件自己的连接点。
+class PinGridIndex {
+public:
+    static constexpr qreal CellSize = 40.0;
+
+    struct Hit {
+        LadderElement* element = nullptr;
+        int pin = -1;
+        QPointF position;
+
+        bool isValid() const { return element != nullptr; }
+        bool operator==(const Hit& other) const { return element == other.element && pin == other.pin; }
+        bool operator!=(const Hit& other) const { return !(*this == other); }
+    };
+
+    // 登记/刷新元件的连接点（按元件当前位置）
+    void update(LadderElement* element);
+    void remove(LadderElement* element);
+    void clear();
+
+    // 查找距离 pos 不超过 radius（<= CellSize）的最近连接点
+    Hit nearest(const QPointF& pos, qreal radius) const;
+
+private:
+    struct Entry {
+        LadderElement* element;
+        int pin;
+        QPointF position;
+    };
+
+    static quint64 cellKey(const QPointF& pos);
+    static quint64 cellKey(qint32 cx, qint32 cy);
+
+    QHash<quint64, QVector<Entry>> m_cells;
+    QHash<LadderElement*, QVector<quint64>> m_elementCells;    // 元件 -> 其连接点所在格子
+};
+
+} // namespace LadderDiagram
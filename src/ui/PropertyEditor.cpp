@@ -4,6 +4,7 @@
 #include <QLabel>
 #include <QHeaderView>
 #include <QPushButton>
+#include <QEvent>
 
 namespace LadderDiagram {
 
@@ -55,14 +56,34 @@ void PropertyEditor::setupConnections() {
     connect(m_addressEdit, &QLineEdit::textChanged, this, &PropertyEditor::onAddressChanged);
     connect(m_commentEdit, &QTextEdit::textChanged, this, &PropertyEditor::onCommentChanged);
     connect(m_propertyTable, &QTableWidget::cellChanged, this, &PropertyEditor::onPropertyChanged);
+    
+    // 按回车或离开输入框时结束本次输入；注释框没有对应信号，监听其失去焦点
+    connect(m_nameEdit, &QLineEdit::editingFinished, this, &PropertyEditor::endEditSession);
+    connect(m_addressEdit, &QLineEdit::editingFinished, this, &PropertyEditor::endEditSession);
+    m_commentEdit->installEventFilter(this);
+}
+
+bool PropertyEditor::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == m_commentEdit && event->type() == QEvent::FocusOut) {
+        endEditSession();
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void PropertyEditor::endEditSession() {
+    if (m_history) {
+        m_history->closeMergeChain();
+    }
 }
 
 void PropertyEditor::setElement(LadderElement* element) {
+    endEditSession();
     m_currentElement = element;
     refresh();
 }
 
 void PropertyEditor::clear() {
+    endEditSession();
     m_currentElement = nullptr;
     refresh();
 }
@@ -71,23 +92,46 @@ void PropertyEditor::refresh() {
     m_updating = true;
     
     if (m_currentElement) {
-        m_nameEdit->setText(m_currentElement->name());
+        // 内容相同时不重设，避免输入过程中光标跳到末尾
+        if (m_nameEdit->text() != m_currentElement->name()) {
+            m_nameEdit->setText(m_currentElement->name());
+        }
         m_nameEdit->setEnabled(true);
         
-        m_addressEdit->setText(m_currentElement->address());
+        if (m_addressEdit->text() != m_currentElement->address()) {
+            m_addressEdit->setText(m_currentElement->address());
+        }
         m_addressEdit->setEnabled(true);
         
-        m_commentEdit->setPlainText(m_currentElement->comment());
+        if (m_commentEdit->toPlainText() != m_currentElement->comment()) {
+            m_commentEdit->setPlainText(m_currentElement->comment());
+        }
         m_commentEdit->setEnabled(true);
         
-        // 更新属性表格
+        // 更新属性表格：属性名不变时只改动变化的值（编辑单元格时会经撤销栈回到这里，
+        // 不能替换正在发出信号的单元格）
         auto properties = m_currentElement->properties();
-        m_propertyTable->setRowCount(properties.size());
-        
+        bool sameKeys = m_propertyTable->rowCount() == properties.size();
         int row = 0;
-        for (auto it = properties.begin(); it != properties.end(); ++it, ++row) {
-            m_propertyTable->setItem(row, 0, new QTableWidgetItem(it.key()));
-            m_propertyTable->setItem(row, 1, new QTableWidgetItem(it.value().toString()));
+        for (auto it = properties.begin(); sameKeys && it != properties.end(); ++it, ++row) {
+            QTableWidgetItem* keyItem = m_propertyTable->item(row, 0);
+            sameKeys = keyItem && keyItem->text() == it.key() && m_propertyTable->item(row, 1);
+        }
+        
+        row = 0;
+        if (sameKeys) {
+            for (auto it = properties.begin(); it != properties.end(); ++it, ++row) {
+                QTableWidgetItem* valueItem = m_propertyTable->item(row, 1);
+                if (valueItem->text() != it.value().toString()) {
+                    valueItem->setText(it.value().toString());
+                }
+            }
+        } else {
+            m_propertyTable->setRowCount(properties.size());
+            for (auto it = properties.begin(); it != properties.end(); ++it, ++row) {
+                m_propertyTable->setItem(row, 0, new QTableWidgetItem(it.key()));
+                m_propertyTable->setItem(row, 1, new QTableWidgetItem(it.value().toString()));
+            }
         }
         m_propertyTable->setEnabled(true);
     } else {
@@ -108,39 +152,40 @@ void PropertyEditor::refresh() {
 }
 
 void PropertyEditor::onNameChanged(const QString& text) {
-    if (!m_updating && m_currentElement) {
-        m_currentElement->setName(text);
-    }
+    applyChange(ChangeElementCommand::Name, QString(), text);
 }
 
 void PropertyEditor::onAddressChanged(const QString& text) {
-    if (!m_updating && m_currentElement) {
-        m_currentElement->setAddress(text);
-    }
+    applyChange(ChangeElementCommand::Address, QString(), text);
 }
 
 void PropertyEditor::onCommentChanged() {
-    if (!m_updating && m_currentElement) {
-        m_currentElement->setComment(m_commentEdit->toPlainText());
-    }
+    applyChange(ChangeElementCommand::Comment, QString(), m_commentEdit->toPlainText());
 }
 
-void PropertyEditor::onPropertyChanged() {
-    if (!m_updating && m_currentElement) {
-        updateElementFromUI();
-    }
+void PropertyEditor::onPropertyChanged(int row, int column) {
+    QTableWidgetItem* keyItem = m_propertyTable->item(row, 0);
+    QTableWidgetItem* valueItem = m_propertyTable->item(row, 1);
+    if (column != 1 || !keyItem || !valueItem) return;
+    
+    // 值未变化（只是重新提交了同样的文本）时不产生修改
+    const QString key = keyItem->text();
+    if (m_currentElement && m_currentElement->getProperty(key).toString() == valueItem->text()) return;
+    // 单元格一次提交一个完整的值，每次提交单独成为一步
+    applyChange(ChangeElementCommand::Property, key, valueItem->text());
+    endEditSession();
 }
 
-void PropertyEditor::updateElementFromUI() {
-    for (int row = 0; row < m_propertyTable->rowCount(); ++row) {
-        QTableWidgetItem* keyItem = m_propertyTable->item(row, 0);
-        QTableWidgetItem* valueItem = m_propertyTable->item(row, 1);
-        
-        if (keyItem && valueItem) {
-            QString key = keyItem->text();
-            QString value = valueItem->text();
-            m_currentElement->setProperty(key, value);
-        }
+void PropertyEditor::applyChange(ChangeElementCommand::Field field, const QString& key, const QVariant& value) {
+    if (m_updating || !m_currentElement) return;
+    
+    // 一次输入过程中同一字段的连续修改由撤销历史合并为一步
+    auto* command = new ChangeElementCommand(m_currentElement, field, key, value);
+    if (m_history) {
+        m_history->push(command);
+    } else {
+        command->redo();
+        delete command;
     }
 }
 
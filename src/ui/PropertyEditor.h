@@ -7,6 +7,7 @@
 #include <QSpinBox>
 #include <QComboBox>
 #include "../core/LadderElement.h"
+#include "EditCommands.h"
 
 namespace LadderDiagram {
 
@@ -23,23 +24,33 @@ public:
     
     // 清除选择
     void clear();
+    
+    // 修改经撤销栈执行（未设置时直接修改元件）
+    void setUndoStack(UndoHistory* history) { m_history = history; }
 
 public slots:
     // 更新属性显示
     void refresh();
 
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private slots:
     void onNameChanged(const QString& text);
     void onAddressChanged(const QString& text);
     void onCommentChanged();
-    void onPropertyChanged();
+    void onPropertyChanged(int row, int column);
 
 private:
     void setupUI();
     void setupConnections();
-    void updateElementFromUI();
+    void applyChange(ChangeElementCommand::Field field, const QString& key, const QVariant& value);
+    
+    // 结束一次输入：之后的修改在撤销历史中另起一步
+    void endEditSession();
     
     LadderElement* m_currentElement = nullptr;
+    UndoHistory* m_history = nullptr;
     
     // UI控件
     QLineEdit* m_nameEdit = nullptr;
@@ -4,8 +4,12 @@
 #include "../elements/LogicElements.h"
 #include "../elements/MathElements.h"
 #include "../elements/ControlElements.h"
+#include "../elements/ElementFactory.h"
 #include "../codegen/STCodeGenerator.h"
+#include "../sim/BitSliceEvaluator.h"
 #include "ThemeManager.h"
+#include "EditCommands.h"
+#include "LadderClipboard.h"
 #include <QGraphicsDropShadowEffect>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -16,6 +20,16 @@
 #include <QTreeWidget>
 #include <QStackedWidget>
 #include <QStatusBar>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFontDatabase>
+#include <QScrollBar>
+#include <QSettings>
+#include <QClipboard>
+#include <QCloseEvent>
+#include <limits>
 
 namespace LadderDiagram {
 
@@ -85,9 +99,34 @@ RibbonMainWindow::RibbonMainWindow(QWidget* parent) : QMainWindow(parent) {
     // 所有控件创建完成后再应用主题（确保样式表能应用到所有子控件）
     // 使用 QApplication 级别的样式表确保全局生效
     qApp->setStyleSheet(ThemeManager::instance().getStyleSheet());
+    
+    // 后台保存与定期自动保存
+    m_saver = new BackgroundSaver(this);
+    connect(m_saver, &BackgroundSaver::finished, this, &RibbonMainWindow::onSaveFinished);
+    
+    QDir().mkpath(QFileInfo(recoveryFilePath()).absolutePath());
+    m_autosaveTimer = new QTimer(this);
+    m_autosaveTimer->setInterval(AutosaveInterval);
+    connect(m_autosaveTimer, &QTimer::timeout, this, &RibbonMainWindow::onAutosave);
+    m_autosaveTimer->start();
+    
+    QTimer::singleShot(0, this, &RibbonMainWindow::checkRecoveryFile);
+}
+
+RibbonMainWindow::~RibbonMainWindow() {
+    // 等待未完成的保存落盘；只有文档已成功保存（撤销栈干净）时才删除恢复文件，
+    // 保存失败或未保存的修改留给下次启动时恢复
+    m_autosaveTimer->stop();
+    m_saver->waitForDone();
+    if (m_scene->undoStack()->isClean()) {
+        QFile::remove(recoveryFilePath());
+    }
 }
 
-RibbonMainWindow::~RibbonMainWindow() = default;
+void RibbonMainWindow::closeEvent(QCloseEvent* event) {
+    if (maybeSave()) event->accept();
+    else event->ignore();
+}
 
 void RibbonMainWindow::setupUI() {
     QWidget* mainWidget = new QWidget(this);
@@ -129,13 +168,35 @@ void RibbonMainWindow::setupUI() {
     m_propertyEditor->setMinimumWidth(200);
     m_propertyEditor->setMaximumWidth(300);
     
+    // 视图下方的ST预览（默认隐藏）
+    m_stPreview = new QPlainTextEdit();
+    m_stPreview->setObjectName("stPreview");
+    m_stPreview->setReadOnly(true);
+    m_stPreview->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_stPreview->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_stPreview->setVisible(false);
+    
+    QSplitter* editorSplitter = new QSplitter(Qt::Vertical, this);
+    editorSplitter->addWidget(m_view);
+    editorSplitter->addWidget(m_stPreview);
+    editorSplitter->setSizes({700, 250});
+    
     splitter->addWidget(m_elementLibrary);
-    splitter->addWidget(m_view);
+    splitter->addWidget(editorSplitter);
     splitter->addWidget(m_propertyEditor);
     splitter->setSizes({200, 1000, 220});
     
     mainLayout->addWidget(splitter, 1);
     setCentralWidget(mainWidget);
+    
+    // 交叉引用面板（默认隐藏，可停靠在左右两侧）
+    m_crossReferencePanel = new CrossReferencePanel(m_scene);
+    m_crossReferenceDock = new QDockWidget(tr("交叉引用"), this);
+    m_crossReferenceDock->setObjectName("crossReferenceDock");
+    m_crossReferenceDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+    m_crossReferenceDock->setWidget(m_crossReferencePanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_crossReferenceDock);
+    m_crossReferenceDock->hide();
 }
 
 void RibbonMainWindow::setupElementLibrary() {
@@ -471,6 +532,37 @@ void RibbonMainWindow::setupRibbon() {
     m_viewTabBtn = viewTabBtn;
     m_runTabBtn = runTabBtn;
     
+    // 查找框（右侧，Ctrl+F 聚焦）
+    tabLayout->addStretch();
+    m_searchEdit = new QLineEdit(tabBarFrame);
+    m_searchEdit->setObjectName("searchEdit");
+    m_searchEdit->setPlaceholderText(tr("查找元件（名称/地址/注释）"));
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setFixedWidth(220);
+    tabLayout->addWidget(m_searchEdit);
+    connect(m_searchEdit, &QLineEdit::textChanged, this, &RibbonMainWindow::onSearchTextChanged);
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, &RibbonMainWindow::onSearchNext);
+    
+    QAction* findAction = new QAction(this);
+    findAction->setShortcut(QKeySequence::Find);
+    addAction(findAction);
+    connect(findAction, &QAction::triggered, this, [this] {
+        m_searchEdit->setFocus();
+        m_searchEdit->selectAll();
+    });
+    
+    // 剪贴板快捷键（焦点在输入框时由输入框自己处理）
+    auto addShortcut = [this](QKeySequence::StandardKey key, void (RibbonMainWindow::*slot)()) {
+        QAction* action = new QAction(this);
+        action->setShortcut(key);
+        action->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+        m_view->addAction(action);
+        connect(action, &QAction::triggered, this, slot);
+    };
+    addShortcut(QKeySequence::Cut, &RibbonMainWindow::onCut);
+    addShortcut(QKeySequence::Copy, &RibbonMainWindow::onCopy);
+    addShortcut(QKeySequence::Paste, &RibbonMainWindow::onPaste);
+    
     // Tab 切换连接
     connect(fileTabBtn, &QToolButton::clicked, this, [this]() { switchToTab(0); });
     connect(homeTabBtn, &QToolButton::clicked, this, [this]() { switchToTab(1); });
@@ -687,6 +779,16 @@ QWidget* RibbonMainWindow::createViewPanel() {
     m_buttons.connectionMode->setCheckable(true);
     connect(m_buttons.connectionMode, &QToolButton::clicked, this, &RibbonMainWindow::onToggleConnectionMode);
     
+    m_buttons.stPreview = displayGroup->addButton(tr("ST预览"), "", tr("实时预览生成的ST代码"));
+    m_buttons.stPreview->setIcon(QApplication::style()->standardIcon(QStyle::SP_FileDialogContentsView));
+    m_buttons.stPreview->setCheckable(true);
+    connect(m_buttons.stPreview, &QToolButton::clicked, this, &RibbonMainWindow::onToggleStPreview);
+    
+    m_buttons.crossReference = displayGroup->addButton(tr("交叉引用"), "", tr("查看变量在哪些元件中被读写"));
+    m_buttons.crossReference->setIcon(QApplication::style()->standardIcon(QStyle::SP_FileDialogListView));
+    m_buttons.crossReference->setCheckable(true);
+    connect(m_buttons.crossReference, &QToolButton::clicked, this, &RibbonMainWindow::onToggleCrossReference);
+    
     layout->addWidget(displayGroup);
     
     layout->addSpacing(16);
@@ -722,6 +824,20 @@ QWidget* RibbonMainWindow::createRunPanel() {
     m_buttons.stopSim->setEnabled(false);
     connect(m_buttons.stopSim, &QToolButton::clicked, this, &RibbonMainWindow::onStopSimulation);
     
+    QToolButton* sweepBtn = runGroup->addButton(tr("输入扫描"), "", tr("对纯布尔网络遍历全部输入组合"));
+    sweepBtn->setIcon(QApplication::style()->standardIcon(QStyle::SP_BrowserReload));
+    connect(sweepBtn, &QToolButton::clicked, this, &RibbonMainWindow::onSweepInputs);
+    
+    runGroup->addSeparator();
+    
+    // 扫描周期
+    m_scanPeriodSpin = new QSpinBox(runGroup);
+    m_scanPeriodSpin->setRange(ScanEngine::MinScanPeriod, ScanEngine::MaxScanPeriod);
+    m_scanPeriodSpin->setValue(10);
+    m_scanPeriodSpin->setSuffix(tr(" ms"));
+    m_scanPeriodSpin->setToolTip(tr("扫描周期"));
+    runGroup->addWidget(m_scanPeriodSpin);
+    
     layout->addWidget(runGroup);
     
     // 代码生成组
@@ -754,93 +870,50 @@ void RibbonMainWindow::setupStatusBar() {
 }
 
 void RibbonMainWindow::setupConnections() {
-    connect(m_scene->undoStack(), &QUndoStack::canUndoChanged, m_buttons.undo, &QToolButton::setEnabled);
-    connect(m_scene->undoStack(), &QUndoStack::canRedoChanged, m_buttons.redo, &QToolButton::setEnabled);
+    UndoHistory* history = m_scene->undoStack();
+    connect(history, &UndoHistory::canUndoChanged, m_buttons.undo, &QToolButton::setEnabled);
+    connect(history, &UndoHistory::canRedoChanged, m_buttons.redo, &QToolButton::setEnabled);
+    
+    // 每次编辑、撤销或重做后：更新修改标记，属性面板显示撤销后的值
+    connect(history, &UndoHistory::indexChanged, this, [this, history] {
+        m_modified = !history->isClean();
+        m_propertyEditor->refresh();
+    });
+    m_propertyEditor->setUndoStack(history);
+    
+    // 撤销历史的内存上限（MB），可在配置文件中修改
+    QSettings settings("LadderDiagram", "Editor");
+    const qsizetype budget = settings.value("undoBudgetMB", int(UndoHistory::DefaultByteBudget >> 20)).toLongLong();
+    history->setByteBudget(budget << 20);
     connect(m_scene, &QGraphicsScene::selectionChanged, this, &RibbonMainWindow::onSceneSelectionChanged);
+    connect(m_scene, &LadderScene::elementDoubleClicked, this, &RibbonMainWindow::onElementDoubleClicked);
+    
+    m_previewTimer = new QTimer(this);
+    m_previewTimer->setSingleShot(true);
+    m_previewTimer->setInterval(0);
+    connect(m_previewTimer, &QTimer::timeout, this, &RibbonMainWindow::onUpdateStPreview);
+    connect(m_scene, &LadderScene::contentChanged, this, [this] {
+        ++m_changeCount;
+        if (m_stPreview->isVisible()) m_previewTimer->start();
+    });
+    
+    // 面板关闭按钮与视图按钮保持同步（被其他停靠面板遮住时不算关闭）
+    connect(m_crossReferenceDock, &QDockWidget::visibilityChanged, this, [this] {
+        m_buttons.crossReference->setChecked(!m_crossReferenceDock->isHidden());
+    });
+    connect(m_crossReferencePanel, &CrossReferencePanel::elementActivated,
+            this, &RibbonMainWindow::onCrossReferenceActivated);
 }
 
 
 
 void RibbonMainWindow::addElementToScene(ElementType type) {
-    LadderElement* element = nullptr;
-    
-    switch (type) {
-        // 电源轨线
-        case ElementType::LeftPowerRail: element = new LeftPowerRail(); break;
-        case ElementType::RightPowerRail: element = new RightPowerRail(); break;
-        
-        // 触点
-        case ElementType::NormallyOpen: element = new NormallyOpenContact(); break;
-        case ElementType::NormallyClosed: element = new NormallyClosedContact(); break;
-        case ElementType::PositiveEdge: element = new PositiveEdgeContact(); break;
-        case ElementType::NegativeEdge: element = new NegativeEdgeContact(); break;
-        
-        // 线圈
-        case ElementType::OutputCoil: element = new OutputCoil(); break;
-        case ElementType::InvertedCoil: element = new InvertedCoil(); break;
-        case ElementType::SetCoil: element = new SetCoil(); break;
-        case ElementType::ResetCoil: element = new ResetCoil(); break;
-        case ElementType::PositiveEdgeCoil: element = new PositiveEdgeCoil(); break;
-        case ElementType::NegativeEdgeCoil: element = new NegativeEdgeCoil(); break;
-        
-        // 定时器
-        case ElementType::Timer: element = new Timer(); break;
-        case ElementType::TimerTOF: {
-            auto* timer = new Timer();
-            timer->setTimerType(Timer::TOF);
-            element = timer;
-            break;
-        }
-        case ElementType::TimerTP: {
-            auto* timer = new Timer();
-            timer->setTimerType(Timer::TP);
-            element = timer;
-            break;
-        }
-        
-        // 计数器
-        case ElementType::Counter: element = new Counter(); break;
-        case ElementType::CounterCTD: {
-            auto* counter = new Counter();
-            counter->setCounterType(Counter::CTD);
-            element = counter;
-            break;
-        }
-        case ElementType::CounterCTUD: {
-            auto* counter = new Counter();
-            counter->setCounterType(Counter::CTUD);
-            element = counter;
-            break;
-        }
-        
-        // 功能块
-        case ElementType::RTrig: element = new RTrig(); break;
-        case ElementType::FTrig: element = new FTrig(); break;
-        case ElementType::RS: element = new RS(); break;
-        case ElementType::SR: element = new SR(); break;
-        
-        // 逻辑运算
-        case ElementType::LogicAND: element = new LogicAND(); break;
-        case ElementType::LogicOR: element = new LogicOR(); break;
-        case ElementType::LogicNOT: element = new LogicNOT(); break;
-        
-        // 数学/比较
-        case ElementType::Comparison: element = new Comparison(); break;
-        case ElementType::MathOperation: element = new MathOperation(); break;
-        
-        // 程序控制
-        case ElementType::Jump: element = new Jump(); break;
-        case ElementType::Return: element = new Return(); break;
-        case ElementType::Label: element = new Label(); break;
-        
-        default: return;
-    }
+    LadderElement* element = ElementFactory::create(type);
     
     if (element) {
         QPointF pos = m_view->mapToScene(m_view->viewport()->rect().center());
         element->setPos(m_scene->snapToGrid(pos));
-        m_scene->addElement(element);
-        m_modified = true;
+        m_scene->undoStack()->push(new AddItemsCommand(m_scene, {element}, {}, tr("添加元件")));
     }
 }
 
@@ -857,7 +930,7 @@ void RibbonMainWindow::onNewFile() {
 void RibbonMainWindow::onOpenFile() {
     if (!maybeSave()) return;
     QString fileName = QFileDialog::getOpenFileName(this, tr("打开文件"), QString(),
-                                                    tr("梯形图文件 (*.ldjson);;所有文件 (*.*)"));
+                                                    tr("梯形图文件 (*.ldjson *.ldbin);;JSON 梯形图 (*.ldjson);;二进制梯形图 (*.ldbin);;所有文件 (*.*)"));
     if (!fileName.isEmpty()) loadFile(fileName);
 }
 
@@ -868,32 +941,54 @@ void RibbonMainWindow::onSaveFile() {
 
 void RibbonMainWindow::onSaveFileAs() {
     QString fileName = QFileDialog::getSaveFileName(this, tr("保存文件"), QString(),
-                                                    tr("梯形图文件 (*.ldjson);;所有文件 (*.*)"));
+                                                    tr("JSON 梯形图 (*.ldjson);;二进制梯形图 (*.ldbin);;所有文件 (*.*)"));
     if (!fileName.isEmpty()) saveFile(fileName);
 }
 
 void RibbonMainWindow::onExit() {
-    if (maybeSave()) QApplication::quit();
+    // 经 closeEvent 询问保存，最后一个窗口关闭后程序退出
+    close();
 }
 
 void RibbonMainWindow::onUndo() { m_scene->undoStack()->undo(); }
 void RibbonMainWindow::onRedo() { m_scene->undoStack()->redo(); }
 
 void RibbonMainWindow::onDelete() {
-    for (auto* item : m_scene->selectedItems()) {
-        if (auto* element = dynamic_cast<LadderElement*>(item)) {
-            m_scene->removeElement(element);
-            delete element;
-        } else if (auto* conn = dynamic_cast<ConnectionLine*>(item)) {
-            m_scene->removeConnection(conn);
-            delete conn;
-        }
-    }
+    m_scene->deleteSelection();
+}
+
+void RibbonMainWindow::onCut() {
+    onCopy();
+    m_scene->deleteSelection();
+}
+
+void RibbonMainWindow::onCopy() {
+    const SceneSnapshot snapshot = m_scene->selectionSnapshot();
+    if (snapshot.elements.isEmpty()) return;
+    
+    QApplication::clipboard()->setMimeData(LadderClipboard::toMimeData(snapshot));
+    m_pasteCount = 0;
+    statusBar()->showMessage(tr("已复制 %1 个元件").arg(snapshot.elements.size()), 2000);
 }
 
-void RibbonMainWindow::onCut() {}
-void RibbonMainWindow::onCopy() {}
-void RibbonMainWindow::onPaste() {}
+void RibbonMainWindow::onPaste() {
+    SceneSnapshot snapshot;
+    if (!LadderClipboard::fromMimeData(QApplication::clipboard()->mimeData(), snapshot)) return;
+    
+    // 粘贴到视图中心：以内容左上角对齐，连续粘贴时逐次错开两格
+    QPointF topLeft(std::numeric_limits<qreal>::max(), std::numeric_limits<qreal>::max());
+    for (const auto& record : snapshot.elements) {
+        topLeft.setX(qMin(topLeft.x(), record.value("x").toReal()));
+        topLeft.setY(qMin(topLeft.y(), record.value("y").toReal()));
+    }
+    const qreal step = 2 * m_scene->gridSize() * m_pasteCount++;
+    const QPointF target = m_view->mapToScene(m_view->viewport()->rect().center()) + QPointF(step, step);
+    
+    QElapsedTimer timer;
+    timer.start();
+    const QList<LadderElement*> pasted = m_scene->paste(snapshot, target - topLeft);
+    statusBar()->showMessage(tr("已粘贴 %1 个元件，用时 %2 ms").arg(pasted.size()).arg(timer.elapsed()), 2000);
+}
 
 void RibbonMainWindow::onSelectAll() {
     for (auto* item : m_scene->items()) item->setSelected(true);
@@ -924,17 +1019,130 @@ void RibbonMainWindow::onAddLeftRail() { addElementToScene(ElementType::LeftPowe
 void RibbonMainWindow::onAddRightRail() { addElementToScene(ElementType::RightPowerRail); }
 
 void RibbonMainWindow::onRunSimulation() {
-    statusBar()->showMessage(tr("仿真运行中..."));
+    // 编译当前场景
+    // 直接由场景的值类型记录编译，不经 JSON 文本或键值表往返
+    const LadderModel model = m_scene->snapshot();
+    SimProgram program;
+    program.compile(model.elements, model.connections);
+    
+    m_simElementSlots.clear();
+    m_simOperandSlots.clear();
+    for (auto* element : m_scene->elements()) {
+        const QString id = m_scene->getElementId(element);
+        int slot = program.elementSlot(id);
+        if (slot >= 0) m_simElementSlots.append(qMakePair(element, slot));
+        int operand = program.operandSlot(id);
+        if (operand >= 0) m_simOperandSlots.insert(element, operand);
+    }
+    
+    if (!m_scanEngine) {
+        m_scanEngine = new ScanEngine(this);
+        connect(m_scanEngine, &ScanEngine::faulted, this, &RibbonMainWindow::onSimulationFault);
+        m_simDisplayTimer = new QTimer(this);
+        m_simDisplayTimer->setInterval(ScanEngine::PublishInterval);
+        connect(m_simDisplayTimer, &QTimer::timeout, this, &RibbonMainWindow::onSimulationTick);
+        connect(m_scanPeriodSpin, &QSpinBox::valueChanged, m_scanEngine, &ScanEngine::setScanPeriod);
+    }
+    m_scanEngine->setScanPeriod(m_scanPeriodSpin->value());
+    m_scanEngine->start(program);
+    m_simDisplayTimer->start();
+    
+    statusBar()->showMessage(tr("仿真运行中... 双击触点切换变量"));
     m_buttons.runSim->setEnabled(false);
     m_buttons.stopSim->setEnabled(true);
 }
 
 void RibbonMainWindow::onStopSimulation() {
+    if (m_scanEngine) {
+        m_scanEngine->stop();
+        m_simDisplayTimer->stop();
+    }
+    for (const auto& entry : m_simElementSlots) {
+        if (m_scene->containsElement(entry.first)) entry.first->setEnergized(false);
+    }
+    m_simElementSlots.clear();
+    m_simOperandSlots.clear();
+    
     statusBar()->showMessage(tr("仿真已停止"));
     m_buttons.runSim->setEnabled(true);
     m_buttons.stopSim->setEnabled(false);
 }
 
+void RibbonMainWindow::onSimulationTick() {
+    if (!m_scanEngine->takeSnapshot(m_simBits)) return;
+    
+    for (const auto& entry : m_simElementSlots) {
+        // 仿真期间被删除的元件跳过
+        if (!m_scene->containsElement(entry.first)) continue;
+        int slot = entry.second;
+        entry.first->setEnergized((m_simBits[slot >> 6] >> (slot & 63)) & 1u);
+    }
+    statusBar()->showMessage(tr("仿真运行中... 扫描次数: %1").arg(m_scanEngine->scanCount()));
+}
+
+void RibbonMainWindow::onSimulationFault(const QString& message) {
+    onStopSimulation();
+    QMessageBox::warning(this, tr("仿真停止"), message);
+}
+
+void RibbonMainWindow::onElementDoubleClicked(LadderElement* element) {
+    if (!m_scanEngine || !m_scanEngine->isRunning()) return;
+    
+    auto it = m_simOperandSlots.constFind(element);
+    if (it != m_simOperandSlots.constEnd()) {
+        m_scanEngine->toggleBit(it.value());
+    }
+}
+
+void RibbonMainWindow::onSweepInputs() {
+    const LadderModel model = m_scene->snapshot();
+    BitSliceEvaluator evaluator;
+    if (!evaluator.compile(model.elements, model.connections)) {
+        QMessageBox::warning(this, tr("输入扫描"), evaluator.errorString());
+        return;
+    }
+    if (evaluator.outputs().isEmpty()) {
+        QMessageBox::information(this, tr("输入扫描"), tr("梯形图中没有输出线圈"));
+        return;
+    }
+    
+    // 自保持回路需要多扫描几次才能稳定
+    evaluator.setScansPerVector(2);
+    
+    // 统计每个输出为TRUE的输入组合数
+    QVector<qint64> trueCounts(evaluator.outputs().size(), 0);
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = evaluator.sweep([&trueCounts](qint64, int count, const BitSliceEvaluator& result) {
+        const int fullWords = count / 64;
+        const int restBits = count % 64;
+        for (int o = 0; o < trueCounts.size(); ++o) {
+            const quint64* row = result.outputRow(o);
+            qint64 ones = 0;
+            for (int w = 0; w < fullWords; ++w) ones += qPopulationCount(row[w]);
+            if (restBits) ones += qPopulationCount(row[fullWords] & ((quint64(1) << restBits) - 1));
+            trueCounts[o] += ones;
+        }
+    });
+    const qint64 elapsedMs = timer.elapsed();
+    
+    if (!ok) {
+        QMessageBox::warning(this, tr("输入扫描"), evaluator.errorString());
+        return;
+    }
+    
+    const qint64 total = qint64(1) << evaluator.inputs().size();
+    QString report = tr("输入: %1 个，组合: %2，耗时: %3 ms（%4）\n\n")
+                         .arg(evaluator.inputs().size())
+                         .arg(total)
+                         .arg(elapsedMs)
+                         .arg(BitSliceEvaluator::usesAvx2() ? "AVX2" : tr("标量"));
+    for (int o = 0; o < trueCounts.size(); ++o) {
+        report += tr("%1 = TRUE: %2 / %3\n").arg(evaluator.outputs()[o]).arg(trueCounts[o]).arg(total);
+    }
+    QMessageBox::information(this, tr("输入扫描"), report);
+}
+
 void RibbonMainWindow::onGenerateCode() {
     // 获取保存路径
     QString filePath = QFileDialog::getSaveFileName(this, tr("生成ST代码"), QString(),
@@ -946,34 +1154,64 @@ void RibbonMainWindow::onGenerateCode() {
         filePath += ".st";
     }
     
-    // 创建简单的ST代码
-    QString stCode = "(* 梯形图生成的ST代码 *)\n";
-    stCode += "PROGRAM LadderProgram\n\n";
-    stCode += "VAR\n";
-    stCode += "    Start : BOOL;\n";
-    stCode += "    Stop : BOOL;\n";
-    stCode += "    Motor : BOOL;\n";
-    stCode += "END_VAR\n\n";
-    stCode += "(* 主程序 *)\n";
-    stCode += "Motor := Start AND NOT Stop;\n\n";
-    stCode += "END_PROGRAM\n";
-    
+    // 由当前场景编译ST代码
+    STCodeGenerator generator;
+    const QString programName = STCodeGenerator::programNameForFile(m_currentFile);
+    if (!programName.isEmpty()) {
+        generator.setProgramName(programName);
+    }
+    for (const LadderNetwork& network : m_scene->networks()) {
+        generator.addNetwork(network);
+    }
+
     // 保存到文件
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream stream(&file);
-        stream.setEncoding(QStringConverter::Utf8);
-        stream << stCode;
-        file.close();
-        
+    if (generator.saveToFile(filePath)) {
         statusBar()->showMessage(tr("ST代码已生成: %1").arg(filePath), 5000);
         QMessageBox::information(this, tr("代码生成成功"), 
                                  tr("ST代码已保存到:\n%1").arg(filePath));
+    } else if (generator.hasErrors()) {
+        QMessageBox::warning(this, tr("生成失败"), generator.errors().join("\n"));
     } else {
         QMessageBox::warning(this, tr("生成失败"), tr("无法保存文件: %1").arg(filePath));
     }
 }
 
+void RibbonMainWindow::onToggleStPreview() {
+    m_stPreview->setVisible(m_buttons.stPreview->isChecked());
+    if (m_stPreview->isVisible()) {
+        onUpdateStPreview();
+    }
+}
+
+void RibbonMainWindow::onToggleCrossReference() {
+    m_crossReferenceDock->setVisible(m_buttons.crossReference->isChecked());
+}
+
+void RibbonMainWindow::onUpdateStPreview() {
+    if (!m_stPreview->isVisible()) return;
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    m_previewGenerator.clearNetworks();
+    for (const LadderNetwork& network : m_scene->networks()) {
+        m_previewGenerator.addNetwork(network);
+    }
+    const QString code = m_previewGenerator.generatePreview();
+    
+    // 保持滚动位置
+    if (code != m_stPreview->toPlainText()) {
+        const int scroll = m_stPreview->verticalScrollBar()->value();
+        m_stPreview->setPlainText(code);
+        m_stPreview->verticalScrollBar()->setValue(scroll);
+    }
+    
+    statusBar()->showMessage(tr("ST预览已更新：重新编译 %1/%2 个网络，用时 %3 µs")
+                             .arg(m_previewGenerator.lastRecompiledCount())
+                             .arg(m_previewGenerator.networkCount())
+                             .arg(timer.nsecsElapsed() / 1000), 2000);
+}
+
 void RibbonMainWindow::onAbout() {
     QMessageBox::about(this, tr("关于梯形图编辑器"),
                        tr("<h2>梯形图编辑器 1.0</h2>"
@@ -991,6 +1229,49 @@ void RibbonMainWindow::onSceneSelectionChanged() {
     m_propertyEditor->clear();
 }
 
+void RibbonMainWindow::onCrossReferenceActivated(LadderElement* element) {
+    m_scene->clearSelection();
+    element->setSelected(true);
+    m_view->centerOn(element);
+}
+
+void RibbonMainWindow::onSearchTextChanged(const QString& text) {
+    m_searchResults = m_scene->findElements(text, MaxSearchResults);
+    m_searchIndex = -1;
+    if (m_searchResults.isEmpty()) {
+        if (!text.trimmed().isEmpty()) {
+            statusBar()->showMessage(tr("未找到 \"%1\"").arg(text.trimmed()), 2000);
+        }
+        return;
+    }
+    showSearchResult(0);
+}
+
+void RibbonMainWindow::onSearchNext() {
+    if (m_searchResults.isEmpty()) return;
+    showSearchResult((m_searchIndex + 1) % m_searchResults.size());
+}
+
+void RibbonMainWindow::showSearchResult(int index) {
+    LadderElement* element = m_searchResults.value(index);
+    if (!element || !m_scene->containsElement(element)) {
+        // 结果中的元件已被删除：按当前内容重新查找
+        onSearchTextChanged(m_searchEdit->text());
+        return;
+    }
+    
+    m_searchIndex = index;
+    m_scene->clearSelection();
+    element->setSelected(true);
+    m_view->centerOn(element);
+    
+    QString message = tr("找到 %1 个元件，第 %2 个").arg(m_searchResults.size()).arg(index + 1);
+    if (m_searchResults.size() >= MaxSearchResults) {
+        message = tr("找到 %1 个以上元件，第 %2 个").arg(MaxSearchResults).arg(index + 1);
+    }
+    statusBar()->showMessage(message, 3000);
+}
+
 void RibbonMainWindow::onToggleTheme() {
     ThemeManager::instance().toggleTheme();
     ThemeManager::instance().applyToWidget(this);
@@ -1000,6 +1281,8 @@ void RibbonMainWindow::onToggleTheme() {
 void RibbonMainWindow::onRibbonTabChanged(int index) { Q_UNUSED(index) }
 
 bool RibbonMainWindow::maybeSave() {
+    // 先等之前提交的保存落盘：失败时 onSaveFinished 会恢复修改标记
+    flushPendingSaves();
     if (!m_modified) return true;
     
     auto ret = QMessageBox::warning(this, tr("梯形图编辑器"),
@@ -1007,47 +1290,133 @@ bool RibbonMainWindow::maybeSave() {
                                     QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel);
     
     switch (ret) {
-        case QMessageBox::Save: return saveFile(m_currentFile);
-        case QMessageBox::Cancel: return false;
-        default: return true;
+        case QMessageBox::Save:
+            if (!saveFile(m_currentFile)) return false;
+            // 关闭、新建、打开前必须确认文件已写入磁盘
+            flushPendingSaves();
+            return !m_modified;
+        case QMessageBox::Cancel:
+            return false;
+        default:
+            // 放弃修改时恢复文件也不再需要
+            m_saver->waitForDone();
+            QFile::remove(recoveryFilePath());
+            return true;
     }
 }
 
+void RibbonMainWindow::flushPendingSaves() {
+    // 等待后台任务完成，并立即投递已排队的 finished 通知，
+    // 使保存结果（撤销栈标记干净或恢复修改标记）在返回前生效
+    m_saver->waitForDone();
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+}
+
 bool RibbonMainWindow::saveFile(const QString& path) {
     QString filePath = path;
     if (filePath.isEmpty()) {
         filePath = QFileDialog::getSaveFileName(this, tr("保存文件"), QString(),
-                                                tr("梯形图文件 (*.ldjson)"));
+                                                tr("JSON 梯形图 (*.ldjson);;二进制梯形图 (*.ldbin)"));
         if (filePath.isEmpty()) return false;
     }
     
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::warning(this, tr("错误"), tr("无法保存文件 %1").arg(filePath));
-        return false;
-    }
-    
-    file.write(m_scene->toJson());
-    file.close();
+    // 在界面线程取快照，序列化与写盘交给后台线程；按扩展名选择格式
+    const bool binary = QFileInfo(filePath).suffix().compare("ldbin", Qt::CaseInsensitive) == 0;
+    m_savingChange = m_changeCount;
+    m_saver->save(m_scene->snapshot(), filePath, binary ? BackgroundSaver::Binary : BackgroundSaver::Json);
     
     setCurrentFile(filePath);
     m_modified = false;
-    statusBar()->showMessage(tr("文件已保存"), 2000);
+    statusBar()->showMessage(tr("正在保存..."));
     return true;
 }
 
+void RibbonMainWindow::onSaveFinished(const QString& path, bool ok, const QString& errorString) {
+    if (path == recoveryFilePath()) {
+        if (!ok) statusBar()->showMessage(tr("自动保存失败: %1").arg(errorString), 5000);
+        return;
+    }
+    
+    if (!ok) {
+        m_modified = true;
+        QMessageBox::warning(this, tr("错误"), tr("无法保存文件 %1: %2").arg(path, errorString));
+        return;
+    }
+    
+    // 保存期间没有新的编辑时，把撤销栈标记为干净
+    if (m_changeCount == m_savingChange) {
+        m_scene->undoStack()->setClean();
+    }
+    statusBar()->showMessage(tr("文件已保存"), 2000);
+}
+
+void RibbonMainWindow::onAutosave() {
+    // 自上次自动保存以来内容没有变化、文档与已保存版本一致，
+    // 或者仍有保存任务未完成时跳过
+    if (m_changeCount == m_autosavedChange || m_scene->undoStack()->isClean() || m_saver->isBusy()) return;
+    
+    m_autosavedChange = m_changeCount;
+    m_saver->save(m_scene->snapshot(), recoveryFilePath(), BackgroundSaver::Binary, true);
+}
+
+QString RibbonMainWindow::recoveryFilePath() const {
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/recovery.ldbin.z";
+}
+
+void RibbonMainWindow::checkRecoveryFile() {
+    QFile file(recoveryFilePath());
+    if (!file.exists()) return;
+    
+    auto ret = QMessageBox::question(this, tr("梯形图编辑器"),
+                                     tr("检测到上次未正常退出时自动保存的内容，是否恢复？"));
+    if (ret != QMessageBox::Yes || !file.open(QIODevice::ReadOnly)) {
+        file.remove();
+        return;
+    }
+    
+    const QByteArray data = qUncompress(file.readAll());
+    file.close();
+    
+    LdBinReader reader;
+    if (!reader.openData(reinterpret_cast<const uchar*>(data.constData()), data.size())
+        || !m_scene->fromBinary(reader)) {
+        QMessageBox::warning(this, tr("错误"), tr("无法恢复自动保存的内容: %1").arg(reader.errorString()));
+        return;
+    }
+    
+    setCurrentFile(QString());
+    m_modified = true;
+    statusBar()->showMessage(tr("已恢复自动保存的内容"), 2000);
+}
+
 bool RibbonMainWindow::loadFile(const QString& path) {
+    // 二进制格式直接映射文件读取
+    if (QFileInfo(path).suffix().compare("ldbin", Qt::CaseInsensitive) == 0) {
+        LdBinReader reader;
+        if (!reader.open(path) || !m_scene->fromBinary(reader)) {
+            QMessageBox::warning(this, tr("错误"), tr("无法解析文件 %1: %2").arg(path, reader.errorString()));
+            return false;
+        }
+        
+        setCurrentFile(path);
+        m_modified = false;
+        statusBar()->showMessage(tr("文件已加载"), 2000);
+        return true;
+    }
+    
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
         QMessageBox::warning(this, tr("错误"), tr("无法打开文件 %1").arg(path));
         return false;
     }
     
-    QByteArray data = file.readAll();
+    // 边读边解析，不整体读入文件
+    QString error;
+    const bool parsed = m_scene->readJson(&file, &error);
     file.close();
     
-    if (!m_scene->fromJson(data)) {
-        QMessageBox::warning(this, tr("错误"), tr("无法解析文件 %1").arg(path));
+    if (!parsed) {
+        QMessageBox::warning(this, tr("错误"), tr("无法解析文件 %1: %2").arg(path, error));
         return false;
     }
     
@@ -10,8 +10,17 @@
 #include <QAction>
 #include <QLabel>
 #include <QTreeWidget>
+#include <QSpinBox>
+#include <QTimer>
+#include <QPlainTextEdit>
+#include <QDockWidget>
+#include <QLineEdit>
 #include "LadderScene.h"
 #include "PropertyEditor.h"
+#include "CrossReferencePanel.h"
+#include "../sim/ScanEngine.h"
+#include "../core/BackgroundSaver.h"
+#include "../codegen/STCodeGenerator.h"
 
 namespace LadderDiagram {
 
@@ -65,6 +74,9 @@ public:
     explicit RibbonMainWindow(QWidget* parent = nullptr);
     ~RibbonMainWindow();
 
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
 private slots:
     // 文件操作
     void onNewFile();
@@ -88,6 +100,8 @@ private slots:
     void onZoomReset();
     void onToggleGrid();
     void onToggleConnectionMode();
+    void onToggleStPreview();
+    void onToggleCrossReference();
     
     // 元件操作
     void onAddContactNO();
@@ -104,6 +118,17 @@ private slots:
     void onRunSimulation();
     void onStopSimulation();
     void onGenerateCode();
+    void onUpdateStPreview();
+    
+    // 仿真显示刷新与输入切换
+    void onSimulationTick();
+    void onSimulationFault(const QString& message);
+    void onElementDoubleClicked(LadderElement* element);
+    void onSweepInputs();
+    
+    // 后台保存与自动保存
+    void onSaveFinished(const QString& path, bool ok, const QString& errorString);
+    void onAutosave();
     
     // 帮助
     void onAbout();
@@ -111,6 +136,13 @@ private slots:
     // 场景选择变化
     void onSceneSelectionChanged();
     
+    // 交叉引用面板中选中元件
+    void onCrossReferenceActivated(LadderElement* element);
+    
+    // 查找元件：输入时定位到最相关的元件，回车跳到下一个
+    void onSearchTextChanged(const QString& text);
+    void onSearchNext();
+    
     // Tab 切换
     void onRibbonTabChanged(int index);
     
@@ -138,9 +170,17 @@ private:
     // 文件操作辅助
     bool maybeSave();
     bool saveFile(const QString& path);
+    void flushPendingSaves();
     bool loadFile(const QString& path);
     void setCurrentFile(const QString& path);
     
+    // 恢复文件（自动保存）
+    QString recoveryFilePath() const;
+    void checkRecoveryFile();
+    
+    // 选中并居中显示第 index 个查找结果
+    void showSearchResult(int index);
+    
     // 更新按钮状态
     void updateActionStates();
 
@@ -169,6 +209,43 @@ private:
     QString m_currentFile;
     bool m_modified = false;
     
+    // 后台保存
+    static constexpr int AutosaveInterval = 60 * 1000;     // ms
+    BackgroundSaver* m_saver = nullptr;
+    QTimer* m_autosaveTimer = nullptr;
+    // 场景内容变化计数，只增不减。撤销后再编辑会回到同一撤销栈位置，
+    // 合并的连续编辑不改变位置，是否有新修改只能以它判断
+    quint64 m_changeCount = 0;
+    quint64 m_savingChange = 0;     // 正在保存的快照对应的变化计数
+    quint64 m_autosavedChange = 0;  // 上次自动保存时的变化计数
+    
+    // ST 实时预览：场景变化后合并到下一轮事件循环刷新，
+    // 生成器保留各网络的编译缓存，只重新编译改动过的网络
+    QPlainTextEdit* m_stPreview = nullptr;
+    QTimer* m_previewTimer = nullptr;
+    STCodeGenerator m_previewGenerator;
+    
+    // 同一剪贴板内容的连续粘贴次数（用于错开位置）
+    int m_pasteCount = 0;
+    
+    // 查找框与当前结果
+    static constexpr int MaxSearchResults = 200;
+    QLineEdit* m_searchEdit = nullptr;
+    QList<LadderElement*> m_searchResults;
+    int m_searchIndex = -1;
+    
+    // 交叉引用（可停靠面板）
+    QDockWidget* m_crossReferenceDock = nullptr;
+    CrossReferencePanel* m_crossReferencePanel = nullptr;
+    
+    // 仿真
+    ScanEngine* m_scanEngine = nullptr;
+    QTimer* m_simDisplayTimer = nullptr;
+    QSpinBox* m_scanPeriodSpin = nullptr;
+    QVector<QPair<LadderElement*, int>> m_simElementSlots;     // 元件 -> 通电位
+    QHash<LadderElement*, int> m_simOperandSlots;              // 元件 -> 操作数位
+    QVector<quint64> m_simBits;
+    
     // 按钮集合
     struct {
         QToolButton* newFile = nullptr;
@@ -185,6 +262,8 @@ private:
         QToolButton* zoomReset = nullptr;
         QToolButton* toggleGrid = nullptr;
         QToolButton* connectionMode = nullptr;
+        QToolButton* stPreview = nullptr;
+        QToolButton* crossReference = nullptr;
         QToolButton* runSim = nullptr;
         QToolButton* stopSim = nullptr;
     } m_buttons;
@@ -0,0 +1,170 @@
+#include "RungIndex.h"
+#include "../core/LadderElement.h"
+#include "../elements/ConnectionLine.h"
+
+namespace LadderDiagram {
+
+bool RungIndex::isRail(const LadderElement* element) {
+    const ElementType type = element->elementType();
+    return type == ElementType::LeftPowerRail || type == ElementType::RightPowerRail;
+}
+
+int RungIndex::createSet(int rung, QList<LadderElement*> members) {
+    const int key = m_nextKey++;
+    for (auto* element : members) {
+        m_setOf.insert(element, key);
+    }
+    m_sets.insert(key, Set{rung, std::move(members)});
+    m_keyOfRung.insert(rung, key);
+    m_dirty.insert(rung);
+    return key;
+}
+
+void RungIndex::addElement(LadderElement* element) {
+    if (isRail(element) || m_setOf.contains(element)) return;
+    createSet(m_nextRung++, {element});
+}
+
+void RungIndex::removeElement(LadderElement* element) {
+    auto it = m_setOf.find(element);
+    if (it == m_setOf.end()) return;
+    
+    const int key = it.value();
+    m_setOf.erase(it);
+    
+    Set& set = m_sets[key];
+    set.members.removeOne(element);
+    m_dirty.insert(set.rung);
+    if (set.members.isEmpty()) {
+        m_keyOfRung.remove(set.rung);
+        m_sets.remove(key);
+    }
+}
+
+void RungIndex::addConnection(ConnectionLine* connection) {
+    LadderElement* a = connection->startElement();
+    LadderElement* b = connection->endElement();
+    const int keyA = a ? m_setOf.value(a, 0) : 0;
+    const int keyB = b ? m_setOf.value(b, 0) : 0;
+    
+    // 连到电源轨或悬空：不改变划分，只是所在梯级的内容变了
+    if (keyA == 0 || keyB == 0 || keyA == keyB) {
+        if (keyA) m_dirty.insert(m_sets[keyA].rung);
+        if (keyB) m_dirty.insert(m_sets[keyB].rung);
+        return;
+    }
+    
+    // 小的分量并入大的分量，梯级编号取较早的一个
+    int big = keyA;
+    int small = keyB;
+    if (m_sets[big].members.size() < m_sets[small].members.size()) {
+        std::swap(big, small);
+    }
+    Set merged = m_sets.take(small);
+    Set& target = m_sets[big];
+    for (auto* element : merged.members) {
+        m_setOf.insert(element, big);
+    }
+    target.members += merged.members;
+    
+    m_keyOfRung.remove(merged.rung);
+    m_keyOfRung.remove(target.rung);
+    m_dirty.insert(merged.rung);
+    m_dirty.insert(target.rung);
+    target.rung = qMin(target.rung, merged.rung);
+    m_keyOfRung.insert(target.rung, big);
+}
+
+void RungIndex::removeConnection(ConnectionLine* connection) {
+    LadderElement* a = connection->startElement();
+    LadderElement* b = connection->endElement();
+    const int keyA = a ? m_setOf.value(a, 0) : 0;
+    const int keyB = b ? m_setOf.value(b, 0) : 0;
+    
+    if (keyA && keyA == keyB) {
+        // 两端可能因此断开，只在该分量内重新遍历
+        split(keyA);
+        return;
+    }
+    if (keyA) m_dirty.insert(m_sets[keyA].rung);
+    if (keyB) m_dirty.insert(m_sets[keyB].rung);
+}
+
+void RungIndex::split(int key) {
+    Set set = m_sets.take(key);
+    m_keyOfRung.remove(set.rung);
+    m_dirty.insert(set.rung);
+    
+    // 在分量内按邻接表做广度优先遍历
+    QSet<LadderElement*> remaining(set.members.cbegin(), set.members.cend());
+    QList<QList<LadderElement*>> parts;
+    for (auto* seed : set.members) {
+        if (!remaining.remove(seed)) continue;
+        
+        QList<LadderElement*> part{seed};
+        for (int i = 0; i < part.size(); ++i) {
+            for (auto* conn : m_adjacency.value(part[i])) {
+                LadderElement* other = conn->startElement() == part[i] ? conn->endElement() : conn->startElement();
+                if (other && remaining.remove(other)) {
+                    part.append(other);
+                }
+            }
+        }
+        parts.append(part);
+    }
+    
+    // 最大的一块沿用原编号
+    int largest = 0;
+    for (int i = 1; i < parts.size(); ++i) {
+        if (parts[i].size() > parts[largest].size()) largest = i;
+    }
+    for (int i = 0; i < parts.size(); ++i) {
+        createSet(i == largest ? set.rung : m_nextRung++, parts[i]);
+    }
+}
+
+void RungIndex::elementChanged(LadderElement* element) {
+    markDirty(element);
+}
+
+void RungIndex::markDirty(LadderElement* element) {
+    if (!isRail(element)) {
+        const int key = m_setOf.value(element, 0);
+        if (key) m_dirty.insert(m_sets[key].rung);
+        return;
+    }
+    
+    // 电源轨的记录出现在与其相连的每个梯级中
+    for (auto* conn : m_adjacency.value(element)) {
+        LadderElement* other = conn->startElement() == element ? conn->endElement() : conn->startElement();
+        const int key = other ? m_setOf.value(other, 0) : 0;
+        if (key) m_dirty.insert(m_sets[key].rung);
+    }
+}
+
+void RungIndex::clear() {
+    for (auto it = m_keyOfRung.cbegin(); it != m_keyOfRung.cend(); ++it) {
+        m_dirty.insert(it.key());
+    }
+    m_setOf.clear();
+    m_sets.clear();
+    m_keyOfRung.clear();
+}
+
+int RungIndex::rungOf(LadderElement* element) const {
+    const int key = m_setOf.value(element, 0);
+    return key ? m_sets.value(key).rung : 0;
+}
+
+QList<LadderElement*> RungIndex::members(int rung) const {
+    const int key = m_keyOfRung.value(rung, 0);
+    return key ? m_sets.value(key).members : QList<LadderElement*>();
+}
+
+QSet<int> RungIndex::takeDirty() {
+    QSet<int> dirty;
+    dirty.swap(m_dirty);
+    return dirty;
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+namespace LadderDiagram {
+
+class LadderElement;
+class ConnectionLine;
+
+// 梯级（网络）划分索引
+//
+// 以连接线为边、电源轨以外的元件为点维护连通分量。加线时按大小合并
+// （小的并入大的），删线或删元件时只在受影响的分量内部重新遍历拆分。
+// 每个梯级有稳定编号：合并后沿用较早的编号，拆分时最大的一块沿用原编号。
+// 电源轨不参与合并，否则所有梯级都会经由电源轨连成一个网络。
+class RungIndex {
+public:
+    using Adjacency = QHash<LadderElement*, QList<ConnectionLine*>>;
+
+    // adjacency 为场景维护的 元件 -> 连接线 邻接表
+    explicit RungIndex(const Adjacency& adjacency) : m_adjacency(adjacency) {}
+
+    void addElement(LadderElement* element);
+    void removeElement(LadderElement* element);             // 其连线须已先移除
+    void addConnection(ConnectionLine* connection);          // 须在登记到邻接表之后调用
+    void removeConnection(ConnectionLine* connection);       // 须在从邻接表移除之后调用
+    void elementChanged(LadderElement* element);             // 位置或内容变化，标记相关梯级
+    void clear();
+
+    // 元件所在梯级（电源轨不属于任何梯级，返回 0）
+    int rungOf(LadderElement* element) const;
+    QList<int> rungs() const { return m_keyOfRung.keys(); }
+    QList<LadderElement*> members(int rung) const;
+
+    // 取出自上次调用以来内容有变化的梯级（可能包含已消失的编号）
+    QSet<int> takeDirty();
+
+    static bool isRail(const LadderElement* element);
+
+private:
+    struct Set {
+        int rung = 0;
+        QList<LadderElement*> members;
+    };
+
+    void markDirty(LadderElement* element);
+    void split(int key);
+    int createSet(int rung, QList<LadderElement*> members);
+
+    const Adjacency& m_adjacency;
+    QHash<LadderElement*, int> m_setOf;     // 元件 -> 分量键
+    QHash<int, Set> m_sets;                 // 分量键 -> 分量
+    QHash<int, int> m_keyOfRung;            // 梯级编号 -> 分量键
+    QSet<int> m_dirty;
+    int m_nextKey = 1;
+    int m_nextRung = 1;
+};
+
+} // namespace LadderDiagram
@@ -0,0 +1,142 @@
+#include "UndoHistory.h"
+
+namespace LadderDiagram {
+
+qsizetype EditCommand::byteSize() const {
+    qsizetype bytes = qsizetype(sizeof(EditCommand)) + text().size() * qsizetype(sizeof(QChar));
+    for (int i = 0; i < childCount(); ++i) {
+        bytes += static_cast<const EditCommand*>(child(i))->byteSize();
+    }
+    return bytes;
+}
+
+UndoHistory::UndoHistory(QObject* parent)
+    : QObject(parent) {
+}
+
+UndoHistory::~UndoHistory() {
+    // 从新到旧删除：较新的命令可能引用较早命令所拥有的图元
+    qDeleteAll(m_commands.crbegin(), m_commands.crend());
+}
+
+void UndoHistory::push(EditCommand* command) {
+    const State before = state();
+    
+    command->redo();
+    removeRedoTail();
+    
+    EditCommand* top = canUndo() ? m_commands.last() : nullptr;
+    const bool merge = top && command->id() != -1 && top->id() == command->id()
+                       && m_index != m_cleanIndex && m_index != m_sealedIndex;
+    if (merge && top->mergeWith(command)) {
+        delete command;
+        m_bytes -= m_sizes.last();
+        if (top->isObsolete()) {
+            // 合并后相当于什么都没做
+            delete m_commands.takeLast();
+            m_sizes.removeLast();
+            --m_index;
+        } else {
+            m_sizes.last() = top->byteSize();
+            m_bytes += m_sizes.last();
+        }
+    } else if (command->isObsolete()) {
+        delete command;
+    } else {
+        m_commands.append(command);
+        m_sizes.append(command->byteSize());
+        m_bytes += m_sizes.last();
+        ++m_index;
+        trimToBudget();
+    }
+    
+    emitChanges(before);
+}
+
+void UndoHistory::removeRedoTail() {
+    while (canRedo()) {
+        m_bytes -= m_sizes.takeLast();
+        delete m_commands.takeLast();
+    }
+    if (m_cleanIndex > m_index) {
+        m_cleanIndex = -1;
+    }
+}
+
+void UndoHistory::trimToBudget() {
+    if (m_budget <= 0) return;
+    
+    // 只丢弃已执行的命令，最近一条和可重做的部分保留
+    while (m_bytes > m_budget && m_index - m_first > 1) {
+        m_bytes -= m_sizes.takeFirst();
+        delete m_commands.takeFirst();
+        if (m_cleanIndex == m_first) {
+            m_cleanIndex = -1;
+        }
+        ++m_first;
+    }
+}
+
+void UndoHistory::undo() {
+    if (!canUndo()) return;
+    
+    const State before = state();
+    --m_index;
+    m_commands[m_index - m_first]->undo();
+    m_sealedIndex = m_index;
+    emitChanges(before);
+}
+
+void UndoHistory::redo() {
+    if (!canRedo()) return;
+    
+    const State before = state();
+    m_commands[m_index - m_first]->redo();
+    ++m_index;
+    m_sealedIndex = m_index;
+    emitChanges(before);
+}
+
+QString UndoHistory::undoText() const {
+    return canUndo() ? m_commands[m_index - m_first - 1]->text() : QString();
+}
+
+QString UndoHistory::redoText() const {
+    return canRedo() ? m_commands[m_index - m_first]->text() : QString();
+}
+
+void UndoHistory::setClean() {
+    const State before = state();
+    m_cleanIndex = m_index;
+    emitChanges(before);
+}
+
+void UndoHistory::clear() {
+    const State before = state();
+    qDeleteAll(m_commands.crbegin(), m_commands.crend());
+    m_commands.clear();
+    m_sizes.clear();
+    m_first = 0;
+    m_index = 0;
+    m_cleanIndex = 0;
+    m_sealedIndex = -1;
+    m_bytes = 0;
+    emitChanges(before);
+}
+
+void UndoHistory::setByteBudget(qsizetype bytes) {
+    const State before = state();
+    m_budget = bytes;
+    trimToBudget();
+    emitChanges(before);
+}
+
+void UndoHistory::emitChanges(const State& before) {
+    const State after = state();
+    if (after.index != before.index) emit indexChanged(after.index);
+    if (after.canUndo != before.canUndo) emit canUndoChanged(after.canUndo);
+    if (after.canRedo != before.canRedo) emit canRedoChanged(after.canRedo);
+    if (after.clean != before.clean) emit cleanChanged(after.clean);
+}
+
+} // namespace LadderDiagram
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QUndoCommand>
+
+namespace LadderDiagram {
+
+// 可撤销的编辑命令：能估算自身占用的内存，供撤销历史按字节预算裁剪。
+// 批量操作用带子命令的 EditCommand 表示（子命令以它为父对象构造）
+class EditCommand : public QUndoCommand {
+public:
+    explicit EditCommand(QUndoCommand* parent = nullptr) : QUndoCommand(parent) {}
+    explicit EditCommand(const QString& text, QUndoCommand* parent = nullptr) : QUndoCommand(text, parent) {}
+
+    // 估算的字节数（含子命令）
+    virtual qsizetype byteSize() const;
+};
+
+// 撤销历史
+//
+// 接口与 QUndoStack 一致（push/undo/redo/index/clean 及同名信号），另加字节预算：
+// 压入命令后总量超出预算时从最早的命令开始丢弃，最新的命令总是保留。
+// index() 是绝对位置，丢弃早期命令不会使其倒退，因此可以像 QUndoStack
+// 一样用它标记保存时的位置。可合并的命令（id() != -1）与栈顶同类命令合并，
+// 合并后变为无效（obsolete）的命令直接移除；栈顶为干净状态、合并区间已由
+// closeMergeChain() 结束或刚撤销/重做过时不合并
+class UndoHistory : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr qsizetype DefaultByteBudget = 32 * 1024 * 1024;
+
+    explicit UndoHistory(QObject* parent = nullptr);
+    ~UndoHistory() override;
+
+    // 执行命令并记入历史（取得所有权）
+    void push(EditCommand* command);
+
+    bool canUndo() const { return m_index > m_first; }
+    bool canRedo() const { return m_index < m_first + m_commands.size(); }
+    int index() const { return m_index; }
+    int count() const { return m_first + m_commands.size(); }
+    QString undoText() const;
+    QString redoText() const;
+
+    bool isClean() const { return m_cleanIndex == m_index; }
+    void setClean();
+
+    // 结束当前的合并区间（一次拖动或一次输入结束时调用）：之后压入的命令
+    // 不再与现在的栈顶合并
+    void closeMergeChain() { m_sealedIndex = m_index; }
+
+    void clear();
+
+    // 字节预算（<= 0 表示不限制）
+    void setByteBudget(qsizetype bytes);
+    qsizetype byteBudget() const { return m_budget; }
+    qsizetype byteSize() const { return m_bytes; }
+
+public slots:
+    void undo();
+    void redo();
+
+signals:
+    void indexChanged(int index);
+    void canUndoChanged(bool canUndo);
+    void canRedoChanged(bool canRedo);
+    void cleanChanged(bool clean);
+
+private:
+    struct State {
+        int index;
+        bool canUndo;
+        bool canRedo;
+        bool clean;
+    };
+    State state() const { return State{m_index, canUndo(), canRedo(), isClean()}; }
+    void emitChanges(const State& before);
+
+    void removeRedoTail();
+    void trimToBudget();
+
+    QList<EditCommand*> m_commands;
+    QList<qsizetype> m_sizes;           // 各命令入栈（或合并）时的估算字节数
+    int m_first = 0;                    // 已丢弃的命令数，即 m_commands[0] 的绝对位置
+    int m_index = 0;
+    int m_cleanIndex = 0;               // -1 表示干净状态已无法回到
+    int m_sealedIndex = -1;             // 该位置的栈顶命令不再接受合并
+    qsizetype m_bytes = 0;
+    qsizetype m_budget = DefaultByteBudget;
+};
+
+} // namespace LadderDiagram
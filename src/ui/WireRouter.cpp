@@ -0,0 +1,172 @@
+#include "WireRouter.h"
+#include <QtMath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace LadderDiagram {
+
+namespace {
+
+// 搜索方向：+x, -x, +y, -y
+constexpr int DirX[4] = {1, -1, 0, 0};
+constexpr int DirY[4] = {0, 0, 1, -1};
+
+int directionIndex(const QPoint& dir) {
+    if (dir.x() > 0) return 0;
+    if (dir.x() < 0) return 1;
+    if (dir.y() > 0) return 2;
+    return 3;
+}
+
+// 去掉重复点和共线的中间点
+QPolygonF simplify(const QPolygonF& points) {
+    QPolygonF result;
+    for (const QPointF& point : points) {
+        if (!result.isEmpty() && result.last() == point) continue;
+        if (result.size() >= 2) {
+            const QPointF& a = result[result.size() - 2];
+            const QPointF& b = result.last();
+            if ((a.x() == b.x() && b.x() == point.x()) || (a.y() == b.y() && b.y() == point.y())) {
+                result.last() = point;
+                continue;
+            }
+        }
+        result.append(point);
+    }
+    return result;
+}
+
+} // namespace
+
+QPoint WireRouter::exitNode(const Endpoint& endpoint, qreal grid) {
+    // 沿引出方向取第一个不在元件内部的格点
+    const qreal gx = endpoint.position.x() / grid;
+    const qreal gy = endpoint.position.y() / grid;
+    int x = qRound(gx);
+    int y = qRound(gy);
+    if (endpoint.exit.x() > 0) x = qCeil(gx);
+    else if (endpoint.exit.x() < 0) x = qFloor(gx);
+    else if (endpoint.exit.y() > 0) y = qCeil(gy);
+    else if (endpoint.exit.y() < 0) y = qFloor(gy);
+    return QPoint(x, y);
+}
+
+QRectF WireRouter::corridor(const Endpoint& from, const Endpoint& to, qreal grid) {
+    const QPoint a = exitNode(from, grid);
+    const QPoint b = exitNode(to, grid);
+    const QRectF nodes(QPointF(qMin(a.x(), b.x()) - CorridorMargin, qMin(a.y(), b.y()) - CorridorMargin),
+                       QPointF(qMax(a.x(), b.x()) + CorridorMargin, qMax(a.y(), b.y()) + CorridorMargin));
+    const QRectF rect(nodes.topLeft() * grid, nodes.bottomRight() * grid);
+    return rect.united(QRectF(from.position, to.position).normalized());
+}
+
+QPolygonF WireRouter::route(const Endpoint& from, const Endpoint& to, qreal grid,
+                            const QVector<QRectF>& obstacles) {
+    if (grid <= 0) return QPolygonF();
+
+    const QPoint startNode = exitNode(from, grid);
+    const QPoint endNode = exitNode(to, grid);
+
+    // 走廊窗口（格点坐标）
+    const int left = qMin(startNode.x(), endNode.x()) - CorridorMargin;
+    const int top = qMin(startNode.y(), endNode.y()) - CorridorMargin;
+    const int width = qAbs(startNode.x() - endNode.x()) + 2 * CorridorMargin + 1;
+    const int height = qAbs(startNode.y() - endNode.y()) + 2 * CorridorMargin + 1;
+    if (qint64(width) * height > MaxCorridorCells) return QPolygonF();
+
+    auto cellIndex = [&](int x, int y) { return (y - top) * width + (x - left); };
+
+    // 障碍格点
+    std::vector<uchar> blocked(size_t(width) * height, 0);
+    for (const QRectF& rect : obstacles) {
+        const int x0 = qMax(left, qFloor(rect.left() / grid) + 1);
+        const int x1 = qMin(left + width - 1, qCeil(rect.right() / grid) - 1);
+        const int y0 = qMax(top, qFloor(rect.top() / grid) + 1);
+        const int y1 = qMin(top + height - 1, qCeil(rect.bottom() / grid) - 1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                blocked[cellIndex(x, y)] = 1;
+            }
+        }
+    }
+    blocked[cellIndex(startNode.x(), startNode.y())] = 0;
+    blocked[cellIndex(endNode.x(), endNode.y())] = 0;
+
+    // A*：状态 = 格点 x 到达方向
+    const int stateCount = width * height * 4;
+    std::vector<int> cost(stateCount, std::numeric_limits<int>::max());
+    std::vector<int> parent(stateCount, -1);
+
+    using Entry = std::pair<int, int>;      // (f, state)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    auto heuristic = [&](int x, int y) { return qAbs(x - endNode.x()) + qAbs(y - endNode.y()); };
+
+    const int startState = cellIndex(startNode.x(), startNode.y()) * 4 + directionIndex(from.exit);
+    cost[startState] = 0;
+    open.push({heuristic(startNode.x(), startNode.y()), startState});
+
+    const int goalCell = cellIndex(endNode.x(), endNode.y());
+    int goalState = -1;
+
+    while (!open.empty()) {
+        const auto [f, state] = open.top();
+        open.pop();
+
+        const int cell = state / 4;
+        const int dir = state % 4;
+        const int x = left + cell % width;
+        const int y = top + cell / width;
+        if (f - heuristic(x, y) > cost[state]) continue;    // 过期条目
+        if (cell == goalCell) {
+            goalState = state;
+            break;
+        }
+
+        for (int next = 0; next < 4; ++next) {
+            // 不走回头路
+            if ((next ^ 1) == dir) continue;
+            const int nx = x + DirX[next];
+            const int ny = y + DirY[next];
+            if (nx < left || nx >= left + width || ny < top || ny >= top + height) continue;
+            const int nextCell = cellIndex(nx, ny);
+            if (blocked[nextCell]) continue;
+
+            const int nextState = nextCell * 4 + next;
+            const int nextCost = cost[state] + 1 + (next != dir ? BendCost : 0);
+            if (nextCost < cost[nextState]) {
+                cost[nextState] = nextCost;
+                parent[nextState] = state;
+                open.push({nextCost + heuristic(nx, ny), nextState});
+            }
+        }
+    }
+
+    if (goalState < 0) return QPolygonF();
+
+    // 回溯格点路径
+    QVector<QPointF> nodes;
+    for (int state = goalState; state >= 0; state = parent[state]) {
+        const int cell = state / 4;
+        nodes.append(QPointF((left + cell % width) * grid, (top + cell / width) * grid));
+    }
+
+    QPolygonF points;
+    points.reserve(nodes.size() + 4);
+    points.append(from.position);
+    // 端点到第一个格点：先沿引出方向走，再横向对齐
+    if (from.exit.x() != 0) points.append(QPointF(nodes.last().x(), from.position.y()));
+    else points.append(QPointF(from.position.x(), nodes.last().y()));
+    for (int i = nodes.size() - 1; i >= 0; --i) {
+        points.append(nodes[i]);
+    }
+    if (to.exit.x() != 0) points.append(QPointF(nodes.first().x(), to.position.y()));
+    else points.append(QPointF(to.position.x(), nodes.first().y()));
+    points.append(to.position);
+
+    return simplify(points);
+}
+
+} // namespace LadderDiagram
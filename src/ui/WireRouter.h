@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QPoint>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+namespace LadderDiagram {
+
+// 正交连线布线器
+//
+// 在场景网格的格点上做 A* 搜索（每步一格，拐弯额外计代价），
+// 障碍为元件主体矩形：严格落在矩形内部的格点不可通过，
+// 所以位于元件边缘的连接点本身总是可达的。搜索范围限制在两端
+// 包围盒外扩 CorridorMargin 格的走廊内；走廊过大或无解时返回空，
+// 由调用方退回到简单的直角折线。
+class WireRouter {
+public:
+    // 连线端点：位置与离开元件的方向（单位向量，如 (1,0) 表示向右引出）
+    struct Endpoint {
+        QPointF position;
+        QPoint exit;
+    };
+
+    static constexpr int CorridorMargin = 6;        // 格
+    static constexpr int MaxCorridorCells = 60000;
+    static constexpr int BendCost = 2;              // 拐弯代价（以格为单位）
+
+    // 两端点之间的布线走廊（场景坐标）
+    static QRectF corridor(const Endpoint& from, const Endpoint& to, qreal grid);
+
+    // 布线，返回从 from 到 to 的折线顶点；无解时返回空
+    static QPolygonF route(const Endpoint& from, const Endpoint& to, qreal grid,
+                           const QVector<QRectF>& obstacles);
+
+private:
+    static QPoint exitNode(const Endpoint& endpoint, qreal grid);
+};
+
+} // namespace LadderDiagram
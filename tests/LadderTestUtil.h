@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include "core/ElementTypes.h"
+#include "core/LadderModel.h"
+#include "codegen/STCodeGenerator.h"
+
+namespace LadderDiagram {
+
+// 测试用梯形图构造器：生成元件与连接线的值类型记录
+class LadderBuilder {
+public:
+    // 添加元件，返回元件ID
+    QString add(ElementType type, const QString& name, qreal x, qreal y,
+                const QMap<QString, QVariant>& properties = {}) {
+        const QString id = QString("E%1").arg(++m_nextId);
+        ElementData element;
+        element.type = type;
+        element.id = id;
+        element.name = name;
+        element.position = QPointF(x, y);
+        element.properties = properties;
+        elements.append(element);
+        return id;
+    }
+
+    // 连接 from 的 fromPin 与 to 的 toPin
+    void wire(const QString& from, int fromPin, const QString& to, int toPin) {
+        ConnectionData connection;
+        connection.startElement = from;
+        connection.startPin = fromPin;
+        connection.endElement = to;
+        connection.endPin = toPin;
+        connections.append(connection);
+    }
+
+    // 左电源轨 -> 触点串联 -> 线圈 -> 右电源轨，占用两条电源轨的第 row 个引脚
+    void rung(const QString& left, const QString& right, int row,
+              const QStringList& contacts, const QString& coil) {
+        QString previous = left;
+        int previousPin = row;
+        for (const QString& contact : contacts) {
+            wire(previous, previousPin, contact, 0);
+            previous = contact;
+            previousPin = 1;
+        }
+        wire(previous, previousPin, coil, 0);
+        wire(coil, 1, right, row);
+    }
+
+    // 全部元件作为一个网络
+    LadderNetwork network(int id, int rungId = 0, quint64 revision = 0) const {
+        LadderNetwork result;
+        result.id = id;
+        result.rungId = rungId;
+        result.revision = revision;
+        result.elements = elements;
+        result.connections = connections;
+        return result;
+    }
+
+    QList<ElementData> elements;
+    QList<ConnectionData> connections;
+
+private:
+    int m_nextId = 0;
+};
+
+} // namespace LadderDiagram
@@ -0,0 +1,163 @@
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include "LadderTestUtil.h"
+#include "sim/BitSliceEvaluator.h"
+#include "sim/BitSliceKernels.h"
+#include "sim/SimProgram.h"
+
+using namespace LadderDiagram;
+
+class TestBitSlice : public QObject {
+    Q_OBJECT
+
+private slots:
+    void kernelsMatchScalar_data();
+    void kernelsMatchScalar();
+    void sweepMatchesScan();
+    void rejectsNonBooleanElements();
+};
+
+namespace {
+
+// 10 个输入：串并联触点、常闭触点、NOT/AND 逻辑门
+LadderBuilder booleanLadder() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+
+    // Y0 := X0 AND X1 OR NOT X2
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 120, 0);
+    const QString x2 = ladder.add(ElementType::NormallyClosed, "X2", 60, 20);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0, x1}, y0);
+    ladder.wire(left, 1, x2, 0);
+    ladder.wire(x2, 1, y0, 0);
+
+    // Y1 := NOT X3
+    const QString x3 = ladder.add(ElementType::NormallyOpen, "X3", 60, 60);
+    const QString inverter = ladder.add(ElementType::LogicNOT, "NOT1", 160, 60);
+    const QString y1 = ladder.add(ElementType::OutputCoil, "Y1", 300, 60);
+    ladder.rung(left, right, 2, {x3, inverter}, y1);
+
+    // Y2 := X4 AND X5
+    const QString x4 = ladder.add(ElementType::NormallyOpen, "X4", 60, 100);
+    const QString x5 = ladder.add(ElementType::NormallyOpen, "X5", 60, 120);
+    const QString gate = ladder.add(ElementType::LogicAND, "AND1", 160, 100);
+    const QString y2 = ladder.add(ElementType::OutputCoil, "Y2", 300, 100);
+    ladder.wire(left, 3, x4, 0);
+    ladder.wire(left, 4, x5, 0);
+    ladder.wire(x4, 1, gate, 0);
+    ladder.wire(x5, 1, gate, 1);
+    ladder.wire(gate, 2, y2, 0);
+    ladder.wire(y2, 1, right, 3);
+
+    // Y3 := X6 AND X7 AND NOT X8 AND X9
+    const QString x6 = ladder.add(ElementType::NormallyOpen, "X6", 60, 160);
+    const QString x7 = ladder.add(ElementType::NormallyOpen, "X7", 100, 160);
+    const QString x8 = ladder.add(ElementType::NormallyClosed, "X8", 140, 160);
+    const QString x9 = ladder.add(ElementType::NormallyOpen, "X9", 180, 160);
+    const QString y3 = ladder.add(ElementType::OutputCoil, "Y3", 300, 160);
+    ladder.rung(left, right, 5, {x6, x7, x8, x9}, y3);
+
+    return ladder;
+}
+
+} // namespace
+
+void TestBitSlice::kernelsMatchScalar_data() {
+    QTest::addColumn<int>("op");
+    QTest::newRow("Zero") << int(BitKernels::Zero);
+    QTest::newRow("Ones") << int(BitKernels::Ones);
+    QTest::newRow("Copy") << int(BitKernels::Copy);
+    QTest::newRow("Not") << int(BitKernels::Not);
+    QTest::newRow("OrBits") << int(BitKernels::OrBits);
+    QTest::newRow("OrNotBits") << int(BitKernels::OrNotBits);
+    QTest::newRow("ClearBits") << int(BitKernels::ClearBits);
+    QTest::newRow("OrAnd") << int(BitKernels::OrAnd);
+    QTest::newRow("OrAndNot") << int(BitKernels::OrAndNot);
+}
+
+void TestBitSlice::kernelsMatchScalar() {
+    if (!BitKernels::cpuHasAvx2()) {
+        QSKIP("CPU 不支持 AVX2，只有可移植实现");
+    }
+    QFETCH(int, op);
+
+    constexpr int Words = 68;
+    QRandomGenerator random(20240611u + op);
+    QVector<quint64> a(Words), b(Words), dst(Words);
+    for (int i = 0; i < Words; ++i) {
+        a[i] = random.generate64();
+        b[i] = random.generate64();
+        dst[i] = random.generate64();
+    }
+
+    QVector<quint64> expected = dst;
+    QVector<quint64> actual = dst;
+    BitKernels::scalarKernel(BitKernels::Op(op), expected.data(), a.constData(), b.constData(), Words);
+    BitKernels::bestKernel()(BitKernels::Op(op), actual.data(), a.constData(), b.constData(), Words);
+    QCOMPARE(actual, expected);
+}
+
+void TestBitSlice::sweepMatchesScan() {
+    const LadderBuilder ladder = booleanLadder();
+
+    BitSliceEvaluator evaluator;
+    QVERIFY2(evaluator.compile(ladder.elements, ladder.connections), qPrintable(evaluator.errorString()));
+    QCOMPARE(evaluator.inputs().size(), 10);
+    QCOMPARE(evaluator.outputs().size(), 4);
+    // 1024 个向量分成多批，覆盖按字填充的高位输入
+    evaluator.setLaneCount(256);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+    QVector<int> inputSlots;
+    for (const QString& name : evaluator.inputs()) {
+        inputSlots.append(program.bitSlot(name));
+        QVERIFY(inputSlots.last() >= 0);
+    }
+    QVector<int> outputSlots;
+    for (const QString& name : evaluator.outputs()) {
+        outputSlots.append(program.bitSlot(name));
+        QVERIFY(outputSlots.last() >= 0);
+    }
+
+    qint64 checked = 0;
+    int mismatches = 0;
+    const bool swept = evaluator.sweep([&](qint64 firstVector, int count, const BitSliceEvaluator& batch) {
+        for (int lane = 0; lane < count; ++lane) {
+            const qint64 vector = firstVector + lane;
+            SimMemory memory = program.createMemory();
+            for (int i = 0; i < inputSlots.size(); ++i) {
+                memory.setBit(inputSlots[i], (vector >> i) & 1);
+            }
+            program.scan(memory, 1000);
+            for (int o = 0; o < outputSlots.size(); ++o) {
+                if (batch.output(o, lane) != memory.bit(outputSlots[o])) ++mismatches;
+            }
+        }
+        checked += count;
+    });
+
+    QVERIFY(swept);
+    QCOMPARE(checked, qint64(1) << 10);
+    QCOMPARE(mismatches, 0);
+}
+
+void TestBitSlice::rejectsNonBooleanElements() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString t1 = ladder.add(ElementType::Timer, "T1", 200, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0, t1}, y0);
+
+    BitSliceEvaluator evaluator;
+    QVERIFY(!evaluator.compile(ladder.elements, ladder.connections));
+    QVERIFY(!evaluator.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestBitSlice)
+#include "tst_bitslice.moc"
@@ -0,0 +1,161 @@
+#include <QtTest/QtTest>
+#include <functional>
+#include "core/ElementTypes.h"
+#include "core/LdBinFormat.h"
+
+using namespace LadderDiagram;
+
+class TestLdBin : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void everyTruncationFails();
+    void rejectsCorruption();
+};
+
+namespace {
+
+QMap<QString, QVariant> timerMap() {
+    QMap<QString, QVariant> properties;
+    properties["preset"] = 500;
+    properties["large"] = qlonglong(1) << 40;
+    properties["ratio"] = 2.5;
+    properties["retentive"] = true;
+    properties["unit"] = QString("毫秒");
+
+    QMap<QString, QVariant> map;
+    map["type"] = static_cast<int>(ElementType::Timer);
+    map["id"] = QString("E1");
+    map["name"] = QString("T1");
+    map["address"] = QString("T1");
+    map["comment"] = QString("延时启动");
+    map["x"] = 120.0;
+    map["y"] = 40.5;
+    map["properties"] = properties;
+    return map;
+}
+
+QMap<QString, QVariant> jumpMap() {
+    QMap<QString, QVariant> map;
+    map["type"] = static_cast<int>(ElementType::Jump);
+    map["id"] = QString("E2");
+    map["name"] = QString("JMP");
+    map["address"] = QString();
+    map["comment"] = QString();
+    map["x"] = 300.0;
+    map["y"] = 40.5;
+    map["target_label"] = QString("SKIP");
+    map["properties"] = QMap<QString, QVariant>();
+    return map;
+}
+
+QByteArray sampleFile() {
+    LdBinWriter writer;
+    const int timer = writer.addElement("E1", timerMap());
+    const int jump = writer.addElement("E2", jumpMap());
+    writer.addConnection(timer, 1, jump, 0, QPointF(160, 40), QPointF(300, 40));
+    writer.addConnection(jump, 0, LdBin::NoElement, -1, QPointF(300, 40), QPointF(320, 40));
+    return writer.finish();
+}
+
+template <typename Record>
+Record* recordAt(QByteArray& data, quint64 offset) {
+    return reinterpret_cast<Record*>(data.data() + offset);
+}
+
+} // namespace
+
+void TestLdBin::roundTrip() {
+    const QByteArray data = sampleFile();
+
+    LdBinReader reader;
+    QVERIFY2(reader.openData(reinterpret_cast<const uchar*>(data.constData()), data.size()),
+             qPrintable(reader.errorString()));
+    QCOMPARE(reader.elementCount(), 2u);
+    QCOMPARE(reader.connectionCount(), 2u);
+
+    QCOMPARE(reader.elementMap(0), timerMap());
+    QCOMPARE(reader.elementMap(1), jumpMap());
+    QCOMPARE(reader.elementMap(0).value("properties").toMap().value("large").typeId(),
+             int(QMetaType::LongLong));
+
+    const LdBin::ConnectionRecord& wire = reader.connection(0);
+    QCOMPARE(wire.startElement, 0u);
+    QCOMPARE(wire.endElement, 1u);
+    QCOMPARE(wire.startPin, 1);
+    QCOMPARE(wire.endPin, 0);
+    QCOMPARE(wire.endX, 300.0);
+    QCOMPARE(reader.connection(1).endElement, LdBin::NoElement);
+}
+
+void TestLdBin::everyTruncationFails() {
+    const QByteArray data = sampleFile();
+    for (qsizetype size = 0; size < data.size(); ++size) {
+        const QByteArray truncated = data.left(size);
+        LdBinReader reader;
+        QVERIFY2(!reader.openData(reinterpret_cast<const uchar*>(truncated.constData()), truncated.size()),
+                 qPrintable(QString("truncated to %1 bytes").arg(size)));
+        QVERIFY(!reader.errorString().isEmpty());
+    }
+}
+
+void TestLdBin::rejectsCorruption() {
+    const QByteArray original = sampleFile();
+    const auto* header = reinterpret_cast<const LdBin::FileHeader*>(original.constData());
+
+    auto expectFailure = [&original](const char* what, const std::function<void(QByteArray&)>& corrupt) {
+        QByteArray data = original;
+        corrupt(data);
+        LdBinReader reader;
+        QVERIFY2(!reader.openData(reinterpret_cast<const uchar*>(data.constData()), data.size()), what);
+        QVERIFY2(!reader.errorString().isEmpty(), what);
+    };
+
+    expectFailure("magic", [](QByteArray& data) { data[0] = 'X'; });
+    expectFailure("version", [](QByteArray& data) {
+        recordAt<LdBin::FileHeader>(data, 0)->version = LdBin::Version + 1;
+    });
+    expectFailure("header size", [](QByteArray& data) {
+        recordAt<LdBin::FileHeader>(data, 0)->headerSize = 32;
+    });
+    expectFailure("element count", [](QByteArray& data) {
+        recordAt<LdBin::FileHeader>(data, 0)->elementCount = 0x10000000u;
+    });
+    expectFailure("unaligned section", [](QByteArray& data) {
+        recordAt<LdBin::FileHeader>(data, 0)->propertiesOffset += 4;
+    });
+    expectFailure("strings past end", [](QByteArray& data) {
+        recordAt<LdBin::FileHeader>(data, 0)->stringsSize += 1;
+    });
+    expectFailure("element string", [header](QByteArray& data) {
+        auto* element = recordAt<LdBin::ElementRecord>(data, header->elementsOffset);
+        element->name.offset = static_cast<quint32>(header->stringsSize);
+        element->name.length = 1;
+    });
+    expectFailure("string length overflow", [header](QByteArray& data) {
+        auto* element = recordAt<LdBin::ElementRecord>(data, header->elementsOffset);
+        element->comment.offset = 1;
+        element->comment.length = 0xFFFFFFFFu;
+    });
+    expectFailure("property range", [header](QByteArray& data) {
+        auto* element = recordAt<LdBin::ElementRecord>(data, header->elementsOffset);
+        element->propertyCount = header->propertyCount + 1;
+    });
+    expectFailure("first property", [header](QByteArray& data) {
+        auto* element = recordAt<LdBin::ElementRecord>(data, header->elementsOffset);
+        element->firstProperty = header->propertyCount + 1;
+        element->propertyCount = 0;
+    });
+    expectFailure("property key", [header](QByteArray& data) {
+        auto* property = recordAt<LdBin::PropertyRecord>(data, header->propertiesOffset);
+        property->key.length = static_cast<quint32>(header->stringsSize) + 1;
+    });
+    expectFailure("connection element", [header](QByteArray& data) {
+        auto* connection = recordAt<LdBin::ConnectionRecord>(data, header->connectionsOffset);
+        connection->endElement = header->elementCount;
+    });
+}
+
+QTEST_GUILESS_MAIN(TestLdBin)
+#include "tst_ldbin.moc"
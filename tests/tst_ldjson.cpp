@@ -0,0 +1,245 @@
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include "core/ElementTypes.h"
+#include "core/LadderModel.h"
+#include "core/LdJsonStream.h"
+#include "core/SceneSnapshot.h"
+
+using namespace LadderDiagram;
+
+class TestLdJson : public QObject {
+    Q_OBJECT
+
+private slots:
+    void valuesKeepTheirTypes();
+    void recordsCrossReadChunks();
+    void modelRoundTrip();
+    void sortForSaveOrdersById();
+    void malformedInputFails_data();
+    void malformedInputFails();
+};
+
+namespace {
+
+// 收集读取到的全部记录
+class RecordCollector : public LdJsonHandler {
+public:
+    void element(const QMap<QString, QVariant>& record) override { elements.append(record); }
+    void connection(const QMap<QString, QVariant>& record) override { connections.append(record); }
+
+    QList<QMap<QString, QVariant>> elements;
+    QList<QMap<QString, QVariant>> connections;
+};
+
+QByteArray written(const SceneSnapshot& snapshot) {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!snapshot.writeJson(&buffer)) return QByteArray();
+    return buffer.data();
+}
+
+bool readBack(const QByteArray& json, RecordCollector& collector, QString* error = nullptr) {
+    QBuffer buffer;
+    buffer.setData(json);
+    buffer.open(QIODevice::ReadOnly);
+    LdJsonReader reader;
+    const bool ok = reader.read(&buffer, collector);
+    if (error) *error = reader.errorString();
+    return ok;
+}
+
+} // namespace
+
+void TestLdJson::valuesKeepTheirTypes() {
+    QMap<QString, QVariant> nested;
+    nested["depth"] = 2;
+    nested["items"] = QVariantList{1, QString("two"), false};
+
+    QMap<QString, QVariant> properties;
+    properties["preset"] = 500;
+    properties["negative"] = -7;
+    properties["large"] = qlonglong(1) << 40;
+    properties["ratio"] = 0.1;
+    properties["enabled"] = true;
+    properties["disabled"] = false;
+    properties["unset"] = QVariant();
+    properties["text"] = QString("引号\" 反斜杠\\ 换行\n 制表\t 控制\x01 表情😀");
+    properties["nested"] = nested;
+
+    QMap<QString, QVariant> element;
+    element["type"] = static_cast<int>(ElementType::Timer);
+    element["id"] = QString("E1");
+    element["name"] = QString("T1");
+    element["x"] = 12.5;
+    element["y"] = -40.25;
+    element["properties"] = properties;
+
+    QMap<QString, QVariant> connection;
+    connection["type"] = QString("connection_line");
+    connection["start_element"] = QString("E1");
+    connection["start_connection_index"] = 1;
+    connection["end_element"] = QString();
+    connection["end_connection_index"] = -1;
+
+    SceneSnapshot snapshot;
+    snapshot.elements.append(element);
+    snapshot.connections.append(connection);
+
+    RecordCollector collector;
+    QString error;
+    QVERIFY2(readBack(written(snapshot), collector, &error), qPrintable(error));
+    QCOMPARE(collector.elements.size(), 1);
+    QCOMPARE(collector.connections.size(), 1);
+    QCOMPARE(collector.elements.first(), element);
+    QCOMPARE(collector.connections.first(), connection);
+
+    const QMap<QString, QVariant> read = collector.elements.first().value("properties").toMap();
+    QCOMPARE(read.value("preset").typeId(), int(QMetaType::Int));
+    QCOMPARE(read.value("large").typeId(), int(QMetaType::LongLong));
+    QCOMPARE(read.value("ratio").typeId(), int(QMetaType::Double));
+    QCOMPARE(read.value("enabled").typeId(), int(QMetaType::Bool));
+    QVERIFY(!read.value("unset").isValid());
+}
+
+void TestLdJson::recordsCrossReadChunks() {
+    // 远超一个读取块（64KB），记录与字符串会跨块边界
+    SceneSnapshot snapshot;
+    for (int i = 0; i < 3000; ++i) {
+        QMap<QString, QVariant> element;
+        element["type"] = static_cast<int>(ElementType::NormallyOpen);
+        element["id"] = QString("E%1").arg(i + 1);
+        element["name"] = QString("X%1").arg(i);
+        element["comment"] = QString("第%1个触点 \"%2\"").arg(i).arg(QString(i % 37, QChar('x')));
+        element["x"] = i + 0.5;
+        element["y"] = 20 * i;
+        element["properties"] = QMap<QString, QVariant>{{"index", i}};
+        snapshot.elements.append(element);
+    }
+
+    const QByteArray json = written(snapshot);
+    QVERIFY(json.size() > 3 * 64 * 1024);
+
+    RecordCollector collector;
+    QString error;
+    QVERIFY2(readBack(json, collector, &error), qPrintable(error));
+    QCOMPARE(collector.elements.size(), snapshot.elements.size());
+    for (int i = 0; i < snapshot.elements.size(); ++i) {
+        QCOMPARE(collector.elements[i], snapshot.elements[i]);
+    }
+    QVERIFY(collector.connections.isEmpty());
+}
+
+void TestLdJson::modelRoundTrip() {
+    LadderModel model;
+    ElementData contact;
+    contact.type = ElementType::NormallyClosed;
+    contact.id = "E1";
+    contact.name = "STOP";
+    contact.address = "X1";
+    contact.comment = "急停";
+    contact.position = QPointF(60, 20);
+    contact.properties["note"] = QString("常闭");
+    model.elements.append(contact);
+
+    ElementData coil;
+    coil.type = ElementType::OutputCoil;
+    coil.id = "E2";
+    coil.name = "Y0";
+    coil.position = QPointF(300, 20);
+    model.elements.append(coil);
+
+    ConnectionData wire;
+    wire.startElement = "E1";
+    wire.startPin = 1;
+    wire.endElement = "E2";
+    wire.endPin = 0;
+    wire.startPoint = QPointF(80, 20);
+    wire.endPoint = QPointF(300, 20);
+    model.connections.append(wire);
+
+    QBuffer buffer;
+    buffer.setData(written(model.toSnapshot()));
+    buffer.open(QIODevice::ReadOnly);
+
+    LadderModel loaded;
+    QString error;
+    QVERIFY2(loaded.readJson(&buffer, &error), qPrintable(error));
+    QCOMPARE(loaded.elements.size(), 2);
+    QCOMPARE(loaded.connections.size(), 1);
+
+    const ElementData& first = loaded.elements.first();
+    QCOMPARE(first.type, ElementType::NormallyClosed);
+    QCOMPARE(first.id, QString("E1"));
+    QCOMPARE(first.name, QString("STOP"));
+    QCOMPARE(first.address, QString("X1"));
+    QCOMPARE(first.comment, QString("急停"));
+    QCOMPARE(first.position, QPointF(60, 20));
+    QCOMPARE(first.properties, contact.properties);
+
+    const ConnectionData& line = loaded.connections.first();
+    QCOMPARE(line.startElement, QString("E1"));
+    QCOMPARE(line.startPin, 1);
+    QCOMPARE(line.endElement, QString("E2"));
+    QCOMPARE(line.endPin, 0);
+    QCOMPARE(line.endPoint, QPointF(300, 20));
+}
+
+void TestLdJson::sortForSaveOrdersById() {
+    // 注册表顺序被删除打乱后，保存顺序仍只取决于ID
+    LadderModel model;
+    for (const QString& id : {"E10", "R1", "E2", "E1"}) {
+        ElementData element;
+        element.id = id;
+        model.elements.append(element);
+    }
+    auto wire = [&model](const QString& from, int fromPin, const QString& to) {
+        ConnectionData connection;
+        connection.startElement = from;
+        connection.startPin = fromPin;
+        connection.endElement = to;
+        connection.endPin = 0;
+        model.connections.append(connection);
+    };
+    wire("E10", 1, "E2");
+    wire("E2", 1, "E10");
+    wire("E1", 2, "E2");
+    wire("E1", 1, "E10");
+
+    model.sortForSave();
+
+    QStringList ids;
+    for (const ElementData& element : model.elements) ids.append(element.id);
+    QCOMPARE(ids, QStringList({"E1", "E2", "E10", "R1"}));
+
+    QStringList wires;
+    for (const ConnectionData& connection : model.connections) {
+        wires.append(QString("%1.%2-%3").arg(connection.startElement).arg(connection.startPin)
+                         .arg(connection.endElement));
+    }
+    QCOMPARE(wires, QStringList({"E1.1-E10", "E1.2-E2", "E2.1-E10", "E10.1-E2"}));
+}
+
+void TestLdJson::malformedInputFails_data() {
+    QTest::addColumn<QByteArray>("json");
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("not an object") << QByteArray("[]");
+    QTest::newRow("unterminated array") << QByteArray("{\"elements\": [{\"id\": \"E1\"}");
+    QTest::newRow("unterminated string") << QByteArray("{\"elements\": [{\"id\": \"E1}]}");
+    QTest::newRow("missing comma") << QByteArray("{\"elements\": [{\"id\": \"E1\"} {\"id\": \"E2\"}]}");
+    QTest::newRow("control character") << QByteArray("{\"elements\": [{\"id\": \"E\n1\"}]}");
+    QTest::newRow("bad escape") << QByteArray("{\"elements\": [{\"id\": \"\\u12G4\"}]}");
+    QTest::newRow("bad literal") << QByteArray("{\"elements\": [{\"on\": tru}]}");
+    QTest::newRow("bad number") << QByteArray("{\"elements\": [{\"x\": 1.2.3}]}");
+    QTest::newRow("too deep") << "{\"elements\": [{\"p\": " + QByteArray(100, '[') + QByteArray(100, ']') + "}]}";
+}
+
+void TestLdJson::malformedInputFails() {
+    QFETCH(QByteArray, json);
+    RecordCollector collector;
+    QString error;
+    QVERIFY(!readBack(json, collector, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestLdJson)
+#include "tst_ldjson.moc"
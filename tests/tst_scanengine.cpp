@@ -0,0 +1,230 @@
+#include <QtTest/QtTest>
+#include "LadderTestUtil.h"
+#include "sim/SimProgram.h"
+#include "sim/ScanEngine.h"
+
+using namespace LadderDiagram;
+
+class TestScanEngine : public QObject {
+    Q_OBJECT
+
+private slots:
+    void seriesAndNormallyClosed();
+    void setResetCoilsLatch();
+    void onDelayTimer();
+    void risingEdgeContact();
+    void backwardJumpExceedsBudget();
+    void engineAppliesWrites();
+    void engineReportsFault();
+};
+
+namespace {
+
+// X0 AND NOT X1 -> Y0
+SimProgram seriesProgram() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyClosed, "X1", 120, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0, x1}, y0);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+    return program;
+}
+
+} // namespace
+
+void TestScanEngine::seriesAndNormallyClosed() {
+    const SimProgram program = seriesProgram();
+    const int x0 = program.bitSlot("X0");
+    const int x1 = program.bitSlot("X1");
+    const int y0 = program.bitSlot("Y0");
+    QVERIFY(x0 >= 0 && x1 >= 0 && y0 >= 0);
+
+    SimMemory memory = program.createMemory();
+    const bool table[4][3] = {
+        {false, false, false},
+        {true, false, true},
+        {true, true, false},
+        {false, true, false},
+    };
+    for (const auto& row : table) {
+        memory.setBit(x0, row[0]);
+        memory.setBit(x1, row[1]);
+        QVERIFY(program.scan(memory, 1000));
+        QCOMPARE(memory.bit(y0), row[2]);
+    }
+}
+
+void TestScanEngine::setResetCoilsLatch() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString start = ladder.add(ElementType::NormallyOpen, "START", 60, 0);
+    const QString set = ladder.add(ElementType::SetCoil, "MOTOR", 300, 0);
+    const QString stop = ladder.add(ElementType::NormallyOpen, "STOP", 60, 40);
+    const QString reset = ladder.add(ElementType::ResetCoil, "MOTOR", 300, 40);
+    ladder.rung(left, right, 0, {start}, set);
+    ladder.rung(left, right, 1, {stop}, reset);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+    const int startBit = program.bitSlot("START");
+    const int stopBit = program.bitSlot("STOP");
+    const int motor = program.bitSlot("MOTOR");
+    SimMemory memory = program.createMemory();
+
+    memory.setBit(startBit, true);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(memory.bit(motor));
+
+    // 松开启动按钮后保持
+    memory.setBit(startBit, false);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(memory.bit(motor));
+
+    memory.setBit(stopBit, true);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(!memory.bit(motor));
+
+    memory.setBit(stopBit, false);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(!memory.bit(motor));
+}
+
+void TestScanEngine::onDelayTimer() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString t1 = ladder.add(ElementType::Timer, "T1", 200, 0, {{"preset", 500}});
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0, t1}, y0);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+    const int input = program.bitSlot("X0");
+    const int output = program.bitSlot("Y0");
+    SimMemory memory = program.createMemory();
+
+    // 输入上升的那次扫描不计时
+    memory.setBit(input, true);
+    QVERIFY(program.scan(memory, 300000));
+    QVERIFY(!memory.bit(output));
+    QVERIFY(program.scan(memory, 400000));
+    QVERIFY(!memory.bit(output));
+    QVERIFY(program.scan(memory, 100000));
+    QVERIFY(memory.bit(output));
+
+    // 输入断开立即复位，重新计时
+    memory.setBit(input, false);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(!memory.bit(output));
+    memory.setBit(input, true);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(program.scan(memory, 499000));
+    QVERIFY(!memory.bit(output));
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(memory.bit(output));
+}
+
+void TestScanEngine::risingEdgeContact() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::PositiveEdge, "X0", 60, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0}, y0);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+    const int input = program.bitSlot("X0");
+    const int output = program.bitSlot("Y0");
+    SimMemory memory = program.createMemory();
+
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(!memory.bit(output));
+    memory.setBit(input, true);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(memory.bit(output));
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(!memory.bit(output));
+    memory.setBit(input, false);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(!memory.bit(output));
+    memory.setBit(input, true);
+    QVERIFY(program.scan(memory, 1000));
+    QVERIFY(memory.bit(output));
+}
+
+void TestScanEngine::backwardJumpExceedsBudget() {
+    LadderBuilder ladder;
+    ladder.add(ElementType::Label, "AGAIN", 0, 0);
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 40);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 40);
+    const QString jmp = ladder.add(ElementType::Jump, "JMP", 120, 40, {{"target_label", "AGAIN"}});
+    ladder.wire(left, 0, x0, 0);
+    ladder.wire(x0, 1, jmp, 0);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+    SimMemory memory = program.createMemory();
+
+    QVERIFY(program.scan(memory, 1000));
+    memory.setBit(program.bitSlot("X0"), true);
+    QVERIFY(!program.scan(memory, 1000));
+}
+
+void TestScanEngine::engineAppliesWrites() {
+    const SimProgram program = seriesProgram();
+    const int x0 = program.bitSlot("X0");
+    const int y0 = program.bitSlot("Y0");
+
+    ScanEngine engine;
+    engine.setScanPeriod(ScanEngine::MinScanPeriod);
+    engine.start(program);
+    QVERIFY(engine.isRunning());
+
+    QVector<quint64> bits;
+    auto outputOn = [&] {
+        engine.takeSnapshot(bits);
+        return !bits.isEmpty() && ((bits[y0 >> 6] >> (y0 & 63)) & 1u);
+    };
+
+    engine.writeBit(x0, true);
+    QTRY_VERIFY(outputOn());
+    engine.toggleBit(x0);
+    QTRY_VERIFY(!outputOn());
+    QVERIFY(engine.scanCount() > 0);
+
+    engine.stop();
+    QVERIFY(!engine.isRunning());
+}
+
+void TestScanEngine::engineReportsFault() {
+    LadderBuilder ladder;
+    ladder.add(ElementType::Label, "AGAIN", 0, 0);
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 40);
+    const QString jmp = ladder.add(ElementType::Jump, "JMP", 120, 40, {{"target_label", "AGAIN"}});
+    ladder.wire(left, 0, jmp, 0);
+
+    SimProgram program;
+    program.compile(ladder.elements, ladder.connections);
+
+    // 信号在扫描线程上发出，排队到测试线程再读取
+    ScanEngine engine;
+    QString message;
+    connect(&engine, &ScanEngine::faulted, &engine,
+            [&message](const QString& text) { message = text; }, Qt::QueuedConnection);
+    engine.start(program);
+
+    QTRY_VERIFY(!message.isEmpty());
+    QCOMPARE(engine.scanCount(), quint64(0));
+    engine.stop();
+}
+
+QTEST_GUILESS_MAIN(TestScanEngine)
+#include "tst_scanengine.moc"
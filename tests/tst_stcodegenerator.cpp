@@ -0,0 +1,311 @@
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include "LadderTestUtil.h"
+#include "codegen/STCodeGenerator.h"
+
+using namespace LadderDiagram;
+
+class TestSTCodeGenerator : public QObject {
+    Q_OBJECT
+
+private slots:
+    void seriesContacts();
+    void parallelContacts();
+    void seriesOfParallel();
+    void sharedNodeUsesTemporary();
+    void cachedNetworkTakesNewNumber();
+    void newRevisionRecompiles();
+    void timerResetKeepsPrecedence();
+    void forwardJumpSkipsNetworks();
+    void backwardJumpIsReported();
+    void threadLimitKeepsOutput();
+    void loadErrorIsReported();
+};
+
+void TestSTCodeGenerator::seriesContacts() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 120, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0, x1}, y0);
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1));
+    QVERIFY(generator.generateSTCode().contains("Y0 := X0 AND X1;"));
+}
+
+void TestSTCodeGenerator::parallelContacts() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 60, 20);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.wire(left, 0, x0, 0);
+    ladder.wire(left, 1, x1, 0);
+    ladder.wire(x0, 1, y0, 0);
+    ladder.wire(x1, 1, y0, 0);
+    ladder.wire(y0, 1, right, 0);
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1));
+    QVERIFY(generator.generateSTCode().contains("Y0 := X0 OR X1;"));
+}
+
+void TestSTCodeGenerator::seriesOfParallel() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 60, 20);
+    const QString x2 = ladder.add(ElementType::NormallyClosed, "X2", 120, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.wire(left, 0, x0, 0);
+    ladder.wire(left, 1, x1, 0);
+    ladder.wire(x0, 1, x2, 0);
+    ladder.wire(x1, 1, x2, 0);
+    ladder.wire(x2, 1, y0, 0);
+    ladder.wire(y0, 1, right, 0);
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1));
+    QVERIFY(generator.generateSTCode().contains("Y0 := (X0 OR X1) AND NOT X2;"));
+}
+
+void TestSTCodeGenerator::sharedNodeUsesTemporary() {
+    // 两个线圈读取同一个复合表达式：先存入临时变量，只展开一次
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 120, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    const QString y1 = ladder.add(ElementType::OutputCoil, "Y1", 300, 20);
+    ladder.rung(left, right, 0, {x0, x1}, y0);
+    ladder.wire(x1, 1, y1, 0);
+    ladder.wire(y1, 1, right, 1);
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1));
+    const QString code = generator.generatePOU();
+
+    const qsizetype temp = code.indexOf("_N1_T1 := X0 AND X1;");
+    QVERIFY(temp >= 0);
+    QVERIFY(code.indexOf("Y0 := _N1_T1;") > temp);
+    QVERIFY(code.indexOf("Y1 := _N1_T1;") > temp);
+    QVERIFY(code.contains("_N1_T1 : BOOL;"));
+    QCOMPARE(code.count("X0 AND X1"), 1);
+}
+
+void TestSTCodeGenerator::cachedNetworkTakesNewNumber() {
+    // 网络编号随位置变化时直接复用缓存结果，临时变量名按新编号生成
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 120, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    const QString y1 = ladder.add(ElementType::OutputCoil, "Y1", 300, 20);
+    ladder.rung(left, right, 0, {x0, x1}, y0);
+    ladder.wire(x1, 1, y1, 0);
+    ladder.wire(y1, 1, right, 1);
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1, 7));
+    QVERIFY(generator.generateSTCode().contains("_N1_T1 := X0 AND X1;"));
+    QCOMPARE(generator.lastRecompiledCount(), 1);
+
+    generator.clearNetworks();
+    generator.addNetwork(ladder.network(2, 7));
+    const QString code = generator.generateSTCode();
+    QCOMPARE(generator.lastRecompiledCount(), 0);
+    QVERIFY(code.contains("(* Network 2 *)"));
+    QVERIFY(code.contains("_N2_T1 := X0 AND X1;"));
+    QVERIFY(!code.contains("_N1_"));
+}
+
+void TestSTCodeGenerator::newRevisionRecompiles() {
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.rung(left, right, 0, {x0}, y0);
+
+    LadderBuilder edited = ladder;
+    edited.elements[2].name = "X9";
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1, 3, 1));
+    QVERIFY(generator.generateSTCode().contains("Y0 := X0;"));
+
+    // 版本不变时不看内容，直接复用
+    generator.clearNetworks();
+    generator.addNetwork(edited.network(1, 3, 1));
+    QVERIFY(generator.generateSTCode().contains("Y0 := X0;"));
+    QCOMPARE(generator.lastRecompiledCount(), 0);
+
+    generator.clearNetworks();
+    generator.addNetwork(edited.network(1, 3, 2));
+    QVERIFY(generator.generateSTCode().contains("Y0 := X9;"));
+    QCOMPARE(generator.lastRecompiledCount(), 1);
+
+    // 没有梯级编号的网络不进入缓存
+    generator.clearNetworks();
+    generator.addNetwork(edited.network(1));
+    generator.generateSTCode();
+    generator.generateSTCode();
+    QCOMPARE(generator.lastRecompiledCount(), 1);
+}
+
+void TestSTCodeGenerator::timerResetKeepsPrecedence() {
+    // IN := (X0 OR X1) AND NOT (X2 AND X3)
+    LadderBuilder ladder;
+    const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+    const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+    const QString x0 = ladder.add(ElementType::NormallyOpen, "X0", 60, 0);
+    const QString x1 = ladder.add(ElementType::NormallyOpen, "X1", 60, 20);
+    const QString x2 = ladder.add(ElementType::NormallyOpen, "X2", 60, 40);
+    const QString x3 = ladder.add(ElementType::NormallyOpen, "X3", 120, 40);
+    const QString t1 = ladder.add(ElementType::Timer, "T1", 200, 0, {{"preset", 500}});
+    const QString y0 = ladder.add(ElementType::OutputCoil, "Y0", 300, 0);
+    ladder.wire(left, 0, x0, 0);
+    ladder.wire(left, 1, x1, 0);
+    ladder.wire(left, 2, x2, 0);
+    ladder.wire(x0, 1, t1, 0);
+    ladder.wire(x1, 1, t1, 0);
+    ladder.wire(x2, 1, x3, 0);
+    ladder.wire(x3, 1, t1, 2);
+    ladder.wire(t1, 1, y0, 0);
+    ladder.wire(y0, 1, right, 0);
+
+    STCodeGenerator generator;
+    generator.addNetwork(ladder.network(1));
+    const QString code = generator.generateSTCode();
+    QVERIFY2(code.contains("T1(IN := (X0 OR X1) AND NOT (X2 AND X3), PT := T#500ms);"), qPrintable(code));
+    QVERIFY(code.contains("Y0 := T1.Q;"));
+}
+
+void TestSTCodeGenerator::forwardJumpSkipsNetworks() {
+    LadderBuilder jump;
+    {
+        const QString left = jump.add(ElementType::LeftPowerRail, "L", 0, 0);
+        const QString x0 = jump.add(ElementType::NormallyOpen, "X0", 60, 0);
+        const QString jmp = jump.add(ElementType::Jump, "JMP", 120, 0, {{"target_label", "SKIP"}});
+        jump.wire(left, 0, x0, 0);
+        jump.wire(x0, 1, jmp, 0);
+    }
+
+    LadderBuilder skipped;
+    {
+        const QString left = skipped.add(ElementType::LeftPowerRail, "L", 0, 0);
+        const QString right = skipped.add(ElementType::RightPowerRail, "R", 400, 0);
+        const QString x1 = skipped.add(ElementType::NormallyOpen, "X1", 60, 0);
+        const QString y1 = skipped.add(ElementType::OutputCoil, "Y1", 300, 0);
+        skipped.rung(left, right, 0, {x1}, y1);
+    }
+
+    LadderBuilder target;
+    {
+        target.add(ElementType::Label, "SKIP", 0, 0);
+        const QString left = target.add(ElementType::LeftPowerRail, "L", 0, 0);
+        const QString right = target.add(ElementType::RightPowerRail, "R", 400, 0);
+        const QString x2 = target.add(ElementType::NormallyOpen, "X2", 60, 0);
+        const QString y2 = target.add(ElementType::OutputCoil, "Y2", 300, 0);
+        target.rung(left, right, 0, {x2}, y2);
+    }
+
+    STCodeGenerator generator;
+    generator.addNetwork(jump.network(1));
+    generator.addNetwork(skipped.network(2));
+    generator.addNetwork(target.network(3));
+    const QString code = generator.generateSTCode();
+
+    // 跳转条件成立时跳过网络2，标签所在的网络3照常执行
+    const qsizetype open = code.indexOf("IF NOT (X0) THEN");
+    const qsizetype skippedStatement = code.indexOf("Y1 := X1;");
+    const qsizetype close = code.indexOf("END_IF;");
+    const qsizetype targetStatement = code.indexOf("Y2 := X2;");
+    QVERIFY2(open >= 0, qPrintable(code));
+    QVERIFY(open < skippedStatement);
+    QVERIFY(skippedStatement < close);
+    QVERIFY(close < targetStatement);
+    QVERIFY(code.contains("(* LABEL SKIP: *)"));
+    QVERIFY(!generator.hasErrors());
+}
+
+void TestSTCodeGenerator::backwardJumpIsReported() {
+    LadderBuilder target;
+    {
+        target.add(ElementType::Label, "AGAIN", 0, 0);
+        const QString left = target.add(ElementType::LeftPowerRail, "L", 0, 0);
+        const QString right = target.add(ElementType::RightPowerRail, "R", 400, 0);
+        const QString x1 = target.add(ElementType::NormallyOpen, "X1", 60, 0);
+        const QString y1 = target.add(ElementType::OutputCoil, "Y1", 300, 0);
+        target.rung(left, right, 0, {x1}, y1);
+    }
+
+    LadderBuilder jump;
+    {
+        const QString left = jump.add(ElementType::LeftPowerRail, "L", 0, 0);
+        const QString x0 = jump.add(ElementType::NormallyOpen, "X0", 60, 0);
+        const QString jmp = jump.add(ElementType::Jump, "JMP", 120, 0, {{"target_label", "AGAIN"}});
+        jump.wire(left, 0, x0, 0);
+        jump.wire(x0, 1, jmp, 0);
+    }
+
+    STCodeGenerator generator;
+    generator.addNetwork(target.network(1));
+    generator.addNetwork(jump.network(2));
+    const QString code = generator.generateSTCode();
+    QVERIFY(code.contains("(* JMP AGAIN: backward or overlapping jumps cannot be expressed in ST *)"));
+    QVERIFY(!code.contains("IF NOT (X0) THEN"));
+    QCOMPARE(generator.errors().size(), 1);
+    QVERIFY(generator.errors().first().contains("AGAIN"));
+
+    // 有错误时不写出文件
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("out.st");
+    QVERIFY(!generator.saveToFile(path));
+    QVERIFY(!QFile::exists(path));
+}
+
+void TestSTCodeGenerator::threadLimitKeepsOutput() {
+    // 网络足够多时默认并行编译，限制为单线程后结果必须逐字节相同
+    STCodeGenerator parallel;
+    STCodeGenerator serial;
+    serial.setMaxThreadCount(1);
+    for (int i = 0; i < 200; ++i) {
+        LadderBuilder ladder;
+        const QString left = ladder.add(ElementType::LeftPowerRail, "L", 0, 0);
+        const QString right = ladder.add(ElementType::RightPowerRail, "R", 400, 0);
+        const QString x0 = ladder.add(ElementType::NormallyOpen, QString("X%1").arg(i), 60, 0);
+        const QString x1 = ladder.add(ElementType::NormallyClosed, QString("M%1").arg(i), 120, 0);
+        const QString y0 = ladder.add(ElementType::OutputCoil, QString("Y%1").arg(i), 300, 0);
+        ladder.rung(left, right, 0, {x0, x1}, y0);
+        parallel.addNetwork(ladder.network(i + 1, i + 1));
+        serial.addNetwork(ladder.network(i + 1, i + 1));
+    }
+
+    const QString expected = serial.generateSTCode();
+    QCOMPARE(serial.lastRecompiledCount(), 200);
+    QCOMPARE(parallel.generateSTCode(), expected);
+    QVERIFY(expected.contains("Y199 := X199 AND NOT M199;"));
+}
+
+void TestSTCodeGenerator::loadErrorIsReported() {
+    STCodeGenerator generator;
+    QString error;
+    QVERIFY(!generator.loadFromJson("{\"elements\": [", &error));
+    QVERIFY(!error.isEmpty());
+
+    error.clear();
+    QVERIFY(!generator.loadFromJsonFile("/nonexistent/project.ldjson", &error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestSTCodeGenerator)
+#include "tst_stcodegenerator.moc"
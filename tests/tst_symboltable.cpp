@@ -0,0 +1,174 @@
+#include <QtTest/QtTest>
+#include "codegen/SymbolTable.h"
+
+using namespace LadderDiagram;
+
+Q_DECLARE_METATYPE(SymbolTable::Section)
+
+class TestSymbolTable : public QObject {
+    Q_OBJECT
+
+private slots:
+    void declarationsAreGroupedAndSorted();
+    void emptyTable();
+    void redeclarationKeepsFirstTypeExceptReal();
+    void firstAddressWins();
+    void functionBlocksStayLocal();
+    void writtenInputsAreLocal();
+    void sectionForAddress_data();
+    void sectionForAddress();
+};
+
+void TestSymbolTable::declarationsAreGroupedAndSorted() {
+    SymbolTable table;
+    table.setAddress(table.declare("X10", "BOOL"), "X10");
+    table.declare("TEMP", "INT");
+    table.setAddress(table.declare("Y0", "BOOL"), "Y0");
+    table.setAddress(table.declare("T1", "TON"), "X9");
+    table.setAddress(table.declare("START", "BOOL"), "%I0.1");
+    table.declare("FLAG", "BOOL");
+    table.setAddress(table.declare("MOTOR", "BOOL"), "Q0.0");
+    table.declare("C1", "CTU");
+    table.setAddress(table.declare("M5", "BOOL"), "M5");
+    table.setAddress(table.declare("X2", "BOOL"), "X2");
+    table.declare("TEMP", "REAL");
+
+    const QString expected =
+        "VAR_INPUT\n"
+        "    START : BOOL; (* %I0.1 *)\n"
+        "    X2 : BOOL;\n"
+        "    X10 : BOOL;\n"
+        "END_VAR\n"
+        "\n"
+        "VAR_OUTPUT\n"
+        "    MOTOR : BOOL; (* Q0.0 *)\n"
+        "    Y0 : BOOL;\n"
+        "END_VAR\n"
+        "\n"
+        "VAR\n"
+        "    (* Variables *)\n"
+        "    M5 : BOOL;\n"
+        "    FLAG : BOOL;\n"
+        "    TEMP : REAL;\n"
+        "\n"
+        "    (* Function Block Instances *)\n"
+        "    C1 : CTU;\n"
+        "    T1 : TON; (* X9 *)\n"
+        "END_VAR\n";
+    QCOMPARE(table.declarations(), expected);
+}
+
+void TestSymbolTable::emptyTable() {
+    SymbolTable table;
+    QCOMPARE(table.count(), 0);
+    QCOMPARE(table.find(u"X0"), -1);
+    QCOMPARE(table.declarations(), QString("VAR\nEND_VAR\n"));
+}
+
+void TestSymbolTable::redeclarationKeepsFirstTypeExceptReal() {
+    SymbolTable table;
+    const int value = table.declare("VALUE", "INT");
+    QCOMPARE(table.declare("VALUE", "REAL"), value);
+    QCOMPARE(table.symbol(value).type, QString("REAL"));
+    table.declare("VALUE", "INT");
+    QCOMPARE(table.symbol(value).type, QString("REAL"));
+
+    const int flag = table.declare("FLAG", "BOOL");
+    table.declare("FLAG", "INT");
+    QCOMPARE(table.symbol(flag).type, QString("BOOL"));
+
+    QCOMPARE(table.count(), 2);
+    QCOMPARE(table.find(u"VALUE"), value);
+    QCOMPARE(table.name(flag), QString("FLAG"));
+}
+
+void TestSymbolTable::firstAddressWins() {
+    SymbolTable table;
+    const int symbol = table.declare("PUMP", "BOOL");
+    table.setAddress(symbol, QString());
+    QVERIFY(table.symbol(symbol).address.isEmpty());
+    QCOMPARE(table.symbol(symbol).section, SymbolTable::Section::Local);
+
+    table.setAddress(symbol, "Y3");
+    table.setAddress(symbol, "X3");
+    QCOMPARE(table.symbol(symbol).address, QString("Y3"));
+    QCOMPARE(table.symbol(symbol).section, SymbolTable::Section::Output);
+
+    // 无效编号被忽略
+    table.setAddress(-1, "X0");
+    QCOMPARE(table.count(), 1);
+}
+
+void TestSymbolTable::functionBlocksStayLocal() {
+    SymbolTable table;
+    const int timer = table.declare("T1", "TON");
+    table.setAddress(timer, "%Q0.0");
+    QCOMPARE(table.symbol(timer).section, SymbolTable::Section::Local);
+    QVERIFY(SymbolTable::isFunctionBlockType("TON"));
+    QVERIFY(!SymbolTable::isFunctionBlockType("REAL"));
+}
+
+void TestSymbolTable::writtenInputsAreLocal() {
+    SymbolTable table;
+    // 先有地址后被赋值
+    const int start = table.declare("START", "BOOL");
+    table.setAddress(start, "X0");
+    QCOMPARE(table.symbol(start).section, SymbolTable::Section::Input);
+    table.markWritten(start);
+    QCOMPARE(table.symbol(start).section, SymbolTable::Section::Local);
+
+    // 先被赋值后有地址
+    const int latch = table.declare("LATCH", "BOOL");
+    table.markWritten(latch);
+    table.setAddress(latch, "%I0.2");
+    QCOMPARE(table.symbol(latch).section, SymbolTable::Section::Local);
+
+    // 只读的输入与被赋值的输出不受影响
+    table.setAddress(table.declare("STOP", "BOOL"), "X1");
+    const int motor = table.declare("MOTOR", "BOOL");
+    table.setAddress(motor, "Y0");
+    table.markWritten(motor);
+    QCOMPARE(table.symbol(motor).section, SymbolTable::Section::Output);
+
+    table.markWritten(-1);
+
+    const QString expected =
+        "VAR_INPUT\n"
+        "    STOP : BOOL; (* X1 *)\n"
+        "END_VAR\n"
+        "\n"
+        "VAR_OUTPUT\n"
+        "    MOTOR : BOOL; (* Y0 *)\n"
+        "END_VAR\n"
+        "\n"
+        "VAR\n"
+        "    (* Variables *)\n"
+        "    LATCH : BOOL; (* %I0.2 *)\n"
+        "    START : BOOL; (* X0 *)\n"
+        "END_VAR\n";
+    QCOMPARE(table.declarations(), expected);
+}
+
+void TestSymbolTable::sectionForAddress_data() {
+    QTest::addColumn<QString>("address");
+    QTest::addColumn<SymbolTable::Section>("section");
+    QTest::newRow("X") << QString("X0") << SymbolTable::Section::Input;
+    QTest::newRow("%IX") << QString("%IX0.0") << SymbolTable::Section::Input;
+    QTest::newRow("lower i") << QString("i1") << SymbolTable::Section::Input;
+    QTest::newRow("padded") << QString("  X1 ") << SymbolTable::Section::Input;
+    QTest::newRow("Y") << QString("y3") << SymbolTable::Section::Output;
+    QTest::newRow("%QW") << QString("%QW2") << SymbolTable::Section::Output;
+    QTest::newRow("M") << QString("M0") << SymbolTable::Section::Local;
+    QTest::newRow("%MW") << QString("%MW10") << SymbolTable::Section::Local;
+    QTest::newRow("percent only") << QString("%") << SymbolTable::Section::Local;
+    QTest::newRow("empty") << QString("") << SymbolTable::Section::Local;
+}
+
+void TestSymbolTable::sectionForAddress() {
+    QFETCH(QString, address);
+    QFETCH(SymbolTable::Section, section);
+    QCOMPARE(SymbolTable::sectionForAddress(address), section);
+}
+
+QTEST_GUILESS_MAIN(TestSymbolTable)
+#include "tst_symboltable.moc"
@@ -0,0 +1,274 @@
+#include <QtTest/QtTest>
+#include "ui/UndoHistory.h"
+
+using namespace LadderDiagram;
+
+class TestUndoHistory : public QObject {
+    Q_OBJECT
+
+private slots:
+    void pushUndoRedo();
+    void trimmingKeepsBudget();
+    void indexStaysAbsoluteAfterTrimming();
+    void latestCommandIsAlwaysKept();
+    void trimmingKeepsRedoTail();
+    void cleanStateIsLostWhenTrimmed();
+    void pushDropsRedoTail();
+    void mergeStopsAtCleanState();
+    void mergeStopsAtClosedChain();
+};
+
+namespace {
+
+// 给 *value 加 delta 的命令，字节数固定以便核对预算
+class AddCommand : public EditCommand {
+public:
+    AddCommand(int* value, int delta, qsizetype bytes, int mergeId = -1)
+        : EditCommand(QString("add %1").arg(delta))
+        , m_value(value)
+        , m_delta(delta)
+        , m_bytes(bytes)
+        , m_mergeId(mergeId) {}
+
+    void redo() override { *m_value += m_delta; }
+    void undo() override { *m_value -= m_delta; }
+    int id() const override { return m_mergeId; }
+    qsizetype byteSize() const override { return m_bytes; }
+
+    bool mergeWith(const QUndoCommand* other) override {
+        m_delta += static_cast<const AddCommand*>(other)->m_delta;
+        setObsolete(m_delta == 0);
+        return true;
+    }
+
+private:
+    int* m_value;
+    int m_delta;
+    qsizetype m_bytes;
+    int m_mergeId;
+};
+
+} // namespace
+
+void TestUndoHistory::pushUndoRedo() {
+    int value = 0;
+    UndoHistory history;
+    QSignalSpy indexSpy(&history, &UndoHistory::indexChanged);
+
+    history.push(new AddCommand(&value, 1, 100));
+    history.push(new AddCommand(&value, 2, 100));
+    QCOMPARE(value, 3);
+    QCOMPARE(history.index(), 2);
+    QCOMPARE(history.undoText(), QString("add 2"));
+    QCOMPARE(indexSpy.count(), 2);
+
+    history.undo();
+    QCOMPARE(value, 1);
+    QVERIFY(history.canRedo());
+    QCOMPARE(history.redoText(), QString("add 2"));
+
+    history.redo();
+    QCOMPARE(value, 3);
+    QCOMPARE(history.index(), 2);
+    QVERIFY(!history.canRedo());
+    QCOMPARE(indexSpy.count(), 4);
+}
+
+void TestUndoHistory::trimmingKeepsBudget() {
+    int value = 0;
+    UndoHistory history;
+    history.setByteBudget(350);
+
+    for (int i = 0; i < 10; ++i) {
+        history.push(new AddCommand(&value, 1, 100));
+        QVERIFY(history.byteSize() <= history.byteBudget());
+    }
+    QCOMPARE(history.byteSize(), qsizetype(300));
+}
+
+void TestUndoHistory::indexStaysAbsoluteAfterTrimming() {
+    int value = 0;
+    UndoHistory history;
+    history.setByteBudget(350);
+    for (int i = 0; i < 10; ++i) {
+        history.push(new AddCommand(&value, 1, 100));
+    }
+
+    // 只剩最近三条，但位置仍按全部历史计
+    QCOMPARE(history.index(), 10);
+    QCOMPARE(history.count(), 10);
+    QCOMPARE(value, 10);
+
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(history.canUndo());
+        history.undo();
+    }
+    QCOMPARE(history.index(), 7);
+    QCOMPARE(value, 7);
+    QVERIFY(!history.canUndo());
+
+    // 已丢弃部分之前的位置无法再撤销
+    history.undo();
+    QCOMPARE(history.index(), 7);
+    QCOMPARE(value, 7);
+
+    history.redo();
+    QCOMPARE(history.index(), 8);
+    QCOMPARE(history.count(), 10);
+    QCOMPARE(value, 8);
+}
+
+void TestUndoHistory::latestCommandIsAlwaysKept() {
+    int value = 0;
+    UndoHistory history;
+    history.setByteBudget(50);
+
+    history.push(new AddCommand(&value, 1, 100));
+    history.push(new AddCommand(&value, 1, 100));
+    QCOMPARE(history.index(), 2);
+    QCOMPARE(history.byteSize(), qsizetype(100));
+    QVERIFY(history.canUndo());
+
+    history.undo();
+    QCOMPARE(value, 1);
+    QVERIFY(!history.canUndo());
+}
+
+void TestUndoHistory::trimmingKeepsRedoTail() {
+    int value = 0;
+    UndoHistory history;
+    history.setByteBudget(0);
+    for (int i = 0; i < 5; ++i) {
+        history.push(new AddCommand(&value, 1, 100));
+    }
+    history.undo();
+    history.undo();
+    QCOMPARE(history.index(), 3);
+
+    // 降低预算只丢弃已执行的早期命令，可重做的部分保留
+    history.setByteBudget(250);
+    QCOMPARE(history.index(), 3);
+    QCOMPARE(history.count(), 5);
+    QVERIFY(history.canRedo());
+    history.undo();
+    QVERIFY(!history.canUndo());
+    QCOMPARE(value, 2);
+
+    history.redo();
+    history.redo();
+    history.redo();
+    QCOMPARE(history.index(), 5);
+    QCOMPARE(value, 5);
+}
+
+void TestUndoHistory::cleanStateIsLostWhenTrimmed() {
+    int value = 0;
+    UndoHistory history;
+    history.setByteBudget(350);
+    QSignalSpy cleanSpy(&history, &UndoHistory::cleanChanged);
+
+    history.push(new AddCommand(&value, 1, 100));
+    history.push(new AddCommand(&value, 1, 100));
+    history.setClean();
+    QVERIFY(history.isClean());
+
+    history.push(new AddCommand(&value, 1, 100));
+    QVERIFY(!history.isClean());
+    history.undo();
+    QVERIFY(history.isClean());
+    history.redo();
+
+    // 保存位置之后的命令把它挤出预算
+    for (int i = 0; i < 3; ++i) {
+        history.push(new AddCommand(&value, 1, 100));
+    }
+    while (history.canUndo()) {
+        QVERIFY(!history.isClean());
+        history.undo();
+    }
+    QVERIFY(!history.isClean());
+    QCOMPARE(history.index(), 3);
+    QCOMPARE(cleanSpy.count(), 5);
+}
+
+void TestUndoHistory::pushDropsRedoTail() {
+    int value = 0;
+    UndoHistory history;
+    for (int i = 0; i < 4; ++i) {
+        history.push(new AddCommand(&value, 1, 100));
+    }
+    history.undo();
+    history.undo();
+    history.setClean();
+    history.redo();
+    QCOMPARE(history.byteSize(), qsizetype(400));
+
+    history.undo();
+    history.undo();
+    history.push(new AddCommand(&value, 10, 100));
+    QCOMPARE(value, 11);
+    QCOMPARE(history.index(), 2);
+    QCOMPARE(history.count(), 2);
+    QCOMPARE(history.byteSize(), qsizetype(200));
+    QVERIFY(!history.canRedo());
+
+    // 干净位置在被删除的重做部分中
+    history.undo();
+    QVERIFY(!history.isClean());
+    history.undo();
+    QVERIFY(!history.isClean());
+}
+
+void TestUndoHistory::mergeStopsAtCleanState() {
+    int value = 0;
+    UndoHistory history;
+    history.push(new AddCommand(&value, 1, 100, 1));
+    history.push(new AddCommand(&value, 2, 100, 1));
+    history.push(new AddCommand(&value, 3, 100, 1));
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(value, 6);
+
+    history.setClean();
+    history.push(new AddCommand(&value, 4, 100, 1));
+    QCOMPARE(history.count(), 2);
+
+    // 合并后抵消的命令直接移除
+    history.push(new AddCommand(&value, -4, 100, 1));
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(value, 6);
+    QVERIFY(history.isClean());
+
+    history.undo();
+    QCOMPARE(value, 0);
+}
+
+void TestUndoHistory::mergeStopsAtClosedChain() {
+    int value = 0;
+    UndoHistory history;
+    history.push(new AddCommand(&value, 1, 100, 1));
+    history.push(new AddCommand(&value, 1, 100, 1));
+    QCOMPARE(history.count(), 1);
+
+    // 一次输入结束后另起一步
+    history.closeMergeChain();
+    history.push(new AddCommand(&value, 1, 100, 1));
+    history.push(new AddCommand(&value, 1, 100, 1));
+    QCOMPARE(history.count(), 2);
+    QCOMPARE(value, 4);
+
+    // 撤销后的新修改不并入更早的命令
+    history.undo();
+    QCOMPARE(value, 2);
+    history.push(new AddCommand(&value, 5, 100, 1));
+    QCOMPARE(history.count(), 2);
+    history.undo();
+    QCOMPARE(value, 2);
+
+    history.clear();
+    history.push(new AddCommand(&value, 1, 100, 1));
+    history.push(new AddCommand(&value, 1, 100, 1));
+    QCOMPARE(history.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestUndoHistory)
+#include "tst_undohistory.moc"